@@ -0,0 +1,110 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_connect.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <fmt/format.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <string_view>
+
+// Measures how fast a server accepts a storm of connections, accepting either one connection per reactor wakeup with
+// async_accept or all the pending ones with async_accept_batch. A child process keeps the specified amount of
+// connection attempts in flight until it has made the specified amount of connections, and resets every connection
+// right after it's established, so neither side accumulates sockets in TIME_WAIT. The server closes the accepted
+// sockets right away as well, and reports the accept rate and the average amount of connections accepted per wakeup.
+
+namespace {
+/// Connects to the server the specified amount of times, with the specified amount of connections in flight.
+[[noreturn]] void run_client(const boost::asio::ip::tcp::endpoint &endpoint, std::size_t connections_count,
+                             std::size_t concurrency) {
+  boost::asio::io_context context;
+  std::size_t started = 0;
+  for (std::size_t i = 0; i != concurrency; ++i) {
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      while (started != connections_count) {
+        ++started;
+        boost::asio::ip::tcp::socket socket(context);
+        if (const auto error = co_await asio_coro::async_connect(socket, endpoint)) {
+          fmt::print(stderr, "failed to connect: {}\n", error.message());
+          co_return;
+        }
+
+        socket.set_option(boost::asio::socket_base::linger(true, 0));
+      }
+    });
+  }
+
+  context.run();
+  std::_Exit(0);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fmt::print(stderr, "usage: {} single|batch [connections=100000] [concurrency=1000] [batch_size=256]\n", argv[0]);
+    return 1;
+  }
+
+  const std::string_view mode = argv[1];
+  const auto connections_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000ul;
+  const auto concurrency = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 1000ul;
+  const auto batch_size = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 256ul;
+  if (mode != "single" && mode != "batch") {
+    fmt::print(stderr, "unknown mode {}\n", mode);
+    return 1;
+  }
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  const auto endpoint = acceptor.local_endpoint();
+
+  const auto child = fork();
+  if (child == 0) {
+    acceptor.close();
+    run_client(endpoint, connections_count, concurrency);
+  }
+
+  std::size_t accepted = 0;
+  std::size_t wakeups = 0;
+  std::chrono::steady_clock::time_point started_at;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    while (accepted != connections_count) {
+      boost::system::error_code error;
+      if (mode == "single") {
+        boost::asio::ip::tcp::socket socket(context);
+        error = co_await asio_coro::async_accept(acceptor, socket);
+        accepted += error ? 0 : 1;
+      } else {
+        auto [batch_error, sockets] = co_await asio_coro::async_accept_batch(acceptor, batch_size);
+        error = batch_error;
+        accepted += sockets.size();
+      }
+
+      if (error) {
+        fmt::print(stderr, "failed to accept a connection: {}\n", error.message());
+        co_return;
+      }
+
+      if (wakeups++ == 0) {
+        started_at = std::chrono::steady_clock::now();
+      }
+    }
+  });
+
+  context.run();
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+  waitpid(child, nullptr, 0);
+
+  fmt::print("{{\"mode\": \"{}\", \"connections\": {}, \"concurrency\": {}, \"seconds\": {:.3f}, "
+             "\"accepts_per_second\": {:.0f}, \"accepts_per_wakeup\": {:.2f}}}\n",
+             mode, accepted, concurrency, seconds, accepted / seconds, static_cast<double>(accepted) / wakeups);
+
+  return accepted == connections_count ? 0 : 1;
+}
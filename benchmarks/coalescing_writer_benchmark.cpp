@@ -0,0 +1,145 @@
+#include "asio_coro/async_mutex.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/coalescing_writer.hpp"
+#include "asio_coro/post.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Compares writing small messages published by many coroutines to the same socket with an async_write per message
+// serialized by an async_mutex, and with a coalescing_writer. Every publisher writes one message per reactor turn, so
+// the amount of publishers is the amount of messages per tick. Write calls are counted by a socket wrapper, and the
+// messages are drained by a reader coroutine over a loopback TCP connection.
+
+namespace {
+/// A socket wrapper that counts write_some calls, each of which is one write/writev system call.
+class counting_socket {
+public:
+  using executor_type = boost::asio::ip::tcp::socket::executor_type;
+
+  explicit counting_socket(boost::asio::ip::tcp::socket &socket) : _socket(socket) {}
+
+  executor_type get_executor() { return _socket.get_executor(); }
+
+  template <class ConstBufferSequence, class Handler>
+  auto async_write_some(const ConstBufferSequence &buffers, Handler &&handler) {
+    ++_writes;
+    return _socket.async_write_some(buffers, std::forward<Handler>(handler));
+  }
+
+  std::size_t writes() const noexcept { return _writes; }
+
+private:
+  boost::asio::ip::tcp::socket &_socket;
+  std::size_t _writes = 0;
+};
+
+void spawn_direct_publishers(boost::asio::strand<boost::asio::io_context::executor_type> &strand,
+                             counting_socket &socket, asio_coro::async_mutex &mutex, std::size_t publishers,
+                             std::size_t ticks, const std::string &message) {
+  for (std::size_t i = 0; i != publishers; ++i) {
+    asio_coro::spawn_coroutine(strand, [&, ticks]() -> asio_coro::task<void> {
+      for (std::size_t tick = 0; tick != ticks; ++tick) {
+        {
+          const auto lock = co_await mutex.async_lock_scoped();
+          co_await asio_coro::async_write(socket, boost::asio::buffer(message), boost::asio::transfer_all());
+        }
+
+        co_await asio_coro::post(strand);
+      }
+    });
+  }
+}
+
+void spawn_coalescing_publishers(boost::asio::strand<boost::asio::io_context::executor_type> &strand,
+                                 asio_coro::coalescing_writer<counting_socket> &writer, std::size_t publishers,
+                                 std::size_t ticks, const std::string &message) {
+  for (std::size_t i = 0; i != publishers; ++i) {
+    asio_coro::spawn_coroutine(strand, [&, ticks]() -> asio_coro::task<void> {
+      for (std::size_t tick = 0; tick != ticks; ++tick) {
+        co_await writer.async_write(message);
+        co_await asio_coro::post(strand);
+      }
+    });
+  }
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fmt::print(stderr, "usage: {} direct|coalescing [messages_per_tick=100] [messages=100000] [message_size=32]\n",
+               argv[0]);
+    return 1;
+  }
+
+  const std::string_view mode = argv[1];
+  const auto publishers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100ul;
+  const auto messages_count = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 100000ul;
+  const auto message_size = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 32ul;
+  if (mode != "direct" && mode != "coalescing") {
+    fmt::print(stderr, "unknown mode {}\n", mode);
+    return 1;
+  }
+
+  const auto ticks = std::max(1ul, messages_count / publishers);
+  const auto total_size = ticks * publishers * message_size;
+  const std::string message(message_size, 'm');
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  client.connect(acceptor.local_endpoint());
+  acceptor.accept(server);
+  server.set_option(boost::asio::ip::tcp::no_delay(true));
+
+  counting_socket socket(server);
+  asio_coro::async_mutex mutex;
+  asio_coro::coalescing_writer<counting_socket> writer(socket, 1024 * 1024);
+  auto strand = boost::asio::make_strand(context);
+
+  if (mode == "direct") {
+    spawn_direct_publishers(strand, socket, mutex, publishers, ticks, message);
+  } else {
+    spawn_coalescing_publishers(strand, writer, publishers, ticks, message);
+  }
+
+  std::chrono::steady_clock::time_point finished_at;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    std::vector<char> buffer(256 * 1024);
+    for (auto remaining_size = total_size; remaining_size != 0;) {
+      const auto [error, size] = co_await asio_coro::async_read(client, boost::asio::buffer(buffer));
+      if (error) {
+        fmt::print(stderr, "failed to read messages: {}\n", error.message());
+        co_return;
+      }
+
+      remaining_size -= size;
+    }
+
+    finished_at = std::chrono::steady_clock::now();
+  });
+
+  const auto started_at = std::chrono::steady_clock::now();
+  context.run();
+
+  const auto messages = ticks * publishers;
+  const auto seconds = std::chrono::duration<double>(finished_at - started_at).count();
+  fmt::print("{{\"mode\": \"{}\", \"messages_per_tick\": {}, \"messages\": {}, \"message_size\": {}, "
+             "\"write_calls\": {}, \"write_calls_per_message\": {:.4f}, \"messages_per_second\": {:.0f}}}\n",
+             mode, publishers, messages, message_size, socket.writes(),
+             static_cast<double>(socket.writes()) / static_cast<double>(messages), messages / seconds);
+
+  return 0;
+}
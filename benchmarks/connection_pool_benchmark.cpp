@@ -0,0 +1,176 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_connect.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/connection_pool.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <fmt/format.h>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Measures the latency of small request/response exchanges made either over a new connection per request, as
+// async_connect does, or over connections leased from a connection_pool. A child process runs a server that answers
+// every 64-byte request with the same bytes. The client keeps the specified amount of requests in flight, and reports
+// the request rate and the latency percentiles. Connections made per request are reset on close, so the client doesn't
+// run out of ports because of sockets in TIME_WAIT.
+
+namespace {
+constexpr std::size_t request_size = 64;
+
+/// Answers the requests of every accepted connection until the process is killed.
+[[noreturn]] void run_server(int fd) {
+  // The acceptor is inherited from the parent process, so it's assigned to an io_context of the child.
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, boost::asio::ip::tcp::v4(), ::dup(fd));
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    while (true) {
+      auto socket = std::make_shared<boost::asio::ip::tcp::socket>(context);
+      if (co_await asio_coro::async_accept(acceptor, *socket)) {
+        continue;
+      }
+
+      socket->set_option(boost::asio::ip::tcp::no_delay(true));
+      asio_coro::spawn_coroutine(context, [socket]() -> asio_coro::task<void> {
+        std::array<char, request_size> request{};
+        while (true) {
+          const auto [read_error, read_size] =
+              co_await asio_coro::async_read(*socket, boost::asio::buffer(request), boost::asio::transfer_all());
+          if (read_error) {
+            co_return;
+          }
+
+          const auto [write_error, write_size] = co_await asio_coro::async_write(*socket, boost::asio::buffer(request));
+          if (write_error) {
+            co_return;
+          }
+        }
+      });
+    }
+  });
+
+  context.run();
+  std::_Exit(0);
+}
+
+/// Sends a request over the socket and reads the response.
+asio_coro::task<boost::system::error_code> exchange(boost::asio::ip::tcp::socket &socket) {
+  std::array<char, request_size> buffer{};
+  if (const auto [error, size] = co_await asio_coro::async_write(socket, boost::asio::buffer(buffer)); error) {
+    co_return error;
+  }
+
+  const auto [error, size] =
+      co_await asio_coro::async_read(socket, boost::asio::buffer(buffer), boost::asio::transfer_all());
+  co_return error;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fmt::print(stderr, "usage: {} connect|pool [requests=50000] [concurrency=16]\n", argv[0]);
+    return 1;
+  }
+
+  const std::string_view mode = argv[1];
+  const auto requests_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 50000ul;
+  const auto concurrency = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 16ul;
+  if (mode != "connect" && mode != "pool") {
+    fmt::print(stderr, "unknown mode {}\n", mode);
+    return 1;
+  }
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  acceptor.listen(1024);
+  const auto endpoint = acceptor.local_endpoint();
+
+  const auto child = fork();
+  if (child == 0) {
+    run_server(acceptor.native_handle());
+  }
+
+  acceptor.close();
+  asio_coro::connection_pool<> pool(context.get_executor(), concurrency, concurrency);
+  std::vector<double> latencies;
+  latencies.reserve(requests_count);
+  std::size_t started = 0;
+  std::size_t failed = 0;
+  std::size_t running = concurrency;
+
+  const auto started_at = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i != concurrency; ++i) {
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      while (started != requests_count) {
+        ++started;
+        const auto request_started_at = std::chrono::steady_clock::now();
+        boost::system::error_code error;
+        if (mode == "pool") {
+          auto [acquire_error, lease] = co_await pool.acquire(endpoint);
+          error = acquire_error;
+          if (!error) {
+            if (!lease.reused()) {
+              lease->set_option(boost::asio::ip::tcp::no_delay(true));
+            }
+
+            error = co_await exchange(lease.socket());
+            if (error) {
+              lease.discard();
+            }
+          }
+        } else {
+          boost::asio::ip::tcp::socket socket(context);
+          error = co_await asio_coro::async_connect(socket, endpoint);
+          if (!error) {
+            socket.set_option(boost::asio::ip::tcp::no_delay(true));
+            error = co_await exchange(socket);
+            socket.set_option(boost::asio::socket_base::linger(true, 0));
+          }
+        }
+
+        if (error) {
+          ++failed;
+          continue;
+        }
+
+        latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() -
+                                                                      request_started_at)
+                                .count());
+      }
+
+      if (--running == 0) {
+        pool.close();
+      }
+    });
+  }
+
+  context.run();
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+  kill(child, SIGKILL);
+  waitpid(child, nullptr, 0);
+
+  std::sort(latencies.begin(), latencies.end());
+  const auto percentile = [&](double fraction) {
+    return latencies.empty() ? 0.0 : latencies[static_cast<std::size_t>(fraction * (latencies.size() - 1))];
+  };
+
+  fmt::print("{{\"mode\": \"{}\", \"requests\": {}, \"failed\": {}, \"concurrency\": {}, \"seconds\": {:.3f}, "
+             "\"requests_per_second\": {:.0f}, \"p50_us\": {:.1f}, \"p99_us\": {:.1f}, \"p999_us\": {:.1f}}}\n",
+             mode, latencies.size(), failed, concurrency, seconds, latencies.size() / seconds, percentile(0.5),
+             percentile(0.99), percentile(0.999));
+
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/file.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+
+#include <fmt/format.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Measures the throughput of 4 KiB reads from a file, either sequential or at random offsets, made by blocking pread
+// calls and by random_access_file backed by the thread pool and by io_uring. The queue depth is the amount of
+// coroutines reading concurrently, each coroutine reads its own part of the file in the sequential pattern.
+
+namespace {
+constexpr std::size_t block_size = 4096;
+
+/// Creates the file of the specified size filled with data and returns its descriptor.
+int create_file(const char *path, std::size_t size) {
+  const auto fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd == -1) {
+    fmt::print(stderr, "failed to create {}\n", path);
+    std::exit(1);
+  }
+
+  const std::string block(1 << 20, 'f');
+  for (std::size_t written = 0; written < size; written += block.size()) {
+    if (::write(fd, block.data(), block.size()) != static_cast<ssize_t>(block.size())) {
+      fmt::print(stderr, "failed to fill {}\n", path);
+      std::exit(1);
+    }
+  }
+
+  ::fsync(fd);
+  return fd;
+}
+
+/// Returns the offset of the specified block read by the specified reader.
+std::uint64_t block_offset(bool random, std::mt19937_64 &generator, std::size_t reader, std::size_t readers,
+                           std::size_t block, std::size_t blocks_count) {
+  if (random) {
+    return generator() % blocks_count * block_size;
+  }
+
+  const auto blocks_per_reader = blocks_count / readers;
+  return (reader * blocks_per_reader + block % blocks_per_reader) * block_size;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 3) {
+    fmt::print(stderr,
+               "usage: {} blocking|pool|uring sequential|random [queue_depth=32] [reads=100000] [file_size_mb=256] "
+               "[path=./file_io_benchmark.dat]\n",
+               argv[0]);
+    return 1;
+  }
+
+  const std::string_view mode = argv[1];
+  const std::string_view pattern = argv[2];
+  const auto queue_depth = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 32ul;
+  const auto reads = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 100000ul;
+  const auto file_size = (argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 256ul) << 20;
+  const char *const path = argc > 6 ? argv[6] : "./file_io_benchmark.dat";
+  if (mode != "blocking" && mode != "pool" && mode != "uring") {
+    fmt::print(stderr, "unknown mode {}\n", mode);
+    return 1;
+  }
+
+  if (pattern != "sequential" && pattern != "random") {
+    fmt::print(stderr, "unknown pattern {}\n", pattern);
+    return 1;
+  }
+
+#if defined(ASIO_CORO_HAS_IO_URING)
+  if (mode == "uring" && !asio_coro::uring_context::is_supported()) {
+#else
+  if (mode == "uring") {
+#endif
+    fmt::print(stderr, "io_uring is not available\n");
+    return 1;
+  }
+
+  const auto fd = create_file(path, file_size);
+  const auto blocks_count = file_size / block_size;
+  const auto random = pattern == "random";
+
+  boost::asio::io_context context;
+#if defined(ASIO_CORO_HAS_IO_URING)
+  std::optional<asio_coro::uring_context> ring;
+  if (mode == "uring") {
+    ring.emplace(context, 1024);
+  }
+#endif
+
+  std::size_t failures = 0;
+  const auto started_at = std::chrono::steady_clock::now();
+  if (mode == "blocking") {
+    std::mt19937_64 generator;
+    std::vector<char> buffer(block_size);
+    for (std::size_t block = 0; block != reads; ++block) {
+      const auto offset = block_offset(random, generator, 0, 1, block, blocks_count);
+      if (::pread(fd, buffer.data(), block_size, static_cast<off_t>(offset)) != static_cast<ssize_t>(block_size)) {
+        ++failures;
+      }
+    }
+  } else {
+    for (std::size_t reader = 0; reader != queue_depth; ++reader) {
+      asio_coro::spawn_coroutine(context, [&, reader]() -> asio_coro::task<void> {
+#if defined(ASIO_CORO_HAS_IO_URING)
+        auto file = ring ? std::make_unique<asio_coro::random_access_file>(*ring)
+                         : std::make_unique<asio_coro::random_access_file>(context);
+#else
+        auto file = std::make_unique<asio_coro::random_access_file>(context);
+#endif
+        if (file->open(path)) {
+          ++failures;
+          co_return;
+        }
+
+        std::mt19937_64 generator(reader);
+        std::vector<char> buffer(block_size);
+        for (std::size_t block = reader; block < reads; block += queue_depth) {
+          const auto offset = block_offset(random, generator, reader, queue_depth, block / queue_depth, blocks_count);
+          const auto [error, size] = co_await asio_coro::async_read_at(*file, offset, boost::asio::buffer(buffer));
+          if (error || size != block_size) {
+            ++failures;
+          }
+        }
+      });
+    }
+
+    context.run();
+  }
+
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+  ::close(fd);
+  ::unlink(path);
+
+  fmt::print("{{\"mode\": \"{}\", \"pattern\": \"{}\", \"queue_depth\": {}, \"reads\": {}, \"block_size\": {}, "
+             "\"seconds\": {:.3f}, \"iops\": {:.0f}, \"megabytes_per_second\": {:.1f}, \"failures\": {}}}\n",
+             mode, pattern, mode == "blocking" ? 1 : queue_depth, reads, block_size, seconds, reads / seconds,
+             static_cast<double>(reads * block_size) / seconds / (1 << 20), failures);
+
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/buffer_pool.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <fmt/format.h>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Measures the user space memory consumed by idle connections whose coroutines await incoming data either with a read
+// buffer allocated per connection (what the tcp_server example used to do) or with async_read_pooled, which takes a
+// buffer from a shared pool only once the data is ready. The connections are opened by a child process over the
+// loopback interface and never send anything, so only the server process resident set size is measured.
+
+namespace {
+std::size_t resident_set_size() {
+  std::ifstream statm("/proc/self/statm");
+
+  std::size_t size = 0;
+  std::size_t resident = 0;
+  statm >> size >> resident;
+
+  return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+void raise_open_files_limit() {
+  rlimit limit{};
+  getrlimit(RLIMIT_NOFILE, &limit);
+  limit.rlim_cur = limit.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &limit);
+}
+
+/// Opens the specified amount of connections, reports that over the pipe, and holds them until the pipe is closed.
+[[noreturn]] void run_client(const boost::asio::ip::tcp::endpoint &endpoint, std::size_t connections_count,
+                             int ready_fd, int done_fd) {
+  boost::asio::io_context context;
+  std::vector<boost::asio::ip::tcp::socket> sockets;
+  sockets.reserve(connections_count);
+  for (std::size_t i = 0; i != connections_count; ++i) {
+    sockets.emplace_back(context).connect(endpoint);
+  }
+
+  char byte = 0;
+  (void)write(ready_fd, &byte, 1);
+  (void)read(done_fd, &byte, 1);
+
+  std::_Exit(0);
+}
+
+void spawn_pinned_connection(boost::asio::io_context &context, boost::asio::ip::tcp::socket socket,
+                             std::size_t buffer_size) {
+  asio_coro::spawn_coroutine(context, [socket = std::move(socket), buffer_size]() mutable -> asio_coro::task<void> {
+    const auto buffer = std::make_unique<char[]>(buffer_size);
+    while (true) {
+      const auto [error, size] = co_await asio_coro::async_read(socket, boost::asio::buffer(buffer.get(), buffer_size));
+      if (error) {
+        break;
+      }
+    }
+  });
+}
+
+void spawn_pooled_connection(boost::asio::io_context &context, boost::asio::ip::tcp::socket socket,
+                             asio_coro::buffer_pool &pool) {
+  asio_coro::spawn_coroutine(context, [socket = std::move(socket), &pool]() mutable -> asio_coro::task<void> {
+    while (true) {
+      const auto [error, buffer, size] = co_await asio_coro::async_read_pooled(socket, pool);
+      if (error) {
+        break;
+      }
+    }
+  });
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fmt::print(stderr, "usage: {} pinned|pooled [connections=10000] [buffer_size=4096]\n", argv[0]);
+    return 1;
+  }
+
+  const std::string_view mode = argv[1];
+  const auto connections_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10000ul;
+  const auto buffer_size = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4096ul;
+  if (mode != "pinned" && mode != "pooled") {
+    fmt::print(stderr, "unknown mode {}\n", mode);
+    return 1;
+  }
+
+  raise_open_files_limit();
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  asio_coro::buffer_pool pool(buffer_size);
+
+  int ready_pipe[2];
+  int done_pipe[2];
+  if (pipe(ready_pipe) != 0 || pipe(done_pipe) != 0) {
+    fmt::print(stderr, "failed to create pipes\n");
+    return 1;
+  }
+
+  const auto endpoint = acceptor.local_endpoint();
+  const auto child = fork();
+  if (child == 0) {
+    acceptor.close();
+    close(done_pipe[1]);
+    run_client(endpoint, connections_count, ready_pipe[1], done_pipe[0]);
+  }
+
+  const auto initial_rss = resident_set_size();
+
+  std::size_t accepted = 0;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    while (accepted != connections_count) {
+      boost::asio::ip::tcp::socket socket(context);
+      if (const auto error = co_await asio_coro::async_accept(acceptor, socket)) {
+        fmt::print(stderr, "failed to accept a connection: {}\n", error.message());
+        co_return;
+      }
+
+      ++accepted;
+      if (mode == "pinned") {
+        spawn_pinned_connection(context, std::move(socket), buffer_size);
+      } else {
+        spawn_pooled_connection(context, std::move(socket), pool);
+      }
+    }
+  });
+
+  while (accepted != connections_count && context.run_one() != 0) {
+  }
+
+  // Start all the connection coroutines, so every one of them awaits incoming data.
+  char byte = 0;
+  (void)read(ready_pipe[0], &byte, 1);
+  context.poll();
+
+  const auto idle_rss = resident_set_size();
+  fmt::print("{{\"mode\": \"{}\", \"connections\": {}, \"buffer_size\": {}, \"pooled_buffers\": {}, "
+             "\"rss_bytes\": {}, \"rss_bytes_per_connection\": {:.1f}}}\n",
+             mode, accepted, buffer_size, pool.size(), idle_rss - initial_rss,
+             static_cast<double>(idle_rss - initial_rss) / static_cast<double>(accepted));
+
+  // Close the client connections and let the coroutines finish.
+  close(done_pipe[1]);
+  waitpid(child, nullptr, 0);
+  context.run();
+
+  return 0;
+}
@@ -0,0 +1,213 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_connect.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/io_uring.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <fmt/format.h>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Compares an echo server built on the epoll reactor (async_read/async_write) with the same server built on a
+// uring_context, with a per-connection buffer and with buffers provided to the kernel. A child process opens the
+// connections over the loopback interface with the reactor-based awaitables, and every connection makes the same amount
+// of request/response round trips. The server process reports the throughput, and for io_uring the amount of
+// io_uring_enter calls per operation, which shows how many operations are batched into one submission.
+
+namespace {
+/// Opens the specified amount of connections, and makes the round trips over each one of them.
+[[noreturn]] void run_client(const boost::asio::ip::tcp::endpoint &endpoint, std::size_t connections_count,
+                             std::size_t round_trips, std::size_t message_size) {
+  boost::asio::io_context context;
+  for (std::size_t i = 0; i != connections_count; ++i) {
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      boost::asio::ip::tcp::socket socket(context);
+      if (const auto error = co_await asio_coro::async_connect(socket, endpoint)) {
+        fmt::print(stderr, "failed to connect: {}\n", error.message());
+        co_return;
+      }
+
+      socket.set_option(boost::asio::ip::tcp::no_delay(true));
+
+      const std::string request(message_size, 'r');
+      std::string response(message_size, '\0');
+      for (std::size_t trip = 0; trip != round_trips; ++trip) {
+        auto [error, size] =
+            co_await asio_coro::async_write(socket, boost::asio::buffer(request), boost::asio::transfer_all());
+        if (!error) {
+          std::tie(error, size) =
+              co_await asio_coro::async_read(socket, boost::asio::buffer(response), boost::asio::transfer_all());
+        }
+
+        if (error) {
+          fmt::print(stderr, "round trip failed: {}\n", error.message());
+          co_return;
+        }
+      }
+    });
+  }
+
+  context.run();
+  std::_Exit(0);
+}
+
+void spawn_epoll_connection(boost::asio::io_context &context, boost::asio::ip::tcp::socket socket,
+                            std::size_t buffer_size) {
+  asio_coro::spawn_coroutine(context, [socket = std::move(socket), buffer_size]() mutable -> asio_coro::task<void> {
+    const auto buffer = std::make_unique<char[]>(buffer_size);
+    while (true) {
+      auto [error, size] = co_await asio_coro::async_read(socket, boost::asio::buffer(buffer.get(), buffer_size));
+      if (!error) {
+        std::tie(error, size) = co_await asio_coro::async_write(socket, boost::asio::buffer(buffer.get(), size),
+                                                                boost::asio::transfer_all());
+      }
+
+      if (error) {
+        break;
+      }
+    }
+  });
+}
+
+/// Sends the whole buffer, continuing partial sends.
+asio_coro::task<boost::system::error_code> send_all(asio_coro::uring_context &ring, const asio_coro::uring_file &file,
+                                                    boost::asio::const_buffer buffer) {
+  while (buffer.size() != 0) {
+    const auto [error, size] = co_await ring.async_send(file, buffer);
+    if (error) {
+      co_return error;
+    }
+
+    buffer += size;
+  }
+
+  co_return boost::system::error_code();
+}
+
+void spawn_uring_connection(boost::asio::io_context &context, asio_coro::uring_context &ring,
+                            boost::asio::ip::tcp::socket socket, std::size_t buffer_size) {
+  asio_coro::spawn_coroutine(context, [&ring, socket = std::move(socket),
+                                        buffer_size]() mutable -> asio_coro::task<void> {
+    auto file = ring.register_file(socket.native_handle());
+    const auto buffer = std::make_unique<char[]>(buffer_size);
+    while (true) {
+      const auto [error, size] = co_await ring.async_recv(file, boost::asio::buffer(buffer.get(), buffer_size));
+      if (error || co_await send_all(ring, file, boost::asio::buffer(buffer.get(), size))) {
+        break;
+      }
+    }
+
+    ring.unregister_file(file);
+  });
+}
+
+void spawn_uring_provided_connection(boost::asio::io_context &context, asio_coro::uring_context &ring,
+                                     asio_coro::uring_buffer_ring &buffers, boost::asio::ip::tcp::socket socket) {
+  asio_coro::spawn_coroutine(context, [&ring, &buffers, socket = std::move(socket)]() mutable -> asio_coro::task<void> {
+    auto file = ring.register_file(socket.native_handle());
+    while (true) {
+      const auto [error, buffer] = co_await ring.async_recv(file, buffers);
+      if (error || co_await send_all(ring, file, buffer.buffer())) {
+        break;
+      }
+    }
+
+    ring.unregister_file(file);
+  });
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fmt::print(stderr, "usage: {} epoll|uring|uring_provided [connections=100] [round_trips=2000] [message_size=64]\n",
+               argv[0]);
+    return 1;
+  }
+
+  const std::string_view mode = argv[1];
+  const auto connections_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100ul;
+  const auto round_trips = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 2000ul;
+  const auto message_size = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 64ul;
+  if (mode != "epoll" && mode != "uring" && mode != "uring_provided") {
+    fmt::print(stderr, "unknown mode {}\n", mode);
+    return 1;
+  }
+
+  if (mode != "epoll" && !asio_coro::uring_context::is_supported()) {
+    fmt::print(stderr, "io_uring is not available\n");
+    return 1;
+  }
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  const auto endpoint = acceptor.local_endpoint();
+
+  const auto child = fork();
+  if (child == 0) {
+    acceptor.close();
+    run_client(endpoint, connections_count, round_trips, message_size);
+  }
+
+  std::optional<asio_coro::uring_context> ring;
+  std::optional<asio_coro::uring_buffer_ring> buffers;
+  if (mode != "epoll") {
+    ring.emplace(context, 1024, static_cast<unsigned>(connections_count));
+  }
+
+  if (mode == "uring_provided") {
+    buffers.emplace(*ring, 1, static_cast<std::uint16_t>(std::min(connections_count, 16384ul)), 4096);
+  }
+
+  std::chrono::steady_clock::time_point started_at;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    for (std::size_t accepted = 0; accepted != connections_count; ++accepted) {
+      boost::asio::ip::tcp::socket socket(context);
+      if (const auto error = co_await asio_coro::async_accept(acceptor, socket)) {
+        fmt::print(stderr, "failed to accept a connection: {}\n", error.message());
+        co_return;
+      }
+
+      if (accepted == 0) {
+        started_at = std::chrono::steady_clock::now();
+      }
+
+      socket.set_option(boost::asio::ip::tcp::no_delay(true));
+      if (mode == "epoll") {
+        spawn_epoll_connection(context, std::move(socket), 4096);
+      } else if (mode == "uring") {
+        spawn_uring_connection(context, *ring, std::move(socket), 4096);
+      } else {
+        spawn_uring_provided_connection(context, *ring, *buffers, std::move(socket));
+      }
+    }
+  });
+
+  context.run();
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+  waitpid(child, nullptr, 0);
+
+  const auto total_round_trips = connections_count * round_trips;
+  const auto operations = ring ? ring->operations() : 0;
+  const auto submissions = ring ? ring->submissions() : 0;
+  fmt::print("{{\"mode\": \"{}\", \"connections\": {}, \"round_trips\": {}, \"message_size\": {}, \"seconds\": {:.3f}, "
+             "\"round_trips_per_second\": {:.0f}, \"uring_operations\": {}, \"uring_submissions\": {}, "
+             "\"operations_per_submission\": {:.2f}}}\n",
+             mode, connections_count, total_round_trips, message_size, seconds, total_round_trips / seconds,
+             operations, submissions,
+             submissions ? static_cast<double>(operations) / static_cast<double>(submissions) : 0.0);
+
+  return 0;
+}
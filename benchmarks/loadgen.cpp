@@ -0,0 +1,342 @@
+#include "asio_coro/async_connect.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/buffered_stream.hpp"
+#include "asio_coro/sleep.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// An open-loop load generator for servers built with asio_coro, by default the echo tcp_server example.
+//
+// Every connection sends requests on a fixed schedule, so the total rate is constant no matter how fast the server
+// responds, and one request at a time. The latency of a request is measured from the time it's scheduled at rather than
+// the time it's sent at, so a server that stalls is charged for every request it has delayed, including the ones queued
+// behind the stall, rather than for one slow request only, i.e. the results don't suffer from coordinated omission.
+// Latencies are recorded into a histogram with 3 significant digits, like HdrHistogram, and reported along with the
+// throughput as JSON.
+//
+// Usage: asio_coro_loadgen [--option=value...]
+//   --host=127.0.0.1       The numeric address of the server.
+//   --port=65400           The port of the server, which is the one of the tcp_server example.
+//   --protocol=echo        Either echo, which sends --size bytes and reads them back, or http, which sends GET --path
+//                          requests with keep-alive, e.g. to the http_server example on port 8080.
+//   --connections=16       The amount of connections.
+//   --rate=1000            The total amount of requests per second.
+//   --duration=10          The duration of the run in seconds.
+//   --threads=1            The amount of threads, each running its own io_context with its share of connections.
+//   --size=64              The size of an echo request.
+//   --path=/               The path of an HTTP request.
+
+namespace {
+/// A histogram of values with 3 significant digits, laid out like HdrHistogram: values below 2048 have a counter each,
+/// and every following power of two range is split into 1024 counters, so the relative error is below 0.1%.
+class latency_histogram {
+public:
+  /// Records a value, which is clamped to the largest trackable one, about an hour in nanoseconds.
+  void record(std::uint64_t value) noexcept {
+    value = std::min(value, max_value);
+    ++_counts[index_of(value)];
+    ++_total;
+    _sum += value;
+    _max = std::max(_max, value);
+  }
+
+  /// Adds the values recorded by another histogram.
+  void merge(const latency_histogram &other) noexcept {
+    for (std::size_t i = 0; i != _counts.size(); ++i) {
+      _counts[i] += other._counts[i];
+    }
+
+    _total += other._total;
+    _sum += other._sum;
+    _max = std::max(_max, other._max);
+  }
+
+  std::uint64_t total() const noexcept { return _total; }
+
+  std::uint64_t max() const noexcept { return _max; }
+
+  double mean() const noexcept { return _total == 0 ? 0.0 : static_cast<double>(_sum) / _total; }
+
+  /// Returns the highest value equivalent to the value at the specified percentile, e.g. 99.9.
+  std::uint64_t value_at_percentile(double percentile) const noexcept {
+    const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(percentile / 100.0 * _total + 0.5));
+    std::uint64_t seen = 0;
+    for (std::size_t i = 0; i != _counts.size(); ++i) {
+      seen += _counts[i];
+      if (seen >= rank) {
+        return std::min(highest_equivalent_value(i), _max);
+      }
+    }
+
+    return _max;
+  }
+
+private:
+  static constexpr unsigned sub_bucket_half_magnitude = 10;
+  static constexpr std::uint64_t sub_bucket_half_count = 1u << sub_bucket_half_magnitude;
+  static constexpr std::uint64_t max_value = (std::uint64_t(1) << 42) - 1;
+  static constexpr std::size_t buckets_count = 42 - sub_bucket_half_magnitude;
+
+  std::vector<std::uint64_t> _counts = std::vector<std::uint64_t>((buckets_count + 1) * sub_bucket_half_count);
+  std::uint64_t _total = 0;
+  std::uint64_t _sum = 0;
+  std::uint64_t _max = 0;
+
+  static std::size_t index_of(std::uint64_t value) noexcept {
+    const auto magnitude = 63 - __builtin_clzll(value | (2 * sub_bucket_half_count - 1));
+    const auto bucket = static_cast<std::size_t>(magnitude - sub_bucket_half_magnitude);
+    return bucket * sub_bucket_half_count + (value >> bucket);
+  }
+
+  static std::uint64_t highest_equivalent_value(std::size_t index) noexcept {
+    if (index < 2 * sub_bucket_half_count) {
+      return index;
+    }
+
+    const auto bucket = index / sub_bucket_half_count - 1;
+    const auto sub_bucket = index % sub_bucket_half_count + sub_bucket_half_count;
+    return ((sub_bucket + 1) << bucket) - 1;
+  }
+};
+
+struct options {
+  std::string host = "127.0.0.1";
+  unsigned short port = 65400;
+  std::string protocol = "echo";
+  std::size_t connections = 16;
+  double rate = 1000;
+  double duration = 10;
+  std::size_t threads = 1;
+  std::size_t size = 64;
+  std::string path = "/";
+};
+
+/// The state of one thread of the load generator.
+struct worker {
+  boost::asio::io_context context{1};
+  latency_histogram histogram;
+  std::size_t errors = 0;
+  /// The amount of requests that were due but not sent by the end, because the target couldn't keep up.
+  std::size_t missed = 0;
+};
+
+/// Sends one echo request, and reads the response.
+asio_coro::task<boost::system::error_code> echo_exchange(boost::asio::ip::tcp::socket &socket, std::string &buffer) {
+  const auto [write_error, write_size] =
+      co_await asio_coro::async_write(socket, boost::asio::buffer(buffer), boost::asio::transfer_all());
+  if (write_error) {
+    co_return write_error;
+  }
+
+  const auto [read_error, read_size] =
+      co_await asio_coro::async_read(socket, boost::asio::buffer(buffer), boost::asio::transfer_all());
+  co_return read_error;
+}
+
+/// Returns the value of the Content-Length header of the response head, or 0 if there is none.
+std::size_t content_length(std::string_view head) {
+  constexpr std::string_view name = "\r\ncontent-length:";
+  for (std::size_t position = head.find("\r\n"); position != std::string_view::npos;
+       position = head.find("\r\n", position + 2)) {
+    const auto line = head.substr(position, name.size());
+    if (line.size() == name.size() && std::equal(line.begin(), line.end(), name.begin(), [](char l, char r) {
+          return (l | 0x20) == (r | 0x20);
+        })) {
+      auto value = head.substr(position + name.size());
+      value.remove_prefix(std::min(value.find_first_not_of(' '), value.size()));
+      std::size_t result = 0;
+      std::from_chars(value.data(), value.data() + value.size(), result);
+      return result;
+    }
+  }
+
+  return 0;
+}
+
+/// Sends one HTTP request, and reads the response.
+asio_coro::task<boost::system::error_code>
+http_exchange(boost::asio::ip::tcp::socket &socket, asio_coro::buffered_stream<boost::asio::ip::tcp::socket> &stream,
+              const std::string &request) {
+  const auto [write_error, write_size] =
+      co_await asio_coro::async_write(socket, boost::asio::buffer(request), boost::asio::transfer_all());
+  if (write_error) {
+    co_return write_error;
+  }
+
+  const auto [head_error, head] = co_await stream.async_read_until("\r\n\r\n");
+  if (head_error) {
+    co_return head_error;
+  }
+
+  const auto response_size = head.size() + content_length(head);
+  const auto [body_error, response] = co_await stream.async_read_exactly(response_size);
+  stream.consume(response_size);
+  co_return body_error;
+}
+
+/// Runs a connection sending requests on its schedule until the end time, reconnecting after failures. The requests
+/// still due at the end time are counted as missed rather than sent, so an overloaded target doesn't extend the run.
+asio_coro::task<void> run_connection(worker &worker, const options &options,
+                                     const boost::asio::ip::tcp::endpoint &endpoint,
+                                     std::chrono::steady_clock::time_point first_request,
+                                     std::chrono::steady_clock::duration interval,
+                                     std::chrono::steady_clock::time_point end) {
+  const auto request = fmt::format("GET {} HTTP/1.1\r\nHost: {}\r\n\r\n", options.path, options.host);
+  std::string echo_buffer(options.size, 'x');
+
+  auto scheduled = first_request;
+  while (scheduled < end && std::chrono::steady_clock::now() < end) {
+    boost::asio::ip::tcp::socket socket(worker.context);
+    if (const auto error = co_await asio_coro::async_connect(socket, endpoint)) {
+      ++worker.errors;
+      scheduled += interval;
+      co_await asio_coro::sleep_until(worker.context, scheduled);
+      continue;
+    }
+
+    socket.set_option(boost::asio::ip::tcp::no_delay(true));
+    asio_coro::buffered_stream stream(socket);
+    for (; scheduled < end && std::chrono::steady_clock::now() < end; scheduled += interval) {
+      // A request that is behind the schedule is sent right away, and charged for the time it has waited.
+      if (std::chrono::steady_clock::now() < scheduled) {
+        co_await asio_coro::sleep_until(worker.context, scheduled);
+      }
+
+      boost::system::error_code error;
+      if (options.protocol == "http") {
+        error = co_await http_exchange(socket, stream, request);
+      } else {
+        error = co_await echo_exchange(socket, echo_buffer);
+      }
+
+      if (error) {
+        ++worker.errors;
+        scheduled += interval;
+        break;
+      }
+
+      const auto latency = std::chrono::steady_clock::now() - scheduled;
+      worker.histogram.record(
+          static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count()));
+    }
+  }
+
+  if (scheduled < end) {
+    worker.missed += static_cast<std::size_t>((end - scheduled + interval - std::chrono::nanoseconds(1)) / interval);
+  }
+}
+
+bool parse_options(int argc, char **argv, options &result) {
+  for (auto i = 1; i < argc; ++i) {
+    const std::string_view argument = argv[i];
+    const auto separator = argument.find('=');
+    if (argument.substr(0, 2) != "--" || separator == std::string_view::npos) {
+      fmt::print(stderr, "malformed option {}\n", argument);
+      return false;
+    }
+
+    const auto name = argument.substr(2, separator - 2);
+    const std::string value(argument.substr(separator + 1));
+    if (name == "host") {
+      result.host = value;
+    } else if (name == "port") {
+      result.port = static_cast<unsigned short>(std::strtoul(value.c_str(), nullptr, 10));
+    } else if (name == "protocol" && (value == "echo" || value == "http")) {
+      result.protocol = value;
+    } else if (name == "connections") {
+      result.connections = std::max<std::size_t>(1, std::strtoul(value.c_str(), nullptr, 10));
+    } else if (name == "rate") {
+      result.rate = std::strtod(value.c_str(), nullptr);
+    } else if (name == "duration") {
+      result.duration = std::strtod(value.c_str(), nullptr);
+    } else if (name == "threads") {
+      result.threads = std::max<std::size_t>(1, std::strtoul(value.c_str(), nullptr, 10));
+    } else if (name == "size") {
+      result.size = std::max<std::size_t>(1, std::strtoul(value.c_str(), nullptr, 10));
+    } else if (name == "path") {
+      result.path = value;
+    } else {
+      fmt::print(stderr, "unknown option {}\n", argument);
+      return false;
+    }
+  }
+
+  if (result.rate <= 0 || result.duration <= 0) {
+    fmt::print(stderr, "the rate and the duration must be positive\n");
+    return false;
+  }
+
+  return true;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  options options;
+  if (!parse_options(argc, argv, options)) {
+    return 1;
+  }
+
+  const boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::make_address(options.host), options.port);
+  const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+      std::chrono::duration<double>(options.connections / options.rate));
+
+  // The connections are spread over the schedule, so their requests don't arrive in bursts.
+  const auto started_at = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+  const auto end = started_at + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                    std::chrono::duration<double>(options.duration));
+
+  std::deque<worker> workers(options.threads);
+  for (std::size_t i = 0; i != options.connections; ++i) {
+    auto &worker = workers[i % workers.size()];
+    const auto first_request = started_at + interval * i / options.connections;
+    asio_coro::spawn_coroutine(worker.context, [&, first_request]() {
+      return run_connection(worker, options, endpoint, first_request, interval, end);
+    });
+  }
+
+  std::vector<std::thread> threads;
+  for (auto &worker : workers) {
+    threads.emplace_back([&worker]() { worker.context.run(); });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+  latency_histogram histogram;
+  std::size_t errors = 0;
+  std::size_t missed = 0;
+  for (auto &worker : workers) {
+    histogram.merge(worker.histogram);
+    errors += worker.errors;
+    missed += worker.missed;
+  }
+
+  const auto microseconds = [&](double percentile) { return histogram.value_at_percentile(percentile) / 1000.0; };
+  fmt::print("{{\"protocol\": \"{}\", \"target\": \"{}:{}\", \"connections\": {}, \"threads\": {}, \"rate\": {:.0f}, "
+             "\"seconds\": {:.3f}, \"requests\": {}, \"errors\": {}, \"missed\": {}, \"throughput_rps\": {:.0f}, "
+             "\"mean_us\": {:.1f}, \"p50_us\": {:.1f}, \"p90_us\": {:.1f}, \"p99_us\": {:.1f}, \"p999_us\": {:.1f}, "
+             "\"max_us\": {:.1f}}}\n",
+             options.protocol, options.host, options.port, options.connections, options.threads, options.rate, seconds,
+             histogram.total(), errors, missed, histogram.total() / seconds, histogram.mean() / 1000.0,
+             microseconds(50), microseconds(90), microseconds(99), microseconds(99.9), histogram.max() / 1000.0);
+
+  return errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+#include "asio_coro/async_mutex.hpp"
+#include "asio_coro/boost_future.hpp"
+#include "asio_coro/dispatch.hpp"
+#include "asio_coro/post.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+
+// Microbenchmarks of the coroutine machinery itself: task creation and destruction, chains of awaited tasks, which
+// resume each other by symmetric transfer, spawn_coroutine, post and dispatch hops, async_mutex with and without
+// contention, and awaiting boost::future. Every benchmark prints one JSON line with the time and the amount of heap
+// allocations per operation, the latter counted by the replaced global operator new, so a change in detail/task.hpp or
+// async_mutex.hpp that adds an allocation or a hop shows up even if the time is noisy.
+//
+// Usage: asio_coro_benchmarks [filter] [scale=1]
+//
+// Only the benchmarks whose names contain the filter are run, and the amount of operations is multiplied by the scale.
+// Build with optimizations, e.g. -DCMAKE_BUILD_TYPE=Release: without them GCC doesn't turn symmetric transfer into a
+// tail call, and the long chains of awaited tasks run out of stack.
+
+namespace {
+std::atomic<std::uint64_t> allocations{0};
+
+void *allocate(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto *pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+
+  throw std::bad_alloc();
+}
+} // namespace
+
+void *operator new(std::size_t size) { return allocate(size); }
+
+void *operator new[](std::size_t size) { return allocate(size); }
+
+void operator delete(void *pointer) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer) noexcept { std::free(pointer); }
+
+void operator delete(void *pointer, std::size_t) noexcept { std::free(pointer); }
+
+void operator delete[](void *pointer, std::size_t) noexcept { std::free(pointer); }
+
+namespace {
+/// The amount of operations resuming the coroutine inline, after which it's posted to unwind the stack.
+constexpr std::size_t inline_resumptions = 64;
+
+std::string_view filter;
+double scale = 1;
+
+/// Keeps the compiler from optimizing the value, and the computation of it, away.
+template <class T> void do_not_optimize(T &value) { asm volatile("" : : "r"(&value) : "memory"); }
+
+/// Runs the body with a tenth of the operations to warm the caches and the allocator up, then runs it again with all
+/// of them, and prints the time and the allocations per operation.
+template <class Body> void run_benchmark(std::string_view name, std::size_t operations, Body body) {
+  if (name.find(filter) == std::string_view::npos) {
+    return;
+  }
+
+  operations = std::max<std::size_t>(static_cast<std::size_t>(operations * scale), 1);
+  body(std::max<std::size_t>(operations / 10, 1));
+
+  const auto started_allocations = allocations.load(std::memory_order_relaxed);
+  const auto started_at = std::chrono::steady_clock::now();
+  body(operations);
+  const auto elapsed = std::chrono::steady_clock::now() - started_at;
+  const auto used_allocations = allocations.load(std::memory_order_relaxed) - started_allocations;
+
+  fmt::print("{{\"benchmark\": \"{}\", \"operations\": {}, \"ns_per_op\": {:.1f}, \"allocations_per_op\": {:.3f}}}\n",
+             name, operations,
+             static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) / operations,
+             static_cast<double>(used_allocations) / operations);
+}
+
+/// Runs the coroutine function on a fresh io_context until it completes.
+template <class Function> void run_coroutine(Function function) {
+  boost::asio::io_context context(1);
+  asio_coro::spawn_coroutine(context, [&]() { return function(context); });
+  context.run();
+}
+
+asio_coro::task<int> make_value(int value) { co_return value; }
+
+asio_coro::task<int> chain(std::size_t depth) {
+  if (depth == 0) {
+    co_return 0;
+  }
+
+  const auto value = co_await chain(depth - 1);
+  co_return value + 1;
+}
+
+/// Creates and destroys a task without starting it, which is the cost of the coroutine frame and the promise.
+void task_create_destroy(std::size_t operations) {
+  for (std::size_t i = 0; i != operations; ++i) {
+    auto task = make_value(static_cast<int>(i));
+    do_not_optimize(task);
+  }
+}
+
+/// Awaits chains of nested tasks, an operation being one level: a task is created, started by the awaiting task, and
+/// resumes it upon completion, both by symmetric transfer.
+void co_await_chain(std::size_t depth, std::size_t operations) {
+  run_coroutine([=](boost::asio::io_context &) -> asio_coro::task<void> {
+    for (std::size_t i = 0; i < operations; i += depth) {
+      auto value = co_await chain(depth);
+      do_not_optimize(value);
+    }
+  });
+}
+
+/// Spawns coroutines in batches, and runs them to completion.
+void spawn(std::size_t operations) {
+  boost::asio::io_context context(1);
+  std::size_t completed = 0;
+  for (std::size_t i = 0; i < operations; i += 1000) {
+    for (std::size_t j = i; j != std::min(i + 1000, operations); ++j) {
+      asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+        ++completed;
+        co_return;
+      });
+    }
+
+    context.restart();
+    context.run();
+  }
+
+  do_not_optimize(completed);
+}
+
+void post_hop(std::size_t operations) {
+  run_coroutine([=](boost::asio::io_context &context) -> asio_coro::task<void> {
+    for (std::size_t i = 0; i != operations; ++i) {
+      co_await asio_coro::post(context);
+    }
+  });
+}
+
+/// Dispatches the coroutine to the io_context it already runs in, so it's resumed inline, i.e. deeper in the stack,
+/// and posts it once in a while to unwind the stack, which costs about post_hop / inline_resumptions per operation.
+void dispatch_hop(std::size_t operations) {
+  run_coroutine([=](boost::asio::io_context &context) -> asio_coro::task<void> {
+    for (std::size_t i = 0; i != operations; ++i) {
+      co_await asio_coro::dispatch(context);
+      if (i % inline_resumptions == inline_resumptions - 1) {
+        co_await asio_coro::post(context);
+      }
+    }
+  });
+}
+
+void mutex_uncontended(std::size_t operations) {
+  asio_coro::async_mutex mutex;
+  run_coroutine([&](boost::asio::io_context &) -> asio_coro::task<void> {
+    for (std::size_t i = 0; i != operations; ++i) {
+      const auto lock = co_await mutex.async_lock_scoped();
+    }
+  });
+}
+
+/// Runs several coroutines that yield while holding the lock, so every lock is passed to a waiting coroutine upon
+/// unlocking. An operation includes a post hop, see post_hop.
+void mutex_contended(std::size_t operations) {
+  constexpr std::size_t coroutines_count = 4;
+
+  boost::asio::io_context context(1);
+  asio_coro::async_mutex mutex;
+  for (std::size_t i = 0; i != coroutines_count; ++i) {
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      for (std::size_t j = 0; j < operations / coroutines_count; ++j) {
+        const auto lock = co_await mutex.async_lock_scoped();
+        co_await asio_coro::post(context);
+      }
+    });
+  }
+
+  context.run();
+}
+
+/// Awaits a future that is already resolved, so the coroutine is resumed inline, and posts it once in a while to
+/// unwind the stack, see dispatch_hop.
+void future_ready(std::size_t operations) {
+  run_coroutine([=](boost::asio::io_context &context) -> asio_coro::task<void> {
+    for (std::size_t i = 0; i != operations; ++i) {
+      boost::promise<int> promise;
+      promise.set_value(static_cast<int>(i));
+      auto value = co_await asio_coro::async_wait_future(promise.get_future());
+      do_not_optimize(value);
+      if (i % inline_resumptions == inline_resumptions - 1) {
+        co_await asio_coro::post(context);
+      }
+    }
+  });
+}
+
+/// Awaits a future that is resolved by a handler posted to the io_context. An operation includes a post. The handler
+/// owns the promise, since the coroutine may be resumed, and go on to the next iteration, before set_value returns.
+void future_resolved_later(std::size_t operations) {
+  run_coroutine([=](boost::asio::io_context &context) -> asio_coro::task<void> {
+    for (std::size_t i = 0; i != operations; ++i) {
+      boost::promise<int> promise;
+      auto future = promise.get_future();
+      boost::asio::post(context, [promise = std::move(promise), i]() mutable {
+        promise.set_value(static_cast<int>(i));
+      });
+      auto value = co_await asio_coro::async_wait_future(std::move(future));
+      do_not_optimize(value);
+    }
+  });
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  filter = argc > 1 ? argv[1] : "";
+  scale = argc > 2 ? std::strtod(argv[2], nullptr) : 1;
+  if (scale <= 0) {
+    fmt::print(stderr, "the scale must be positive\n");
+    return 1;
+  }
+
+  run_benchmark("task_create_destroy", 10'000'000, task_create_destroy);
+  for (const std::size_t depth : {1, 16, 256}) {
+    run_benchmark(fmt::format("co_await_chain_depth_{}", depth), 10'000'000,
+                  [depth](std::size_t operations) { co_await_chain(depth, operations); });
+  }
+  run_benchmark("spawn_coroutine", 1'000'000, spawn);
+  run_benchmark("post_hop", 5'000'000, post_hop);
+  run_benchmark("dispatch_hop", 5'000'000, dispatch_hop);
+  run_benchmark("async_mutex_uncontended", 10'000'000, mutex_uncontended);
+  run_benchmark("async_mutex_contended", 2'000'000, mutex_contended);
+  run_benchmark("boost_future_ready", 1'000'000, future_ready);
+  run_benchmark("boost_future_resolved_later", 1'000'000, future_resolved_later);
+
+  return 0;
+}
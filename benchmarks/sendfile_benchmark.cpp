@@ -0,0 +1,180 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_sendfile.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <fmt/format.h>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Compares serving a file with async_sendfile against reading it into a user space buffer and writing the buffer with
+// async_write. A child process connects over the loopback interface and discards everything it receives. The server
+// process sends the file the specified amount of times over every connection, and reports the throughput along with
+// the CPU time it spent, as a percentage of the wall time.
+
+namespace {
+/// Receives and discards the data of the specified amount of connections until the server closes them.
+[[noreturn]] void run_client(const boost::asio::ip::tcp::endpoint &endpoint, std::size_t connections_count) {
+  boost::asio::io_context context;
+  for (std::size_t i = 0; i != connections_count; ++i) {
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      boost::asio::ip::tcp::socket socket(context);
+      socket.connect(endpoint);
+
+      const auto buffer = std::make_unique<char[]>(1 << 20);
+      while (true) {
+        const auto [error, size] = co_await asio_coro::async_read(socket, boost::asio::buffer(buffer.get(), 1 << 20));
+        if (error) {
+          break;
+        }
+      }
+    });
+  }
+
+  context.run();
+  std::_Exit(0);
+}
+
+/// Creates an unlinked file of the specified size and returns its descriptor.
+int create_file(std::size_t size) {
+  char path[] = "/tmp/asio_coro_sendfile_benchmark_XXXXXX";
+  const auto fd = ::mkstemp(path);
+  if (fd == -1) {
+    fmt::print(stderr, "failed to create a file\n");
+    std::exit(1);
+  }
+
+  ::unlink(path);
+  const std::string block(1 << 20, 'f');
+  for (std::size_t written = 0; written < size; written += block.size()) {
+    if (::write(fd, block.data(), block.size()) != static_cast<ssize_t>(block.size())) {
+      fmt::print(stderr, "failed to fill the file\n");
+      std::exit(1);
+    }
+  }
+
+  return fd;
+}
+
+asio_coro::task<boost::system::error_code> send_with_read_write(boost::asio::ip::tcp::socket &socket, int fd,
+                                                                std::size_t size, std::size_t buffer_size) {
+  const auto buffer = std::make_unique<char[]>(buffer_size);
+  for (std::size_t offset = 0; offset < size;) {
+    const auto count = ::pread(fd, buffer.get(), std::min(buffer_size, size - offset), static_cast<off_t>(offset));
+    if (count <= 0) {
+      co_return boost::system::error_code(errno, boost::system::system_category());
+    }
+
+    const auto [error, written] = co_await asio_coro::async_write(
+        socket, boost::asio::buffer(buffer.get(), static_cast<std::size_t>(count)), boost::asio::transfer_all());
+    if (error) {
+      co_return error;
+    }
+
+    offset += written;
+  }
+
+  co_return boost::system::error_code();
+}
+
+/// Returns the CPU time the process has spent in user and kernel mode, in seconds.
+double cpu_seconds() {
+  rusage usage{};
+  ::getrusage(RUSAGE_SELF, &usage);
+  const auto to_seconds = [](const timeval &time) { return time.tv_sec + time.tv_usec / 1e6; };
+  return to_seconds(usage.ru_utime) + to_seconds(usage.ru_stime);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fmt::print(stderr, "usage: {} sendfile|read_write [connections=1] [file_size_mb=64] [repeats=16] [buffer_kb=64]\n",
+               argv[0]);
+    return 1;
+  }
+
+  const std::string_view mode = argv[1];
+  const auto connections_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1ul;
+  const auto file_size = (argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 64ul) << 20;
+  const auto repeats = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 16ul;
+  const auto buffer_size = (argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 64ul) << 10;
+  if (mode != "sendfile" && mode != "read_write") {
+    fmt::print(stderr, "unknown mode {}\n", mode);
+    return 1;
+  }
+
+  const auto fd = create_file(file_size);
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  const auto endpoint = acceptor.local_endpoint();
+
+  const auto child = fork();
+  if (child == 0) {
+    acceptor.close();
+    run_client(endpoint, connections_count);
+  }
+
+  std::size_t failures = 0;
+  auto started_at = std::chrono::steady_clock::now();
+  auto started_cpu = cpu_seconds();
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    for (std::size_t accepted = 0; accepted != connections_count; ++accepted) {
+      boost::asio::ip::tcp::socket socket(context);
+      if (const auto error = co_await asio_coro::async_accept(acceptor, socket)) {
+        fmt::print(stderr, "failed to accept a connection: {}\n", error.message());
+        co_return;
+      }
+
+      if (accepted == 0) {
+        started_at = std::chrono::steady_clock::now();
+        started_cpu = cpu_seconds();
+      }
+
+      asio_coro::spawn_coroutine(context, [&, socket = std::move(socket)]() mutable -> asio_coro::task<void> {
+        for (std::size_t repeat = 0; repeat != repeats; ++repeat) {
+          boost::system::error_code error;
+          if (mode == "sendfile") {
+            std::tie(error, std::ignore) = co_await asio_coro::async_sendfile(socket, fd, 0, file_size);
+          } else {
+            error = co_await send_with_read_write(socket, fd, file_size, buffer_size);
+          }
+
+          if (error) {
+            fmt::print(stderr, "failed to send the file: {}\n", error.message());
+            ++failures;
+            break;
+          }
+        }
+      });
+    }
+  });
+
+  context.run();
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+  const auto cpu = cpu_seconds() - started_cpu;
+  waitpid(child, nullptr, 0);
+  ::close(fd);
+
+  const auto bytes = static_cast<double>(connections_count * repeats * file_size);
+  fmt::print("{{\"mode\": \"{}\", \"connections\": {}, \"file_size\": {}, \"repeats\": {}, \"seconds\": {:.3f}, "
+             "\"gigabytes_per_second\": {:.2f}, \"cpu_percent\": {:.1f}, \"failures\": {}}}\n",
+             mode, connections_count, file_size, repeats, seconds, bytes / seconds / (1 << 30), cpu / seconds * 100,
+             failures);
+
+  return failures == 0 ? 0 : 1;
+}
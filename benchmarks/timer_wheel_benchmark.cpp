@@ -0,0 +1,133 @@
+#include "asio_coro/async_wait.hpp"
+#include "asio_coro/task.hpp"
+#include "asio_coro/timer_wheel.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <fmt/format.h>
+
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Compares the cost of serving per-connection inactivity timeouts with a steady_timer per connection that wakes up
+// every second to check the last activity time (what the tcp_server example used to do) and with an idle timer served
+// by a shared timer wheel. Connections are simulated: every coroutine only awaits its inactivity timeout, which is
+// longer than the benchmark duration, so the result is the pure cost of keeping idle connections around.
+
+namespace {
+struct connection {
+  std::chrono::steady_clock::time_point last_active_time = std::chrono::steady_clock::now();
+};
+
+std::size_t resident_set_size() {
+  std::ifstream statm("/proc/self/statm");
+
+  std::size_t size = 0;
+  std::size_t resident = 0;
+  statm >> size >> resident;
+
+  return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+std::chrono::microseconds cpu_time() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+
+  const auto to_microseconds = [](const timeval &value) {
+    return std::chrono::seconds(value.tv_sec) + std::chrono::microseconds(value.tv_usec);
+  };
+
+  return to_microseconds(usage.ru_utime) + to_microseconds(usage.ru_stime);
+}
+
+void spawn_steady_timer_connections(boost::asio::io_context &context, std::vector<connection> &connections,
+                                    std::size_t &wakeups) {
+  for (auto &connection : connections) {
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      boost::asio::steady_timer timer(context);
+      while (true) {
+        timer.expires_from_now(std::chrono::seconds(1));
+        if (co_await asio_coro::async_wait(timer)) {
+          break;
+        }
+
+        ++wakeups;
+        if (std::chrono::steady_clock::now() - connection.last_active_time > std::chrono::minutes(5)) {
+          break;
+        }
+      }
+    });
+  }
+}
+
+void spawn_timer_wheel_connections(boost::asio::io_context &context, asio_coro::timer_wheel &timer_wheel,
+                                   std::vector<std::unique_ptr<asio_coro::timer_wheel::idle_timer>> &idle_timers,
+                                   std::size_t &wakeups) {
+  for (auto &idle_timer : idle_timers) {
+    idle_timer = std::make_unique<asio_coro::timer_wheel::idle_timer>(timer_wheel, std::chrono::minutes(5));
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      co_await idle_timer->async_wait();
+      ++wakeups;
+    });
+  }
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fmt::print(stderr, "usage: {} steady_timer|timer_wheel [connections=100000] [seconds=10]\n", argv[0]);
+    return 1;
+  }
+
+  const std::string_view mode = argv[1];
+  const auto connections_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000ul;
+  const auto duration = std::chrono::seconds(argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 10ul);
+
+  boost::asio::io_context context;
+  asio_coro::timer_wheel timer_wheel(context, std::chrono::seconds(1));
+  std::vector<connection> connections;
+  std::vector<std::unique_ptr<asio_coro::timer_wheel::idle_timer>> idle_timers;
+  std::size_t wakeups = 0;
+
+  const auto initial_rss = resident_set_size();
+  if (mode == "steady_timer") {
+    connections.resize(connections_count);
+    spawn_steady_timer_connections(context, connections, wakeups);
+  } else if (mode == "timer_wheel") {
+    idle_timers.resize(connections_count);
+    spawn_timer_wheel_connections(context, timer_wheel, idle_timers, wakeups);
+  } else {
+    fmt::print(stderr, "unknown mode {}\n", mode);
+    return 1;
+  }
+
+  // Start all the coroutines, so every timeout gets armed.
+  context.poll();
+
+  const auto armed_rss = resident_set_size();
+  const auto started_cpu_time = cpu_time();
+
+  context.run_for(duration);
+
+  const auto used_cpu_time = cpu_time() - started_cpu_time;
+  fmt::print("{{\"mode\": \"{}\", \"connections\": {}, \"seconds\": {}, \"cpu_ms\": {:.1f}, \"cpu_percent\": {:.2f}, "
+             "\"wakeups\": {}, \"rss_bytes_per_connection\": {:.1f}}}\n",
+             mode, connections_count, duration.count(), used_cpu_time.count() / 1000.0,
+             100.0 * used_cpu_time.count() / std::chrono::duration_cast<std::chrono::microseconds>(duration).count(),
+             wakeups, static_cast<double>(armed_rss - initial_rss) / connections_count);
+
+  // Stop the wheel explicitly so the idle timers are released prior to their destruction.
+  timer_wheel.stop();
+  context.restart();
+  context.poll();
+
+  return 0;
+}
@@ -0,0 +1,187 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_connect.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/ssl_stream.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+
+#include <fmt/format.h>
+
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Measures the rate of TLS handshakes made either from scratch every time, or resuming the session cached by a
+// tls_session_cache. A child process runs a server with a self-signed P-256 certificate, which sends one byte after
+// every handshake. The client keeps the specified amount of connections in flight, reads that byte, so the TLS 1.3
+// session tickets sent before it are processed, shuts the session down, so OpenSSL keeps it resumable, and resets the
+// connection. It reports the handshake rate, the latency percentiles of the connect and the handshake, and the amount
+// of resumed sessions.
+
+namespace {
+using ssl_socket = boost::asio::ssl::stream<boost::asio::ip::tcp::socket>;
+
+/// Makes the server use a new self-signed certificate, and the client trust it.
+void use_self_signed_certificate(boost::asio::ssl::context &server, boost::asio::ssl::context &client) {
+  std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> key(EVP_EC_gen("P-256"), &EVP_PKEY_free);
+  std::unique_ptr<X509, decltype(&X509_free)> certificate(X509_new(), &X509_free);
+  X509_set_version(certificate.get(), 2);
+  ASN1_INTEGER_set(X509_get_serialNumber(certificate.get()), 1);
+  X509_gmtime_adj(X509_getm_notBefore(certificate.get()), 0);
+  X509_gmtime_adj(X509_getm_notAfter(certificate.get()), 3600);
+  X509_set_pubkey(certificate.get(), key.get());
+  const auto name = X509_get_subject_name(certificate.get());
+  X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char *>("localhost"), -1, -1, 0);
+  X509_set_issuer_name(certificate.get(), name);
+  X509_sign(certificate.get(), key.get(), EVP_sha256());
+
+  SSL_CTX_use_certificate(server.native_handle(), certificate.get());
+  SSL_CTX_use_PrivateKey(server.native_handle(), key.get());
+  X509_STORE_add_cert(SSL_CTX_get_cert_store(client.native_handle()), certificate.get());
+  client.set_verify_mode(boost::asio::ssl::verify_peer);
+}
+
+/// Performs the handshake with every accepted connection and sends one byte until the process is killed.
+[[noreturn]] void run_server(int fd, boost::asio::ssl::context &ssl_context) {
+  // The acceptor is inherited from the parent process, so it's assigned to an io_context of the child.
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, boost::asio::ip::tcp::v4(), ::dup(fd));
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    while (true) {
+      auto stream = std::make_shared<ssl_socket>(context, ssl_context);
+      if (co_await asio_coro::async_accept(acceptor, stream->next_layer())) {
+        continue;
+      }
+
+      stream->next_layer().set_option(boost::asio::ip::tcp::no_delay(true));
+      asio_coro::spawn_coroutine(context, [stream]() -> asio_coro::task<void> {
+        if (co_await asio_coro::async_handshake(*stream, boost::asio::ssl::stream_base::server)) {
+          co_return;
+        }
+
+        const auto [write_error, write_size] = co_await asio_coro::async_write(*stream, boost::asio::buffer("!", 1));
+        if (write_error) {
+          co_return;
+        }
+
+        // The client shuts the session down once it has read the byte.
+        char data;
+        co_await asio_coro::async_read(*stream, boost::asio::buffer(&data, 1));
+        co_await asio_coro::async_shutdown(*stream);
+      });
+    }
+  });
+
+  context.run();
+  std::_Exit(0);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fmt::print(stderr, "usage: {} full|resumed [handshakes=5000] [concurrency=8]\n", argv[0]);
+    return 1;
+  }
+
+  const std::string_view mode = argv[1];
+  const auto handshakes_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 5000ul;
+  const auto concurrency = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 8ul;
+  if (mode != "full" && mode != "resumed") {
+    fmt::print(stderr, "unknown mode {}\n", mode);
+    return 1;
+  }
+
+  boost::asio::ssl::context server_context(boost::asio::ssl::context::tls_server);
+  boost::asio::ssl::context client_context(boost::asio::ssl::context::tls_client);
+  use_self_signed_certificate(server_context, client_context);
+  asio_coro::tls_session_cache::attach(client_context);
+  auto &cache = asio_coro::tls_session_cache::instance();
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  acceptor.listen(1024);
+  const auto endpoint = acceptor.local_endpoint();
+
+  const auto child = fork();
+  if (child == 0) {
+    run_server(acceptor.native_handle(), server_context);
+  }
+
+  acceptor.close();
+  std::vector<double> latencies;
+  latencies.reserve(handshakes_count);
+  std::size_t started = 0;
+  std::size_t failed = 0;
+  std::size_t resumed = 0;
+
+  const auto started_at = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i != concurrency; ++i) {
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      while (started != handshakes_count) {
+        ++started;
+        const auto handshake_started_at = std::chrono::steady_clock::now();
+        ssl_socket stream(context, client_context);
+        auto error = co_await asio_coro::async_connect(stream.next_layer(), endpoint);
+        if (!error) {
+          stream.next_layer().set_option(boost::asio::ip::tcp::no_delay(true));
+          if (mode == "resumed") {
+            error = co_await asio_coro::async_handshake(stream, cache, "localhost");
+          } else {
+            error = co_await asio_coro::async_handshake(stream, boost::asio::ssl::stream_base::client);
+          }
+        }
+
+        if (!error) {
+          resumed += asio_coro::session_reused(stream) ? 1 : 0;
+          latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() -
+                                                                        handshake_started_at)
+                                  .count());
+
+          char data;
+          const auto [read_error, read_size] = co_await asio_coro::async_read(stream, boost::asio::buffer(&data, 1));
+          error = read_error;
+          if (!error) {
+            error = co_await asio_coro::async_shutdown(stream);
+          }
+
+          stream.next_layer().set_option(boost::asio::socket_base::linger(true, 0));
+        }
+
+        if (error) {
+          ++failed;
+        }
+      }
+    });
+  }
+
+  context.run();
+  const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+  kill(child, SIGKILL);
+  waitpid(child, nullptr, 0);
+
+  std::sort(latencies.begin(), latencies.end());
+  const auto percentile = [&](double fraction) {
+    return latencies.empty() ? 0.0 : latencies[static_cast<std::size_t>(fraction * (latencies.size() - 1))];
+  };
+
+  fmt::print("{{\"mode\": \"{}\", \"handshakes\": {}, \"resumed\": {}, \"failed\": {}, \"concurrency\": {}, "
+             "\"seconds\": {:.3f}, \"handshakes_per_second\": {:.0f}, \"p50_us\": {:.1f}, \"p99_us\": {:.1f}}}\n",
+             mode, latencies.size(), resumed, failed, concurrency, seconds, latencies.size() / seconds,
+             percentile(0.5), percentile(0.99));
+
+  return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+#include "asio_coro/async_datagram.hpp"
+#include "asio_coro/buffer_pool.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <fmt/format.h>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <cstdlib>
+#include <string_view>
+#include <vector>
+
+// Measures the packets per second a UDP echo server handles, echoing either one datagram per operation with
+// async_receive_from/async_send_to, or batches of datagrams with async_receive_batch/async_send_batch, optionally with
+// generic segmentation and receive offload. A child process runs the server, while the benchmark process keeps the
+// specified amount of packets in flight with the batched operations until the specified amount of packets is echoed,
+// or nothing is echoed for a second because too many packets have been dropped.
+
+namespace {
+constexpr std::size_t max_segments = 16;
+
+/// Echoes the datagrams received by the specified socket.
+[[noreturn]] void run_server(int fd, std::string_view mode) {
+  // The socket is inherited from the parent process, so it's assigned to an io_context of the child.
+  boost::asio::io_context context;
+  boost::asio::ip::udp::socket socket(context, boost::asio::ip::udp::v4(), ::dup(fd));
+
+  asio_coro::buffer_pool pool(65536, 64);
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    if (mode == "single") {
+      std::vector<char> buffer(65536);
+      boost::asio::ip::udp::endpoint endpoint;
+      while (true) {
+        const auto [error, size] =
+            co_await asio_coro::async_receive_from(socket, boost::asio::buffer(buffer), endpoint);
+        if (error) {
+          break;
+        }
+
+        const auto [send_error, sent] =
+            co_await asio_coro::async_send_to(socket, boost::asio::buffer(buffer.data(), size), endpoint);
+        if (send_error) {
+          break;
+        }
+      }
+    } else {
+      if (mode == "gso") {
+        asio_coro::enable_udp_gro(socket);
+      }
+
+      std::vector<asio_coro::datagram> datagrams;
+      while (true) {
+        datagrams.clear();
+        if ((co_await asio_coro::async_receive_batch(socket, pool, datagrams)).first ||
+            (co_await asio_coro::async_send_batch(socket, datagrams)).first) {
+          break;
+        }
+      }
+    }
+  });
+
+  context.run();
+  std::_Exit(0);
+}
+
+/// Returns the amount of packets the datagram consists of.
+std::size_t packets_count(const asio_coro::datagram &datagram) {
+  return datagram.segment_size ? (datagram.data.size() + datagram.segment_size - 1) / datagram.segment_size : 1;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fmt::print(stderr, "usage: {} single|batch|gso [packets=1000000] [in_flight=256] [packet_size=64]\n", argv[0]);
+    return 1;
+  }
+
+  const std::string_view mode = argv[1];
+  const auto packets = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1000000ul;
+  const auto in_flight = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 256ul;
+  const auto packet_size = argc > 4 ? std::strtoul(argv[4], nullptr, 10) : 64ul;
+  if (mode != "single" && mode != "batch" && mode != "gso") {
+    fmt::print(stderr, "unknown mode {}\n", mode);
+    return 1;
+  }
+
+  boost::asio::io_context context;
+  boost::asio::ip::udp::socket server_socket(context, {boost::asio::ip::address_v4::loopback(), 0});
+  const auto server_endpoint = server_socket.local_endpoint();
+
+  const auto child = fork();
+  if (child == 0) {
+    run_server(server_socket.native_handle(), mode);
+  }
+
+  server_socket.close();
+  boost::asio::ip::udp::socket socket(context, {boost::asio::ip::address_v4::loopback(), 0});
+  const auto gso = mode == "gso";
+  if (gso) {
+    asio_coro::enable_udp_gro(socket);
+  }
+
+  asio_coro::buffer_pool pool(65536, 64);
+  std::size_t sent = 0;
+  std::size_t echoed = 0;
+  std::chrono::steady_clock::time_point started_at;
+  std::chrono::steady_clock::time_point finished_at;
+
+  /// Appends the datagrams carrying the specified amount of packets, a train of segments each if GSO is used.
+  const auto make_datagrams = [&](std::vector<asio_coro::datagram> &datagrams, std::size_t count) {
+    while (count != 0) {
+      const auto segments = gso ? std::min(count, max_segments) : 1;
+      auto buffer = pool.acquire();
+      std::fill(buffer.data(), buffer.data() + packet_size * segments, 'u');
+      buffer.resize(packet_size * segments);
+      datagrams.push_back({std::move(buffer), server_endpoint,
+                           static_cast<std::uint16_t>(segments > 1 ? packet_size : 0)});
+      count -= segments;
+    }
+  };
+
+  boost::asio::steady_timer watchdog(context);
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    std::vector<asio_coro::datagram> datagrams;
+    make_datagrams(datagrams, std::min(in_flight, packets));
+    sent += std::min(in_flight, packets);
+    started_at = std::chrono::steady_clock::now();
+
+    while (echoed != packets) {
+      if ((co_await asio_coro::async_send_batch(socket, datagrams)).first) {
+        break;
+      }
+
+      datagrams.clear();
+      const auto [error, count] = co_await asio_coro::async_receive_batch(socket, pool, datagrams);
+      if (error) {
+        break;
+      }
+
+      std::size_t received_packets = 0;
+      for (const auto &datagram : datagrams) {
+        received_packets += packets_count(datagram);
+      }
+
+      echoed += received_packets;
+      finished_at = std::chrono::steady_clock::now();
+
+      const auto next = std::min(received_packets, packets - sent);
+      sent += next;
+      datagrams.clear();
+      make_datagrams(datagrams, next);
+    }
+
+    watchdog.cancel();
+  });
+
+  // Stops the benchmark if nothing has been echoed for a second, which happens if all the packets in flight are lost.
+  std::size_t last_echoed = 0;
+  std::function<void(const boost::system::error_code &)> check = [&](const boost::system::error_code &error) {
+    if (error) {
+      return;
+    }
+
+    if (echoed == last_echoed) {
+      socket.close();
+      return;
+    }
+
+    last_echoed = echoed;
+    watchdog.expires_after(std::chrono::seconds(1));
+    watchdog.async_wait(check);
+  };
+  watchdog.expires_after(std::chrono::seconds(1));
+  watchdog.async_wait(check);
+
+  context.run();
+  ::kill(child, SIGKILL);
+  waitpid(child, nullptr, 0);
+
+  const auto seconds = std::chrono::duration<double>(finished_at - started_at).count();
+  fmt::print("{{\"mode\": \"{}\", \"packets\": {}, \"echoed\": {}, \"in_flight\": {}, \"packet_size\": {}, "
+             "\"seconds\": {:.3f}, \"packets_per_second\": {:.0f}}}\n",
+             mode, packets, echoed, in_flight, packet_size, seconds, echoed / seconds);
+
+  return 0;
+}
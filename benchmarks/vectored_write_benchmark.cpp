@@ -0,0 +1,129 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_connect.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/buffer_sequence.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <fmt/format.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+// Compares the throughput of writing small messages, each of which consists of a header and a body kept in separate
+// buffers, by copying them into one contiguous buffer, by writing the header and the body with two writes, and by
+// writing both at once with a gather write of a make_buffers sequence. The messages are written over a loopback TCP
+// connection with Nagle's algorithm disabled, and a reader coroutine drains them on the same thread.
+
+namespace {
+struct message_header {
+  std::uint32_t type;
+  std::uint32_t size;
+  std::uint64_t id;
+};
+
+asio_coro::task<void> write_messages(boost::asio::ip::tcp::socket &socket, std::string_view mode,
+                                     std::size_t messages_count, std::size_t body_size) {
+  const std::vector<char> body(body_size, 'b');
+  std::vector<char> message(sizeof(message_header) + body_size);
+
+  for (std::size_t i = 0; i != messages_count; ++i) {
+    const message_header header{1, static_cast<std::uint32_t>(body_size), i};
+
+    const auto header_buffer = boost::asio::buffer(&header, sizeof(header));
+    asio_coro::async_write_result result;
+    if (mode == "copy") {
+      std::memcpy(message.data(), &header, sizeof(header));
+      std::memcpy(message.data() + sizeof(header), body.data(), body.size());
+      result = co_await asio_coro::async_write(socket, boost::asio::buffer(message), boost::asio::transfer_all());
+    } else if (mode == "double_write") {
+      result = co_await asio_coro::async_write(socket, header_buffer, boost::asio::transfer_all());
+      if (!result.first) {
+        result = co_await asio_coro::async_write(socket, boost::asio::buffer(body), boost::asio::transfer_all());
+      }
+    } else {
+      result = co_await asio_coro::async_write(socket, asio_coro::make_buffers(header_buffer, body),
+                                               boost::asio::transfer_all());
+    }
+
+    if (const auto error = result.first) {
+      fmt::print(stderr, "failed to write a message: {}\n", error.message());
+      co_return;
+    }
+  }
+}
+
+asio_coro::task<void> read_messages(boost::asio::ip::tcp::socket &socket, std::size_t total_size) {
+  std::vector<char> buffer(64 * 1024);
+  while (total_size != 0) {
+    const auto [error, size] = co_await asio_coro::async_read(socket, boost::asio::buffer(buffer));
+    if (error) {
+      fmt::print(stderr, "failed to read messages: {}\n", error.message());
+      co_return;
+    }
+
+    total_size -= size;
+  }
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fmt::print(stderr, "usage: {} copy|double_write|vectored [messages=200000] [body_size=64]\n", argv[0]);
+    return 1;
+  }
+
+  const std::string_view mode = argv[1];
+  const auto messages_count = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000ul;
+  const auto body_size = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 64ul;
+  if (mode != "copy" && mode != "double_write" && mode != "vectored") {
+    fmt::print(stderr, "unknown mode {}\n", mode);
+    return 1;
+  }
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  const auto endpoint = acceptor.local_endpoint();
+
+  std::chrono::steady_clock::time_point started_at;
+  std::chrono::steady_clock::time_point finished_at;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket socket(context);
+    if (const auto error = co_await asio_coro::async_accept(acceptor, socket)) {
+      fmt::print(stderr, "failed to accept a connection: {}\n", error.message());
+      co_return;
+    }
+
+    co_await read_messages(socket, messages_count * (sizeof(message_header) + body_size));
+    finished_at = std::chrono::steady_clock::now();
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket socket(context);
+    if (const auto error = co_await asio_coro::async_connect(socket, endpoint)) {
+      fmt::print(stderr, "failed to connect: {}\n", error.message());
+      co_return;
+    }
+
+    socket.set_option(boost::asio::ip::tcp::no_delay(true));
+
+    started_at = std::chrono::steady_clock::now();
+    co_await write_messages(socket, mode, messages_count, body_size);
+  });
+
+  context.run();
+
+  const auto seconds = std::chrono::duration<double>(finished_at - started_at).count();
+  fmt::print("{{\"mode\": \"{}\", \"messages\": {}, \"body_size\": {}, \"seconds\": {:.3f}, "
+             "\"messages_per_second\": {:.0f}}}\n",
+             mode, messages_count, body_size, seconds, messages_count / seconds);
+
+  return 0;
+}
@@ -0,0 +1,128 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/task.hpp"
+#include "asio_coro/zerocopy_sender.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <fmt/format.h>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+
+// Compares sending payloads with regular copying writes against zerocopy_sender. A child process connects to the
+// specified address, or over the loopback interface by default, and discards everything it receives. The server
+// process sends the payload the specified amount of times, and reports the throughput along with the CPU time it
+// spent, as a percentage of the wall time, and the amount of zerocopy sends the kernel has copied anyway, which are
+// all of them on the loopback interface.
+
+namespace {
+/// Receives and discards the data until the server closes the connection.
+[[noreturn]] void run_client(const boost::asio::ip::tcp::endpoint &endpoint) {
+  boost::asio::io_context context;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket socket(context);
+    socket.connect(endpoint);
+
+    const auto buffer = std::make_unique<char[]>(1 << 20);
+    while (true) {
+      const auto [error, size] = co_await asio_coro::async_read(socket, boost::asio::buffer(buffer.get(), 1 << 20));
+      if (error) {
+        break;
+      }
+    }
+  });
+
+  context.run();
+  std::_Exit(0);
+}
+
+/// Returns the CPU time the process has spent in user and kernel mode, in seconds.
+double cpu_seconds() {
+  rusage usage{};
+  ::getrusage(RUSAGE_SELF, &usage);
+  const auto to_seconds = [](const timeval &time) { return time.tv_sec + time.tv_usec / 1e6; };
+  return to_seconds(usage.ru_utime) + to_seconds(usage.ru_stime);
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    fmt::print(stderr, "usage: {} copy|zerocopy [payload_kb=1024] [payloads=2048] [address=127.0.0.1]\n", argv[0]);
+    return 1;
+  }
+
+  const std::string_view mode = argv[1];
+  const auto payload_size = (argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1024ul) << 10;
+  const auto payloads = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 2048ul;
+  const auto address = boost::asio::ip::make_address(argc > 4 ? argv[4] : "127.0.0.1");
+  if (mode != "copy" && mode != "zerocopy") {
+    fmt::print(stderr, "unknown mode {}\n", mode);
+    return 1;
+  }
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {address, 0});
+  const auto endpoint = acceptor.local_endpoint();
+
+  const auto child = fork();
+  if (child == 0) {
+    acceptor.close();
+    run_client(endpoint);
+  }
+
+  std::string payload(payload_size, 'z');
+  double seconds = 0;
+  double cpu = 0;
+  std::uint64_t zerocopy_sends = 0;
+  std::uint64_t copied_sends = 0;
+  std::size_t failures = 0;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket socket(context);
+    if (const auto error = co_await asio_coro::async_accept(acceptor, socket)) {
+      fmt::print(stderr, "failed to accept a connection: {}\n", error.message());
+      co_return;
+    }
+
+    using sender_type = asio_coro::zerocopy_sender<boost::asio::ip::tcp::socket>;
+    sender_type sender(socket,
+                       mode == "zerocopy" ? sender_type::default_threshold : std::numeric_limits<std::size_t>::max());
+    const auto started_at = std::chrono::steady_clock::now();
+    const auto started_cpu = cpu_seconds();
+    for (std::size_t i = 0; i != payloads; ++i) {
+      const auto [error, size] = co_await sender.async_send(boost::asio::buffer(payload));
+      if (error) {
+        fmt::print(stderr, "failed to send the payload: {}\n", error.message());
+        ++failures;
+        break;
+      }
+    }
+
+    co_await sender.async_flush();
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_at).count();
+    cpu = cpu_seconds() - started_cpu;
+    zerocopy_sends = sender.zerocopy_sends();
+    copied_sends = sender.copied_sends();
+  });
+
+  context.run();
+  waitpid(child, nullptr, 0);
+
+  const auto bytes = static_cast<double>(payloads * payload_size);
+  fmt::print("{{\"mode\": \"{}\", \"payload_size\": {}, \"payloads\": {}, \"seconds\": {:.3f}, "
+             "\"gigabytes_per_second\": {:.2f}, \"cpu_percent\": {:.1f}, \"zerocopy_sends\": {}, "
+             "\"copied_sends\": {}, \"failures\": {}}}\n",
+             mode, payload_size, payloads, seconds, bytes / seconds / (1 << 30), cpu / seconds * 100, zerocopy_sends,
+             copied_sends, failures);
+
+  return failures == 0 ? 0 : 1;
+}
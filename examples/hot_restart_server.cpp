@@ -0,0 +1,120 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/hot_restart.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+
+#include <fmt/format.h>
+
+#include <unistd.h>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Run the server, then run it once again with the same control socket path: the new process takes the listening
+// socket over, and the old one stops accepting connections and exits once its connections are closed.
+
+void start_echo_coroutine(boost::asio::io_context &context, boost::asio::ip::tcp::socket socket) {
+  auto connection = std::make_shared<boost::asio::ip::tcp::socket>(std::move(socket));
+  asio_coro::spawn_coroutine(context, [connection]() -> asio_coro::task<void> {
+    std::array<char, 4096> data;
+    while (true) {
+      const auto [read_error, read_size] = co_await asio_coro::async_read(*connection, boost::asio::buffer(data));
+      if (read_error) {
+        break;
+      }
+
+      const auto [write_error, write_size] =
+          co_await asio_coro::async_write(*connection, boost::asio::buffer(data.data(), read_size));
+      if (write_error) {
+        break;
+      }
+    }
+  });
+}
+
+void start_accept_coroutine(boost::asio::io_context &context, boost::asio::ip::tcp::acceptor &acceptor) {
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    fmt::print("[{}] accepting connections on port {}\n", ::getpid(), acceptor.local_endpoint().port());
+    while (true) {
+      boost::asio::ip::tcp::socket socket(context);
+      const auto error = co_await asio_coro::async_accept(acceptor, socket);
+      if (error) {
+        fmt::print("[{}] stopped accepting connections: {}\n", ::getpid(), error.message());
+        break;
+      }
+
+      start_echo_coroutine(context, std::move(socket));
+    }
+  });
+}
+
+void start_hand_over_coroutine(boost::asio::io_context &context, const std::string &control_path,
+                               std::vector<boost::asio::ip::tcp::acceptor> &acceptors) {
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    // The control socket is bound anew, since the previous process doesn't need it anymore.
+    ::unlink(control_path.c_str());
+    boost::asio::local::stream_protocol::acceptor control(context, control_path);
+
+    boost::asio::local::stream_protocol::socket successor(context);
+    const auto accept_error = co_await asio_coro::async_accept(control, successor);
+    if (accept_error) {
+      fmt::print("[{}] failed to accept a successor: {}\n", ::getpid(), accept_error.message());
+      co_return;
+    }
+
+    const auto [error, size] = co_await asio_coro::async_hand_over(successor, acceptors);
+    if (error) {
+      fmt::print("[{}] failed to hand the listening sockets over: {}\n", ::getpid(), error.message());
+      co_return;
+    }
+
+    // The successor accepts the new connections from now on, and the established ones are still served here.
+    fmt::print("[{}] handed the listening sockets over\n", ::getpid());
+    for (auto &acceptor : acceptors) {
+      acceptor.close();
+    }
+  });
+}
+
+int main(int argc, char **argv) {
+  const std::string control_path = argc > 1 ? argv[1] : "/tmp/asio_coro_hot_restart.sock";
+
+  boost::asio::io_context context;
+  std::vector<boost::asio::ip::tcp::acceptor> acceptors;
+
+  // The listening sockets are taken over from the running process if there is one.
+  boost::asio::local::stream_protocol::socket predecessor(context);
+  boost::system::error_code connect_error;
+  predecessor.connect(control_path, connect_error);
+  if (!connect_error) {
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      const auto [error, count] = co_await asio_coro::async_take_over(predecessor, acceptors);
+      if (error) {
+        fmt::print("[{}] failed to take the listening sockets over: {}\n", ::getpid(), error.message());
+      }
+    });
+    context.run();
+    context.restart();
+  }
+
+  if (acceptors.empty()) {
+    acceptors.emplace_back(context, boost::asio::ip::tcp::endpoint(boost::asio::ip::make_address_v4(0u), 65402));
+  }
+
+  for (auto &acceptor : acceptors) {
+    start_accept_coroutine(context, acceptor);
+  }
+
+  start_hand_over_coroutine(context, control_path, acceptors);
+
+  context.run();
+
+  return 0;
+}
@@ -0,0 +1,319 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_wait_signal.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/buffered_stream.hpp"
+#include "asio_coro/detail/find_delimiter.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/signal_set.hpp>
+
+#include <fmt/format.h>
+
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// An HTTP/1.1 keep-alive server meant as a realistic load target, e.g. for asio_coro_loadgen or wrk.
+//
+// Every thread runs its own io_context with its own SO_REUSEPORT acceptor, so the kernel spreads connections over the
+// threads and nothing is shared between them. A connection reads requests through a buffered_stream, whose every read
+// fills the whole buffer, and whose delimiter scan, like the scan of the request and header lines, is vectorized with
+// SSE2. Pipelined requests already buffered are served as one batch: their responses are built in a per-connection
+// arena and written with one gathered write, with the bodies referring to the static data or to the read buffer.
+//
+//   GET /          responds with "Hello, World!"
+//   POST /echo     responds with the request body
+//
+// Usage: http_server [port=8080] [threads=hardware concurrency]
+
+namespace {
+/// The maximum amount of requests served with one gathered write, two buffers each.
+constexpr std::size_t max_batch_size = 32;
+
+/// The maximum size of a request, including the head and the body.
+constexpr std::size_t max_request_size = 1024 * 1024;
+
+constexpr std::string_view hello_body = "Hello, World!";
+constexpr std::string_view not_found_body = "Not Found";
+
+using reuse_port = boost::asio::detail::socket_option::boolean<SOL_SOCKET, SO_REUSEPORT>;
+
+struct http_request {
+  std::string_view method;
+  std::string_view target;
+  std::size_t head_size = 0;
+  std::size_t content_length = 0;
+  bool keep_alive = true;
+};
+
+bool iequals(std::string_view left, std::string_view right) noexcept {
+  return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin(), [](char l, char r) {
+           return (l | 0x20) == (r | 0x20);
+         });
+}
+
+std::string_view trim(std::string_view value) noexcept {
+  while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) {
+    value.remove_prefix(1);
+  }
+
+  while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) {
+    value.remove_suffix(1);
+  }
+
+  return value;
+}
+
+/// Parses the head of a request, i.e. the request line and the header lines up to and including the empty line.
+/// Returns false if the head is malformed or uses what the server doesn't support, e.g. a chunked body.
+bool parse_head(std::string_view head, http_request &request) {
+  request.head_size = head.size();
+
+  auto line_end = asio_coro::detail::find_delimiter(head, "\r\n");
+  const auto line = head.substr(0, line_end);
+  const auto method_end = line.find(' ');
+  const auto target_end = line.rfind(' ');
+  if (method_end == std::string_view::npos || method_end == target_end) {
+    return false;
+  }
+
+  request.method = line.substr(0, method_end);
+  request.target = line.substr(method_end + 1, target_end - method_end - 1);
+  const auto version = line.substr(target_end + 1);
+  if (version == "HTTP/1.0") {
+    request.keep_alive = false;
+  } else if (version != "HTTP/1.1") {
+    return false;
+  }
+
+  head.remove_prefix(line_end + 2);
+  while ((line_end = asio_coro::detail::find_delimiter(head, "\r\n")) != 0) {
+    const auto header = head.substr(0, line_end);
+    const auto colon = header.find(':');
+    if (colon == std::string_view::npos) {
+      return false;
+    }
+
+    const auto name = header.substr(0, colon);
+    const auto value = trim(header.substr(colon + 1));
+    if (iequals(name, "content-length")) {
+      const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), request.content_length);
+      if (error != std::errc() || end != value.data() + value.size()) {
+        return false;
+      }
+    } else if (iequals(name, "connection")) {
+      if (iequals(value, "close")) {
+        request.keep_alive = false;
+      } else if (iequals(value, "keep-alive")) {
+        request.keep_alive = true;
+      }
+    } else if (iequals(name, "transfer-encoding")) {
+      return false;
+    }
+
+    head.remove_prefix(line_end + 2);
+  }
+
+  return true;
+}
+
+/// Returns whether the request is larger than the maximum request size. Checked before the request size is computed,
+/// which a huge Content-Length would overflow.
+bool too_large(const http_request &request) noexcept {
+  return request.head_size > max_request_size || request.content_length > max_request_size - request.head_size;
+}
+
+/// Builds a response in the arena, and appends its buffers to the batch.
+void append_response(std::pmr::vector<boost::asio::const_buffer> &buffers, std::pmr::memory_resource &arena,
+                     std::string_view status, std::string_view body, bool keep_alive) {
+  auto &head = *std::pmr::polymorphic_allocator<std::pmr::string>(&arena).new_object<std::pmr::string>();
+  fmt::format_to(std::back_inserter(head),
+                 "HTTP/1.1 {}\r\nServer: asio_coro\r\nContent-Type: text/plain\r\nContent-Length: {}\r\n{}\r\n", status,
+                 body.size(), keep_alive ? "" : "Connection: close\r\n");
+
+  buffers.emplace_back(head.data(), head.size());
+  if (!body.empty()) {
+    buffers.emplace_back(body.data(), body.size());
+  }
+}
+
+/// Serves the request, and returns whether the connection is kept alive. The body is the view of the read buffer.
+bool serve_request(const http_request &request, std::string_view body,
+                   std::pmr::vector<boost::asio::const_buffer> &buffers, std::pmr::memory_resource &arena) {
+  if (request.method == "GET" && request.target == "/") {
+    append_response(buffers, arena, "200 OK", hello_body, request.keep_alive);
+  } else if (request.method == "POST" && request.target == "/echo") {
+    append_response(buffers, arena, "200 OK", body, request.keep_alive);
+  } else {
+    append_response(buffers, arena, "404 Not Found", not_found_body, request.keep_alive);
+  }
+
+  return request.keep_alive;
+}
+
+asio_coro::task<void> serve_connection(boost::asio::ip::tcp::socket socket) {
+  socket.set_option(boost::asio::ip::tcp::no_delay(true));
+  asio_coro::buffered_stream stream(socket, 16 * 1024, max_request_size);
+
+  // The responses of a batch are allocated from the arena, which is rewound once they're written, so the requests
+  // served in steady state don't allocate.
+  std::array<std::byte, 16 * 1024> arena_storage;
+  std::pmr::monotonic_buffer_resource arena(arena_storage.data(), arena_storage.size());
+
+  auto keep_alive = true;
+  while (keep_alive) {
+    // The first request of a batch is awaited, and the pipelined requests following it are taken from the buffer.
+    const auto [error, head] = co_await stream.async_read_until("\r\n\r\n");
+    if (error) {
+      break;
+    }
+
+    std::pmr::vector<boost::asio::const_buffer> buffers(&arena);
+    http_request request;
+    if (!parse_head(head, request)) {
+      append_response(buffers, arena, "400 Bad Request", {}, false);
+      keep_alive = false;
+    } else if (too_large(request)) {
+      append_response(buffers, arena, "413 Content Too Large", {}, false);
+      keep_alive = false;
+    } else if (request.head_size + request.content_length > stream.size()) {
+      const auto [body_error, message] = co_await stream.async_read_exactly(request.head_size + request.content_length);
+      if (body_error == boost::asio::error::not_found) {
+        append_response(buffers, arena, "413 Content Too Large", {}, false);
+        keep_alive = false;
+      } else if (body_error) {
+        break;
+      } else {
+        // The read may have moved the buffered data, so the head is parsed again.
+        parse_head(message.substr(0, request.head_size), request);
+      }
+    }
+
+    while (keep_alive) {
+      const auto request_size = request.head_size + request.content_length;
+      keep_alive = serve_request(request, stream.data().substr(request.head_size, request.content_length), buffers,
+                                 arena);
+      // The consumed data stays in place until the next read, so the views of the responses remain valid.
+      stream.consume(request_size);
+      if (!keep_alive || buffers.size() >= max_batch_size * 2) {
+        break;
+      }
+
+      const auto data = stream.data();
+      const auto head_end = asio_coro::detail::find_delimiter(data, "\r\n\r\n");
+      if (head_end == std::string_view::npos) {
+        break;
+      }
+
+      request = http_request();
+      if (!parse_head(data.substr(0, head_end + 4), request)) {
+        append_response(buffers, arena, "400 Bad Request", {}, false);
+        keep_alive = false;
+        break;
+      }
+
+      if (too_large(request)) {
+        append_response(buffers, arena, "413 Content Too Large", {}, false);
+        keep_alive = false;
+        break;
+      }
+
+      if (request.head_size + request.content_length > data.size()) {
+        // The body is incomplete, so the request starts the next batch.
+        break;
+      }
+    }
+
+    const auto [write_error, write_size] =
+        co_await asio_coro::async_write(socket, buffers, boost::asio::transfer_all());
+    if (write_error) {
+      break;
+    }
+
+    buffers.clear();
+    arena.release();
+  }
+}
+
+void start_accept_coroutine(boost::asio::io_context &context, unsigned short port) {
+  asio_coro::spawn_coroutine(context, [&context, port]() -> asio_coro::task<void> {
+    boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::make_address_v4(0u), port);
+    boost::asio::ip::tcp::acceptor acceptor(context);
+    acceptor.open(endpoint.protocol());
+    acceptor.set_option(boost::asio::socket_base::reuse_address(true));
+    acceptor.set_option(reuse_port(true));
+    acceptor.bind(endpoint);
+    acceptor.listen(boost::asio::socket_base::max_listen_connections);
+
+    while (true) {
+      boost::asio::ip::tcp::socket socket(context);
+      const auto error = co_await asio_coro::async_accept(acceptor, socket);
+      if (error == boost::asio::error::operation_aborted) {
+        break;
+      }
+
+      if (error) {
+        continue;
+      }
+
+      auto connection = std::make_shared<boost::asio::ip::tcp::socket>(std::move(socket));
+      asio_coro::spawn_coroutine(context, [connection]() { return serve_connection(std::move(*connection)); });
+    }
+  });
+}
+
+void start_shutdown_awaiter_coroutine(boost::asio::io_context &context, std::deque<boost::asio::io_context> &contexts) {
+  asio_coro::spawn_coroutine(context, [&]() mutable -> asio_coro::task<void> {
+    boost::asio::signal_set sigset(context, SIGTERM, SIGINT);
+    const auto [error, signal] = co_await asio_coro::async_wait_signal(sigset);
+    if (!error) {
+      fmt::print("signal {} received, stopping the server\n", signal);
+    }
+
+    for (auto &item : contexts) {
+      item.stop();
+    }
+  });
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  const auto port = static_cast<unsigned short>(argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 8080);
+  const auto threads_count =
+      argc > 2 ? std::strtoul(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+
+  // Every io_context is run by one thread only, which the concurrency hint lets it know.
+  std::deque<boost::asio::io_context> contexts;
+  for (std::size_t i = 0; i != threads_count; ++i) {
+    start_accept_coroutine(contexts.emplace_back(1), port);
+  }
+
+  start_shutdown_awaiter_coroutine(contexts.front(), contexts);
+  fmt::print("serving HTTP on port {} with {} threads\n", port, threads_count);
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < contexts.size(); ++i) {
+    threads.emplace_back([&context = contexts[i]]() { context.run(); });
+  }
+
+  contexts.front().run();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  return 0;
+}
@@ -1,9 +1,10 @@
 #include "asio_coro/async_accept.hpp"
 #include "asio_coro/async_read.hpp"
-#include "asio_coro/async_wait.hpp"
 #include "asio_coro/async_wait_signal.hpp"
 #include "asio_coro/async_write.hpp"
+#include "asio_coro/buffer_pool.hpp"
 #include "asio_coro/task.hpp"
+#include "asio_coro/timer_wheel.hpp"
 
 #include <boost/asio.hpp>
 #include <boost/asio/io_context.hpp>
@@ -11,10 +12,12 @@
 
 #include <fmt/format.h>
 
-#include <array>
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <memory>
+#include <thread>
+#include <vector>
 
 template <> struct fmt::formatter<boost::asio::ip::tcp::endpoint> {
   constexpr auto parse(format_parse_context &ctx) { return ctx.begin(); }
@@ -26,48 +29,37 @@ template <> struct fmt::formatter<boost::asio::ip::tcp::endpoint> {
 
 class server : public std::enable_shared_from_this<server> {
 public:
-  explicit server(boost::asio::ip::tcp::socket socket) : _socket(std::move(socket)) {}
+  explicit server(boost::asio::ip::tcp::socket socket, asio_coro::timer_wheel &timer_wheel,
+                  asio_coro::buffer_pool &buffer_pool)
+      : _socket(std::move(socket)), _idle_timer(timer_wheel, std::chrono::seconds(5)), _buffer_pool(buffer_pool) {}
 
   void run(boost::asio::io_context &context) {
-    _last_active_time = std::chrono::steady_clock::now();
+    // Both connection coroutines access the socket and the idle timer, so they share the same strand.
+    auto strand = boost::asio::make_strand(context);
 
-    auto weak_self = weak_from_this();
-    asio_coro::spawn_coroutine(context, [&context, weak_self = std::move(weak_self)]() -> asio_coro::task<void> {
-      boost::asio::steady_timer timer(context);
-
-      while (true) {
-        timer.expires_from_now(std::chrono::seconds(1));
-        const auto error = co_await asio_coro::async_wait(timer);
-        if (error) {
-          break;
-        }
-
-        if (const auto self = weak_self.lock(); self) {
-          if (std::chrono::steady_clock::now() - self->_last_active_time > std::chrono::seconds(5)) {
-            const auto remote_endpoint = self->_socket.remote_endpoint();
-            fmt::print("closing connection {} die to inactivity timeout\n", remote_endpoint);
+    auto self = shared_from_this();
+    asio_coro::spawn_coroutine(strand, [self]() -> asio_coro::task<void> {
+      const auto error = co_await self->_idle_timer.async_wait();
+      if (error) {
+        co_return;
+      }
 
-            boost::system::error_code error;
-            self->_socket.close(error);
+      const auto remote_endpoint = self->_socket.remote_endpoint();
+      fmt::print("closing connection {} die to inactivity timeout\n", remote_endpoint);
 
-            if (error) {
-              fmt::print("failed to close connection {}: {}\n", remote_endpoint, error.message());
-              break;
-            }
-          }
-        } else {
-          break;
-        }
+      boost::system::error_code close_error;
+      self->_socket.close(close_error);
+      if (close_error) {
+        fmt::print("failed to close connection {}: {}\n", remote_endpoint, close_error.message());
       }
     });
 
-    auto self = shared_from_this();
-    asio_coro::spawn_coroutine(context, [self = std::move(self)]() -> asio_coro::task<void> {
+    asio_coro::spawn_coroutine(strand, [self = std::move(self)]() -> asio_coro::task<void> {
       const auto remote_endpoint = self->_socket.remote_endpoint();
       while (true) {
-        std::array<char, 1024> buffer;
-        const auto [read_error, read_size] =
-            co_await asio_coro::async_read(self->_socket, boost::asio::mutable_buffer(buffer.data(), buffer.size()));
+        // The read buffer is taken from the pool only once the data arrives, so idle connections hold no buffers.
+        const auto [read_error, buffer, read_size] =
+            co_await asio_coro::async_read_pooled(self->_socket, self->_buffer_pool);
         if (read_error) {
           fmt::print("failed to read data from {}: {}\n", remote_endpoint, read_error.message());
           break;
@@ -75,10 +67,11 @@ public:
 
         fmt::print("read {} bytes from {}\n", read_size, remote_endpoint);
 
-        self->_last_active_time = std::chrono::steady_clock::now();
+        self->_idle_timer.touch();
 
-        const auto [write_error, write_size] = co_await asio_coro::async_write(
-            self->_socket, boost::asio::buffer(buffer.data(), read_size), boost::asio::transfer_exactly(read_size));
+        // The pooled buffer is resized to the amount of data read, so it's written back as is.
+        const auto [write_error, write_size] =
+            co_await asio_coro::async_write(self->_socket, buffer, boost::asio::transfer_exactly(read_size));
         if (write_error) {
           fmt::print("failed to write data to {}: {}\n", remote_endpoint, write_error.message());
           break;
@@ -86,20 +79,26 @@ public:
 
         fmt::print("wrote {} bytes to {}\n", write_size, remote_endpoint);
       }
+
+      // Release the inactivity watchdog, so the server is destroyed.
+      self->_idle_timer.cancel();
     });
   }
 
 private:
   boost::asio::ip::tcp::socket _socket;
-  std::chrono::steady_clock::time_point _last_active_time;
+  asio_coro::timer_wheel::idle_timer _idle_timer;
+  asio_coro::buffer_pool &_buffer_pool;
 };
 
-void start_server_coroutine(boost::asio::io_context &context, boost::asio::ip::tcp::socket socket) {
-  const auto server_instance = std::make_shared<server>(std::move(socket));
+void start_server_coroutine(boost::asio::io_context &context, asio_coro::timer_wheel &timer_wheel,
+                            asio_coro::buffer_pool &buffer_pool, boost::asio::ip::tcp::socket socket) {
+  const auto server_instance = std::make_shared<server>(std::move(socket), timer_wheel, buffer_pool);
   server_instance->run(context);
 }
 
-void start_accept_connections_coroutine(boost::asio::io_context &context) {
+void start_accept_connections_coroutine(boost::asio::io_context &context, asio_coro::timer_wheel &timer_wheel,
+                                        asio_coro::buffer_pool &buffer_pool) {
   asio_coro::spawn_coroutine(context, [&]() mutable -> asio_coro::task<void> {
     boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::make_address_v4(0u), 65400);
     boost::asio::ip::tcp::acceptor acceptor(context);
@@ -119,7 +118,7 @@ void start_accept_connections_coroutine(boost::asio::io_context &context) {
 
       fmt::print("an incoming connection accepted from {}\n", socket.remote_endpoint());
 
-      start_server_coroutine(context, std::move(socket));
+      start_server_coroutine(context, timer_wheel, buffer_pool, std::move(socket));
     }
   });
 }
@@ -141,10 +140,24 @@ void start_shutdown_awaiter_coroutine(boost::asio::io_context &context) {
 
 int main() {
   boost::asio::io_context context;
-  start_accept_connections_coroutine(context);
+
+  // All the connection inactivity timeouts are served by a single timer wheel.
+  asio_coro::timer_wheel timer_wheel(context, std::chrono::seconds(1));
+  asio_coro::buffer_pool buffer_pool(1024);
+
+  start_accept_connections_coroutine(context, timer_wheel, buffer_pool);
   start_shutdown_awaiter_coroutine(context);
 
+  // Every connection runs on its own strand, so the io_context is run on all the hardware threads.
+  std::vector<std::thread> threads;
+  for (auto i = 1u; i < std::max(1u, std::thread::hardware_concurrency()); ++i) {
+    threads.emplace_back([&context]() { context.run(); });
+  }
+
   context.run();
+  for (auto &thread : threads) {
+    thread.join();
+  }
 
   return 0;
 }
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "asio_coro/async_datagram.hpp"
+#include "asio_coro/async_wait_signal.hpp"
+#include "asio_coro/buffer_pool.hpp"
+#include "asio_coro/task.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/asio/signal_set.hpp>
+
+#include <fmt/format.h>
+
+#include <vector>
+
+void start_echo_coroutine(boost::asio::io_context &context, asio_coro::buffer_pool &buffer_pool) {
+  asio_coro::spawn_coroutine(context, [&]() mutable -> asio_coro::task<void> {
+    boost::asio::ip::udp::socket socket(context, {boost::asio::ip::make_address_v4(0u), 65401});
+    fmt::print("listening for datagrams on port {}\n", socket.local_endpoint().port());
+
+    // Datagrams of the same flow may be coalesced into one, and they're sent back the same way, segmented by the
+    // kernel.
+    if (const auto error = asio_coro::enable_udp_gro(socket)) {
+      fmt::print("UDP_GRO is not available: {}\n", error.message());
+    }
+
+    std::vector<asio_coro::datagram> datagrams;
+    while (true) {
+      // Every received datagram carries the endpoint it's received from, so the batch is sent back as is.
+      datagrams.clear();
+      const auto [receive_error, received_count] =
+          co_await asio_coro::async_receive_batch(socket, buffer_pool, datagrams);
+      if (receive_error) {
+        fmt::print("failed to receive datagrams: {}\n", receive_error.message());
+        break;
+      }
+
+      const auto [send_error, sent_count] = co_await asio_coro::async_send_batch(socket, datagrams);
+      if (send_error) {
+        fmt::print("failed to echo {} of {} datagrams: {}\n", received_count - sent_count, received_count,
+                   send_error.message());
+      }
+    }
+  });
+}
+
+void start_shutdown_awaiter_coroutine(boost::asio::io_context &context) {
+  asio_coro::spawn_coroutine(context, [&]() mutable -> asio_coro::task<void> {
+    boost::asio::signal_set sigset(context, SIGTERM, SIGINT);
+    const auto [error, signal] = co_await asio_coro::async_wait_signal(sigset);
+
+    if (error) {
+      fmt::print("failed to wait for a signal: {}\n", error.message());
+    } else {
+      fmt::print("signal {} received, stopping the io context\n", signal);
+    }
+
+    context.stop();
+  });
+}
+
+int main() {
+  boost::asio::io_context context;
+
+  // Coalesced datagrams take up to 64 KiB.
+  asio_coro::buffer_pool buffer_pool(65536, 64);
+
+  start_echo_coroutine(context, buffer_pool);
+  start_shutdown_awaiter_coroutine(context);
+
+  context.run();
+
+  return 0;
+}
@@ -5,12 +5,36 @@
 #include "async_connect.hpp"
 #include "async_mutex.hpp"
 #include "async_read.hpp"
+#include "async_resolve.hpp"
 #include "async_wait.hpp"
+#include "async_wait_ready.hpp"
 #include "async_wait_signal.hpp"
 #include "async_write.hpp"
 #include "boost_future.hpp"
+#include "buffer_pool.hpp"
+#include "buffer_sequence.hpp"
+#include "buffered_stream.hpp"
+#include "coalescing_writer.hpp"
+#include "connection_pool.hpp"
 #include "dispatch.hpp"
+#include "file.hpp"
+#include "framed_stream.hpp"
+#include "io_uring.hpp"
 #include "post.hpp"
+#include "sleep.hpp"
 #include "task.hpp"
+#include "timer_wheel.hpp"
+
+// The awaitables built on Linux-only system calls, e.g. sendmmsg, sendfile, splice, eventfd, memfd_create and
+// MSG_ZEROCOPY.
+#if defined(__linux__)
+#include "async_datagram.hpp"
+#include "async_send_fds.hpp"
+#include "async_sendfile.hpp"
+#include "eventfd_notifier.hpp"
+#include "hot_restart.hpp"
+#include "mirrored_buffer.hpp"
+#include "zerocopy_sender.hpp"
+#endif
 
 #endif // ASIO_CORO_EXTENSIONS_ASIO_CORO_HPP
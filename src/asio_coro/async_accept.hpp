@@ -2,10 +2,20 @@
 #define ASIO_CORO_EXTENSIONS_ASYNC_ACCEPT_HPP
 
 #include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
 
+#include <boost/asio/bind_executor.hpp>
 #include <boost/scope_exit.hpp>
 #include <boost/system/error_code.hpp>
 
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
 namespace asio_coro {
 /// Returns an awaitable that suspends the awaiting coroutine upon the either a new incoming connection is accepted or
 /// an error is occurred during the connection establishment.
@@ -23,25 +33,152 @@ template <class Acceptor, class Socket> auto async_accept(Acceptor &acceptor, So
 
     boost::system::error_code await_resume() const noexcept { return _result; }
 
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
     void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _acceptor);
       detail::coroutine_holder<> holder(continuation);
       BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
 
-      _acceptor.async_accept(_socket,
-                             [this, holder = std::move(holder)](const boost::system::error_code &error) mutable {
-                               _result = error;
-                               holder.release().resume();
-                             });
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error) mutable {
+        _result = error;
+        holder.release().resume();
+      };
+      _acceptor.async_accept(_socket, boost::asio::bind_executor(std::move(executor), std::move(handler)));
     }
 
   private:
     Acceptor &_acceptor;
     Socket &_socket;
     boost::system::error_code _result;
+    detail::executor_type _executor;
   };
 
   return awaitable(acceptor, socket);
 }
+
+/// The result of async_accept_batch: the error occurred if no connection has been accepted, and the accepted sockets.
+template <class Acceptor>
+using async_accept_batch_result =
+    std::pair<boost::system::error_code, std::vector<typename Acceptor::protocol_type::socket>>;
+
+/// Returns an awaitable that accepts all the connections pending in the listen backlog of the specified acceptor, up to
+/// the specified amount, and suspends the awaiting coroutine until the acceptor becomes readable only if there are no
+/// pending connections.
+///
+/// Connections are accepted with accept4 until it reports that the backlog is empty, so a burst of connections is
+/// accepted with one reactor wakeup instead of one wakeup per connection. Connections aborted by the peer before they
+/// are accepted are skipped. If accepting fails after some connections have been accepted, the accepted sockets are
+/// returned, and the error is reported by the next call. The acceptor is switched to the non-blocking mode.
+///
+/// The awaitable returns a value of type async_accept_batch_result, the accepted sockets use the acceptor executor.
+///
+/// \param acceptor     A connection acceptor socket.
+/// \param max_count    The maximum amount of connections to accept.
+template <class Acceptor> auto async_accept_batch(Acceptor &acceptor, std::size_t max_count) {
+  class awaitable {
+  public:
+    explicit awaitable(Acceptor &acceptor, std::size_t max_count) noexcept
+        : _acceptor(acceptor), _max_count(max_count) {}
+
+    bool await_ready() { return accept(); }
+
+    async_accept_batch_result<Acceptor> await_resume() noexcept { return std::move(_result); }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      wait(detail::get_executor(_executor, _acceptor), detail::coroutine_holder<>(continuation));
+    }
+
+  private:
+    using socket_type = typename Acceptor::protocol_type::socket;
+
+    Acceptor &_acceptor;
+    std::size_t _max_count;
+    async_accept_batch_result<Acceptor> _result;
+    detail::executor_type _executor;
+
+    /// Accepts the first connection with the acceptor's own operation, then accepts the rest of the pending
+    /// connections. The operation attempts the accept before it's queued, so a connection that has arrived since the
+    /// last accept4 is taken without a trip through the reactor. A connection arriving after that isn't missed
+    /// either: the reactor re-registers the descriptor when the operation is queued, which reports the readiness it
+    /// already has.
+    void wait(detail::executor_type executor, detail::coroutine_holder<> holder) {
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                         socket_type socket) mutable {
+        if (error) {
+          _result.first = error;
+        } else {
+          _result.second.push_back(std::move(socket));
+          accept();
+        }
+
+        holder.release().resume();
+      };
+      _acceptor.async_accept(boost::asio::bind_executor(std::move(executor), std::move(handler)));
+    }
+
+    /// Accepts the pending connections. Returns false if there are none, and true if some connections are accepted or
+    /// an error has occurred.
+    bool accept() {
+      auto &[error, sockets] = _result;
+      _acceptor.native_non_blocking(true, error);
+      if (error) {
+        return true;
+      }
+
+      const auto protocol = _acceptor.local_endpoint(error).protocol();
+      if (error) {
+        return true;
+      }
+
+      while (sockets.size() < _max_count) {
+        const auto fd = ::accept4(_acceptor.native_handle(), nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd == -1) {
+          if (errno == EINTR || errno == ECONNABORTED || errno == EPROTO) {
+            continue;
+          }
+
+          if (errno != EAGAIN && errno != EWOULDBLOCK && sockets.empty()) {
+            error = boost::system::error_code(errno, boost::system::system_category());
+            return true;
+          }
+
+          break;
+        }
+
+        // The descriptor is closed unless the socket takes it over, e.g. if creating the socket throws.
+        bool assigned = false;
+        BOOST_SCOPE_EXIT_ALL(&) {
+          if (!assigned) {
+            ::close(fd);
+          }
+        };
+
+        socket_type socket(_acceptor.get_executor());
+        if (socket.assign(protocol, fd, error)) {
+          if (!sockets.empty()) {
+            error = {};
+          }
+
+          return true;
+        }
+
+        assigned = true;
+        sockets.push_back(std::move(socket));
+      }
+
+      return !sockets.empty() || _max_count == 0;
+    }
+  };
+
+  return awaitable(acceptor, max_count);
+}
 } // namespace asio_coro
 
 #endif // ASIO_CORO_EXTENSIONS_ASYNC_ACCEPT_HPP
@@ -2,11 +2,39 @@
 #define ASIO_CORO_EXTENSIONS_ASYNC_CONNECT_HPP
 
 #include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
 
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
 #include <boost/scope_exit.hpp>
 #include <boost/system/error_code.hpp>
 
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace asio_coro {
+namespace detail {
+/// Checks whether the type is a range of endpoints rather than an endpoint.
+template <class Range, class = void> struct is_endpoint_range : std::false_type {};
+
+template <class Range>
+struct is_endpoint_range<Range, std::void_t<decltype(std::declval<const Range &>().begin()),
+                                            decltype(std::declval<const Range &>().end())>> : std::true_type {};
+} // namespace detail
+
 /// Returns an awaitable that schedules an async socket connect routine and suspends the awaiting coroutine upon either
 /// the connection is established or an error is occurred during the connection establishment.
 ///
@@ -14,7 +42,8 @@ namespace asio_coro {
 ///
 /// \param socket   A socket that connects to the remote peer.
 /// \param endpint  The remote peer endpoint.
-template <class Socket, class Endpoint> auto async_connect(Socket &socket, const Endpoint &endpoint) {
+template <class Socket, class Endpoint, std::enable_if_t<!detail::is_endpoint_range<Endpoint>::value, int> = 0>
+auto async_connect(Socket &socket, const Endpoint &endpoint) {
   class awaitable {
   public:
     explicit awaitable(Socket &socket, const Endpoint &endpoint) : _socket(socket), _endpoint(endpoint) {}
@@ -23,25 +52,340 @@ template <class Socket, class Endpoint> auto async_connect(Socket &socket, const
 
     boost::system::error_code await_resume() const noexcept { return _result; }
 
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
     void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _socket);
       detail::coroutine_holder<> holder(continuation);
       BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
 
-      _socket.async_connect(_endpoint,
-                            [this, holder = std::move(holder)](const boost::system::error_code &error) mutable {
-                              _result = error;
-                              holder.release().resume();
-                            });
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error) mutable {
+        _result = error;
+        holder.release().resume();
+      };
+      _socket.async_connect(_endpoint, boost::asio::bind_executor(std::move(executor), std::move(handler)));
     }
 
   private:
     Socket &_socket;
     Endpoint _endpoint;
     boost::system::error_code _result;
+    detail::executor_type _executor;
   };
 
   return awaitable(socket, endpoint);
 }
+
+/// The result of async_connect over a range of endpoints: the error occurred if no connection has been established, and
+/// the endpoint the socket is connected to.
+template <class Socket>
+using async_connect_result = std::pair<boost::system::error_code, typename Socket::endpoint_type>;
+
+/// Remembers the endpoints connections to which have failed recently, so that connecting to a multi-address peer tries
+/// the endpoints known to work first. The cache is thread-safe, so it may be shared by the coroutines of a process.
+///
+/// \tparam Endpoint  The endpoint type, e.g. boost::asio::ip::tcp::endpoint.
+template <class Endpoint = boost::asio::ip::tcp::endpoint> class endpoint_failure_cache {
+public:
+  using clock_type = std::chrono::steady_clock;
+  using duration = clock_type::duration;
+
+  /// Constructor. Creates an empty cache.
+  ///
+  /// \param penalty    The time an endpoint is deprioritized for after a connection to it has failed.
+  explicit endpoint_failure_cache(duration penalty = std::chrono::seconds(30)) : _penalty(penalty) {}
+
+  endpoint_failure_cache(const endpoint_failure_cache &) = delete;
+
+  endpoint_failure_cache &operator=(const endpoint_failure_cache &) = delete;
+
+  /// Returns the amount of endpoints that have failed, including the ones the penalty of which is over.
+  std::size_t size() const {
+    std::lock_guard lock(_mutex);
+    return _failures.size();
+  }
+
+  /// Returns whether a connection to the endpoint has failed within the penalty time.
+  bool is_failing(const Endpoint &endpoint) const {
+    std::lock_guard lock(_mutex);
+    const auto it = _failures.find(endpoint);
+    return it != _failures.end() && clock_type::now() < it->second;
+  }
+
+  /// Records that a connection to the endpoint has failed.
+  void record_failure(const Endpoint &endpoint) {
+    const auto now = clock_type::now();
+    std::lock_guard lock(_mutex);
+    _failures.insert_or_assign(endpoint, now + _penalty);
+    if (_failures.size() >= _purge_size) {
+      std::erase_if(_failures, [&](const auto &item) { return item.second <= now; });
+      _purge_size = std::max<std::size_t>(64, _failures.size() * 2);
+    }
+  }
+
+  /// Records that a connection to the endpoint has been established, which clears its failure.
+  void record_success(const Endpoint &endpoint) {
+    std::lock_guard lock(_mutex);
+    _failures.erase(endpoint);
+  }
+
+  /// Moves the failing endpoints to the end of the specified range, keeping the relative order of the endpoints
+  /// otherwise. Returns the iterator to the first failing endpoint.
+  template <class Iterator> Iterator deprioritize(Iterator first, Iterator last) const {
+    const auto now = clock_type::now();
+    std::lock_guard lock(_mutex);
+    return std::stable_partition(first, last, [&](const Endpoint &endpoint) {
+      const auto it = _failures.find(endpoint);
+      return it == _failures.end() || it->second <= now;
+    });
+  }
+
+private:
+  mutable std::mutex _mutex;
+  std::map<Endpoint, clock_type::time_point> _failures;
+  std::size_t _purge_size = 64;
+  duration _penalty;
+};
+
+namespace detail {
+/// The delay between the connection attempts recommended by RFC 8305.
+constexpr std::chrono::milliseconds default_attempt_delay(250);
+
+/// Interleaves the endpoints of the specified range by the protocol family, starting with the family of the first
+/// endpoint and keeping the relative order of the endpoints of each family, as RFC 8305 recommends.
+template <class Iterator> void interleave_families(Iterator first, Iterator last) {
+  if (first == last) {
+    return;
+  }
+
+  using endpoint_type = typename std::iterator_traits<Iterator>::value_type;
+  const auto protocol = first->protocol();
+  std::vector<endpoint_type> preferred;
+  std::vector<endpoint_type> others;
+  for (auto it = first; it != last; ++it) {
+    (it->protocol() == protocol ? preferred : others).push_back(*it);
+  }
+
+  auto preferred_it = preferred.begin();
+  auto others_it = others.begin();
+  while (preferred_it != preferred.end() || others_it != others.end()) {
+    if (preferred_it != preferred.end()) {
+      *first++ = *preferred_it++;
+    }
+
+    if (others_it != others.end()) {
+      *first++ = *others_it++;
+    }
+  }
+}
+
+/// Returns the endpoints of the specified range in the order they are tried in: the endpoints failing according to the
+/// cache go last, and the endpoints of each group are interleaved by the protocol family.
+template <class Endpoint, class EndpointRange>
+std::vector<Endpoint> order_endpoints(const EndpointRange &endpoints, const endpoint_failure_cache<Endpoint> *cache) {
+  std::vector<Endpoint> result;
+  for (const auto &endpoint : endpoints) {
+    result.push_back(endpoint);
+  }
+
+  const auto failing = cache ? cache->deprioritize(result.begin(), result.end()) : result.end();
+  interleave_families(result.begin(), failing);
+  interleave_families(failing, result.end());
+
+  return result;
+}
+
+/// Connection attempts racing to connect a socket to one of the endpoints, see async_connect. The attempts are started
+/// one after another with the attempt delay in between, or as soon as the previous attempt fails. The first attempt
+/// that succeeds is moved to the socket, and the other ones are closed, which cancels them. The state is shared by the
+/// handlers of the attempts, which run on a strand.
+template <class Socket> class connect_race : public std::enable_shared_from_this<connect_race<Socket>> {
+public:
+  using endpoint_type = typename Socket::endpoint_type;
+
+  connect_race(Socket &socket, std::vector<endpoint_type> endpoints, std::chrono::steady_clock::duration attempt_delay,
+               endpoint_failure_cache<endpoint_type> *cache, async_connect_result<Socket> &result,
+               executor_type executor, coroutine_holder<> holder)
+      : _socket(socket), _endpoints(std::move(endpoints)), _attempt_delay(attempt_delay), _cache(cache),
+        _result(result), _executor(std::move(executor)), _holder(std::move(holder)),
+        _strand(boost::asio::make_strand(socket.get_executor())), _timer(_strand) {}
+
+  void start() {
+    boost::asio::dispatch(_strand, [self = this->shared_from_this()] { self->start_next(); });
+  }
+
+private:
+  Socket &_socket;
+  std::vector<endpoint_type> _endpoints;
+  std::chrono::steady_clock::duration _attempt_delay;
+  endpoint_failure_cache<endpoint_type> *_cache;
+  async_connect_result<Socket> &_result;
+  executor_type _executor;
+  coroutine_holder<> _holder;
+  boost::asio::strand<typename Socket::executor_type> _strand;
+  boost::asio::steady_timer _timer;
+  std::deque<Socket> _attempts;
+  std::size_t _pending = 0;
+  boost::system::error_code _last_error;
+  bool _done = false;
+
+  /// Starts the attempt to connect to the next endpoint, and schedules the one after it.
+  void start_next() {
+    if (_done) {
+      return;
+    }
+
+    const auto index = _attempts.size();
+    const auto &endpoint = _endpoints[index];
+    auto &attempt = _attempts.emplace_back(_socket.get_executor());
+    ++_pending;
+
+    boost::system::error_code error;
+    if (attempt.open(endpoint.protocol(), error)) {
+      boost::asio::dispatch(_strand, [self = this->shared_from_this(), index, error] { self->complete(index, error); });
+      return;
+    }
+
+    auto handler = [self = this->shared_from_this(), index](const boost::system::error_code &error) {
+      self->complete(index, error);
+    };
+    attempt.async_connect(endpoint, boost::asio::bind_executor(_strand, std::move(handler)));
+
+    if (_attempts.size() != _endpoints.size()) {
+      _timer.expires_after(_attempt_delay);
+      _timer.async_wait([self = this->shared_from_this(), next = index + 1](const boost::system::error_code &error) {
+        // The timer is rescheduled whenever an attempt fails, so the wait may be late for the attempt it's set for.
+        if (!error && self->_attempts.size() == next) {
+          self->start_next();
+        }
+      });
+    }
+  }
+
+  void complete(std::size_t index, const boost::system::error_code &error) {
+    --_pending;
+    auto &attempt = _attempts[index];
+    if (_done) {
+      return;
+    }
+
+    const auto &endpoint = _endpoints[index];
+    if (!error) {
+      if (_cache) {
+        _cache->record_success(endpoint);
+      }
+
+      _socket = std::move(attempt);
+      finish(error, endpoint);
+      return;
+    }
+
+    if (_cache) {
+      _cache->record_failure(endpoint);
+    }
+
+    _last_error = error;
+    boost::system::error_code ignored;
+    attempt.close(ignored);
+    if (_attempts.size() != _endpoints.size()) {
+      start_next();
+    } else if (_pending == 0) {
+      finish(_last_error, endpoint_type());
+    }
+  }
+
+  void finish(const boost::system::error_code &error, const endpoint_type &endpoint) {
+    _done = true;
+    _timer.cancel();
+    for (auto &attempt : _attempts) {
+      boost::system::error_code ignored;
+      attempt.close(ignored);
+    }
+
+    _result = async_connect_result<Socket>(error, endpoint);
+    resume_on(_executor, _holder.release());
+  }
+};
+} // namespace detail
+
+/// Returns an awaitable that connects the specified socket to one of the endpoints of the specified range, racing the
+/// connection attempts in the Happy Eyeballs style of RFC 8305, and suspends the awaiting coroutine until a connection
+/// is established or all the attempts fail.
+///
+/// The endpoints are tried in the order of the range, interleaved by the protocol family. The next attempt is started
+/// when the attempt delay passes or the previous attempt fails, without cancelling the attempts in progress, so a dead
+/// endpoint delays the connection by the attempt delay rather than by the connection timeout. The first attempt that
+/// succeeds is moved to the socket, which closes the socket if it's open, and the other attempts are closed. If all
+/// the attempts fail, the error of the last one is returned. An empty range fails with boost::asio::error::not_found.
+///
+/// The awaitable returns a value of type async_connect_result.
+///
+/// \param socket           A socket that connects to the remote peer.
+/// \param endpoints        The endpoints of the remote peer, e.g. the results of a resolver.
+/// \param cache            The cache of the failing endpoints, or nullptr. The endpoints failing according to the cache
+///                         are tried after the other ones, and the cache is updated with the results of the attempts.
+///                         The cache must outlive the attempts.
+/// \param attempt_delay    The delay between the starts of two attempts.
+template <class Socket, class EndpointRange, std::enable_if_t<detail::is_endpoint_range<EndpointRange>::value, int> = 0>
+auto async_connect(Socket &socket, const EndpointRange &endpoints,
+                   endpoint_failure_cache<typename Socket::endpoint_type> *cache,
+                   std::chrono::steady_clock::duration attempt_delay = detail::default_attempt_delay) {
+  using endpoint_type = typename Socket::endpoint_type;
+
+  class awaitable {
+  public:
+    explicit awaitable(Socket &socket, std::vector<endpoint_type> endpoints,
+                       std::chrono::steady_clock::duration attempt_delay, endpoint_failure_cache<endpoint_type> *cache)
+        : _socket(socket), _endpoints(std::move(endpoints)), _attempt_delay(attempt_delay), _cache(cache) {}
+
+    bool await_ready() noexcept {
+      if (_endpoints.empty()) {
+        _result.first = boost::asio::error::not_found;
+        return true;
+      }
+
+      return false;
+    }
+
+    async_connect_result<Socket> await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _socket);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      std::make_shared<detail::connect_race<Socket>>(_socket, std::move(_endpoints), _attempt_delay, _cache, _result,
+                                                     std::move(executor), std::move(holder))
+          ->start();
+    }
+
+  private:
+    Socket &_socket;
+    std::vector<endpoint_type> _endpoints;
+    std::chrono::steady_clock::duration _attempt_delay;
+    endpoint_failure_cache<endpoint_type> *_cache;
+    async_connect_result<Socket> _result;
+    detail::executor_type _executor;
+  };
+
+  return awaitable(socket, detail::order_endpoints(endpoints, cache), attempt_delay, cache);
+}
+
+/// Returns an awaitable that connects the specified socket to one of the endpoints of the specified range without a
+/// cache of the failing endpoints, see async_connect for details.
+///
+/// \param socket           A socket that connects to the remote peer.
+/// \param endpoints        The endpoints of the remote peer, e.g. the results of a resolver.
+/// \param attempt_delay    The delay between the starts of two attempts.
+template <class Socket, class EndpointRange, std::enable_if_t<detail::is_endpoint_range<EndpointRange>::value, int> = 0>
+auto async_connect(Socket &socket, const EndpointRange &endpoints,
+                   std::chrono::steady_clock::duration attempt_delay = detail::default_attempt_delay) {
+  return asio_coro::async_connect(socket, endpoints, nullptr, attempt_delay);
+}
 } // namespace asio_coro
 
 #endif // ASIO_CORO_EXTENSIONS_ASYNC_CONNECT_HPP
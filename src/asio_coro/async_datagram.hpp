@@ -0,0 +1,412 @@
+#ifndef ASIO_CORO_EXTENSIONS_ASYNC_DATAGRAM_HPP
+#define ASIO_CORO_EXTENSIONS_ASYNC_DATAGRAM_HPP
+
+#include "buffer_pool.hpp"
+#include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/scope_exit.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace asio_coro {
+/// The result of a datagram operation: the error occurred if any, and either the amount of bytes transferred by a
+/// single datagram operation, or the amount of datagrams transferred by a batched one.
+using async_datagram_result = std::pair<boost::system::error_code, std::size_t>;
+
+/// A datagram received by async_receive_batch or sent by async_send_batch.
+///
+/// With generic segmentation offload a datagram carries a train of datagrams of the same size, except for the last one,
+/// which may be shorter: the kernel splits the payload into the segments on sending, and coalesces the datagrams of the
+/// same flow into one payload on receiving if the socket has UDP_GRO enabled, see enable_udp_gro.
+struct datagram {
+  /// The payload. Its size is the amount of bytes received or to send.
+  pooled_buffer data;
+
+  /// The endpoint the datagram is received from or sent to. A default-constructed endpoint sends the datagram to the
+  /// peer of a connected socket.
+  boost::asio::ip::udp::endpoint endpoint;
+
+  /// The size of the segments the payload consists of, or zero if the payload is a single datagram.
+  std::uint16_t segment_size = 0;
+};
+
+namespace detail {
+/// The maximum amount of datagrams transferred with one recvmmsg or sendmmsg call.
+constexpr std::size_t max_datagram_batch = 64;
+
+/// Returns the error code corresponding to the errno value.
+inline boost::system::error_code datagram_error() noexcept {
+  return boost::system::error_code(errno, boost::system::system_category());
+}
+} // namespace detail
+
+/// Returns an awaitable that suspends the awaiting coroutine until a datagram is received from the specified socket
+/// into the specified buffer.
+///
+/// The awaitable returns a value of type async_datagram_result, where the second item is the size of the datagram.
+///
+/// \param socket     A datagram socket.
+/// \param buffer     A buffer or a buffer sequence to receive the datagram into.
+/// \param endpoint   Set to the endpoint the datagram is received from.
+template <class Socket, class MutableBuffer, class Endpoint>
+auto async_receive_from(Socket &socket, const MutableBuffer &buffer, Endpoint &endpoint) {
+  class awaitable {
+  public:
+    explicit awaitable(Socket &socket, const MutableBuffer &buffer, Endpoint &endpoint)
+        : _socket(socket), _buffer(buffer), _endpoint(endpoint) {}
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    async_datagram_result await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _socket);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                        std::size_t size) mutable {
+        _result = std::make_pair(error, size);
+        holder.release().resume();
+      };
+      _socket.async_receive_from(_buffer, _endpoint,
+                                 boost::asio::bind_executor(std::move(executor), std::move(handler)));
+    }
+
+  private:
+    Socket &_socket;
+    MutableBuffer _buffer;
+    Endpoint &_endpoint;
+    async_datagram_result _result;
+    detail::executor_type _executor;
+  };
+
+  return awaitable(socket, buffer, endpoint);
+}
+
+/// Returns an awaitable that suspends the awaiting coroutine until the specified buffer is sent as a datagram to the
+/// specified endpoint.
+///
+/// The awaitable returns a value of type async_datagram_result, where the second item is the amount of bytes sent.
+///
+/// \param socket     A datagram socket.
+/// \param buffer     A buffer or a buffer sequence to send.
+/// \param endpoint   The endpoint to send the datagram to.
+template <class Socket, class ConstBuffer, class Endpoint>
+auto async_send_to(Socket &socket, const ConstBuffer &buffer, const Endpoint &endpoint) {
+  class awaitable {
+  public:
+    explicit awaitable(Socket &socket, const ConstBuffer &buffer, const Endpoint &endpoint)
+        : _socket(socket), _buffer(buffer), _endpoint(endpoint) {}
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    async_datagram_result await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _socket);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                        std::size_t size) mutable {
+        _result = std::make_pair(error, size);
+        holder.release().resume();
+      };
+      _socket.async_send_to(_buffer, _endpoint, boost::asio::bind_executor(std::move(executor), std::move(handler)));
+    }
+
+  private:
+    Socket &_socket;
+    ConstBuffer _buffer;
+    Endpoint _endpoint;
+    async_datagram_result _result;
+    detail::executor_type _executor;
+  };
+
+  return awaitable(socket, buffer, endpoint);
+}
+
+/// Enables generic receive offload on the specified UDP socket, so the kernel may coalesce the datagrams of the same
+/// flow into one datagram received by async_receive_batch, see datagram. Returns the error occurred if any, e.g. if
+/// the kernel doesn't support it.
+///
+/// \param socket   A UDP socket.
+template <class Socket> boost::system::error_code enable_udp_gro(Socket &socket) {
+  const int enable = 1;
+  if (::setsockopt(socket.native_handle(), SOL_UDP, UDP_GRO, &enable, sizeof(enable)) == -1) {
+    return detail::datagram_error();
+  }
+
+  return {};
+}
+
+/// Returns an awaitable that receives the datagrams queued on the specified UDP socket with recvmmsg, up to the
+/// specified amount, and suspends the awaiting coroutine until the socket becomes readable only if there are none.
+///
+/// Every datagram is received into a buffer taken from the pool, and datagrams longer than the pool buffers are
+/// truncated, so the pool buffers should be 64 KiB long if the socket has UDP_GRO enabled. The received datagrams are
+/// appended to the specified vector, which may be reused between the calls to avoid allocations.
+///
+/// The awaitable returns a value of type async_datagram_result, where the second item is the amount of datagrams
+/// received.
+///
+/// \param socket       A UDP socket.
+/// \param pool         The pool to take the datagram buffers from.
+/// \param datagrams    The vector to append the received datagrams to.
+/// \param max_count    The maximum amount of datagrams to receive, which is capped by 64.
+template <class Socket>
+auto async_receive_batch(Socket &socket, buffer_pool &pool, std::vector<datagram> &datagrams,
+                         std::size_t max_count = detail::max_datagram_batch) {
+  class awaitable {
+  public:
+    explicit awaitable(Socket &socket, buffer_pool &pool, std::vector<datagram> &datagrams, std::size_t max_count)
+        : _socket(socket), _pool(pool), _datagrams(datagrams),
+          _max_count(std::min(max_count, detail::max_datagram_batch)) {}
+
+    bool await_ready() { return receive(); }
+
+    async_datagram_result await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      wait(detail::get_executor(_executor, _socket), detail::coroutine_holder<>(continuation));
+    }
+
+  private:
+    Socket &_socket;
+    buffer_pool &_pool;
+    std::vector<datagram> &_datagrams;
+    std::size_t _max_count;
+    async_datagram_result _result;
+    detail::executor_type _executor;
+
+    void wait(detail::executor_type executor, detail::coroutine_holder<> holder) {
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, executor, holder = std::move(holder)](const boost::system::error_code &error) mutable {
+        if (error) {
+          _result.first = error;
+          holder.release().resume();
+          return;
+        }
+
+        if (receive()) {
+          holder.release().resume();
+          return;
+        }
+
+        wait(std::move(executor), std::move(holder));
+      };
+      // The reactor re-registers the socket when the wait is queued, so a datagram that has arrived since recvmmsg
+      // found the queue empty is reported even if another thread running the io_context has consumed its readiness.
+      _socket.async_wait(Socket::wait_read, boost::asio::bind_executor(executor, std::move(handler)));
+    }
+
+    /// Receives the queued datagrams. Returns false if there are none, and true if some datagrams are received or an
+    /// error has occurred.
+    bool receive() {
+      if (_max_count == 0) {
+        return true;
+      }
+
+      const auto first = _datagrams.size();
+      _datagrams.resize(first + _max_count);
+
+      std::array<mmsghdr, detail::max_datagram_batch> headers{};
+      std::array<iovec, detail::max_datagram_batch> iovecs{};
+      alignas(cmsghdr) char control[detail::max_datagram_batch][CMSG_SPACE(sizeof(int))];
+      for (std::size_t i = 0; i != _max_count; ++i) {
+        auto &datagram = _datagrams[first + i];
+        datagram.data = _pool.acquire();
+        iovecs[i] = iovec{datagram.data.data(), datagram.data.capacity()};
+        headers[i].msg_hdr.msg_iov = &iovecs[i];
+        headers[i].msg_hdr.msg_iovlen = 1;
+        headers[i].msg_hdr.msg_name = datagram.endpoint.data();
+        headers[i].msg_hdr.msg_namelen = static_cast<socklen_t>(datagram.endpoint.capacity());
+        headers[i].msg_hdr.msg_control = control[i];
+        headers[i].msg_hdr.msg_controllen = sizeof(control[i]);
+      }
+
+      int received;
+      do {
+        received = ::recvmmsg(_socket.native_handle(), headers.data(), static_cast<unsigned>(_max_count),
+                              MSG_DONTWAIT, nullptr);
+      } while (received == -1 && errno == EINTR);
+
+      if (received == -1) {
+        const auto error = detail::datagram_error();
+        _datagrams.resize(first);
+        if (error == boost::system::errc::operation_would_block ||
+            error == boost::system::errc::resource_unavailable_try_again) {
+          return false;
+        }
+
+        _result.first = error;
+        return true;
+      }
+
+      for (std::size_t i = 0; i != static_cast<std::size_t>(received); ++i) {
+        auto &datagram = _datagrams[first + i];
+        auto &header = headers[i].msg_hdr;
+        datagram.data.resize(std::min<std::size_t>(headers[i].msg_len, datagram.data.capacity()));
+        datagram.endpoint.resize(header.msg_namelen);
+        for (auto *message = CMSG_FIRSTHDR(&header); message; message = CMSG_NXTHDR(&header, message)) {
+          if (message->cmsg_level == SOL_UDP && message->cmsg_type == UDP_GRO) {
+            int segment_size;
+            std::memcpy(&segment_size, CMSG_DATA(message), sizeof(segment_size));
+            datagram.segment_size = static_cast<std::uint16_t>(segment_size);
+          }
+        }
+      }
+
+      _datagrams.resize(first + static_cast<std::size_t>(received));
+      _result.second = static_cast<std::size_t>(received);
+      return true;
+    }
+  };
+
+  return awaitable(socket, pool, datagrams, max_count);
+}
+
+/// Returns an awaitable that sends the specified datagrams over the specified UDP socket with sendmmsg, up to 64
+/// datagrams per system call, and suspends the awaiting coroutine only while the socket buffer is full.
+///
+/// Datagrams with a non-zero segment size are sent with UDP_SEGMENT, so the kernel, or the network card, splits the
+/// payload into the datagrams of the segment size. The payload mustn't exceed 64 KiB then, and the segments mustn't
+/// exceed the path MTU.
+///
+/// The awaitable returns a value of type async_datagram_result, where the second item is the amount of datagrams sent,
+/// which is less than the amount of datagrams specified only if an error has occurred.
+///
+/// \param socket       A UDP socket.
+/// \param datagrams    A contiguous range of datagrams to send, e.g. std::vector<datagram>. The datagrams mustn't be
+///                     modified until the awaitable completes.
+template <class Socket, class Datagrams> auto async_send_batch(Socket &socket, const Datagrams &datagrams) {
+  class awaitable {
+  public:
+    explicit awaitable(Socket &socket, const datagram *datagrams, std::size_t count)
+        : _socket(socket), _datagrams(datagrams), _count(count) {}
+
+    bool await_ready() { return send(); }
+
+    async_datagram_result await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      wait(detail::get_executor(_executor, _socket), detail::coroutine_holder<>(continuation));
+    }
+
+  private:
+    Socket &_socket;
+    const datagram *_datagrams;
+    std::size_t _count;
+    async_datagram_result _result;
+    detail::executor_type _executor;
+
+    void wait(detail::executor_type executor, detail::coroutine_holder<> holder) {
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, executor, holder = std::move(holder)](const boost::system::error_code &error) mutable {
+        if (error) {
+          _result.first = error;
+          holder.release().resume();
+          return;
+        }
+
+        if (send()) {
+          holder.release().resume();
+          return;
+        }
+
+        wait(std::move(executor), std::move(holder));
+      };
+      // Likewise for the buffer space freed since sendmmsg found the buffer full, see async_receive_batch.
+      _socket.async_wait(Socket::wait_write, boost::asio::bind_executor(executor, std::move(handler)));
+    }
+
+    /// Sends the rest of the datagrams. Returns false if the socket buffer is full, and true if all the datagrams are
+    /// sent or an error has occurred.
+    bool send() {
+      const boost::asio::ip::udp::endpoint unspecified;
+      auto &sent = _result.second;
+      while (sent != _count) {
+        const auto batch = std::min(_count - sent, detail::max_datagram_batch);
+        std::array<mmsghdr, detail::max_datagram_batch> headers{};
+        std::array<iovec, detail::max_datagram_batch> iovecs{};
+        alignas(cmsghdr) char control[detail::max_datagram_batch][CMSG_SPACE(sizeof(std::uint16_t))];
+        for (std::size_t i = 0; i != batch; ++i) {
+          const auto &datagram = _datagrams[sent + i];
+          auto &header = headers[i].msg_hdr;
+          iovecs[i] = iovec{datagram.data.data(), datagram.data.size()};
+          header.msg_iov = &iovecs[i];
+          header.msg_iovlen = 1;
+          if (datagram.endpoint != unspecified) {
+            header.msg_name = const_cast<sockaddr *>(datagram.endpoint.data());
+            header.msg_namelen = static_cast<socklen_t>(datagram.endpoint.size());
+          }
+
+          if (datagram.segment_size != 0) {
+            header.msg_control = control[i];
+            header.msg_controllen = sizeof(control[i]);
+            auto *const message = CMSG_FIRSTHDR(&header);
+            message->cmsg_level = SOL_UDP;
+            message->cmsg_type = UDP_SEGMENT;
+            message->cmsg_len = CMSG_LEN(sizeof(std::uint16_t));
+            std::memcpy(CMSG_DATA(message), &datagram.segment_size, sizeof(std::uint16_t));
+          }
+        }
+
+        const auto result =
+            ::sendmmsg(_socket.native_handle(), headers.data(), static_cast<unsigned>(batch), MSG_DONTWAIT);
+        if (result == -1) {
+          if (errno == EINTR) {
+            continue;
+          }
+
+          if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return false;
+          }
+
+          _result.first = detail::datagram_error();
+          return true;
+        }
+
+        sent += static_cast<std::size_t>(result);
+      }
+
+      return true;
+    }
+  };
+
+  return awaitable(socket, std::data(datagrams), std::size(datagrams));
+}
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_ASYNC_DATAGRAM_HPP
@@ -2,6 +2,7 @@
 #define ASIO_CORO_EXTENSIONS_ASYNC_MUTEX_HPP
 
 #include "detail/coroutine.hpp"
+#include "detail/executor.hpp"
 
 #include <cassert>
 #include <mutex>
@@ -52,12 +53,15 @@ private:
 
 template <typename MutexType> class async_mutex_lock_operation {
 public:
-  constexpr async_mutex_lock_operation(MutexType &mutex) noexcept : m_mutex(mutex) {}
+  async_mutex_lock_operation(MutexType &mutex) noexcept : m_mutex(mutex) {}
 
   constexpr bool await_ready() const noexcept { return false; }
 
   constexpr void await_resume() const noexcept {}
 
+  /// Sets the executor the awaiting coroutine is resumed on once the lock is passed to it.
+  void set_executor(detail::executor_type executor) noexcept { m_item.executor = std::move(executor); }
+
   bool await_suspend(detail::coroutine_handle<> continuation) {
     m_item.continuation = continuation;
     return !m_mutex.try_lock(&m_item);
@@ -70,8 +74,7 @@ protected:
 
 template <typename MutexType> class scoped_async_mutex_lock_operation : public async_mutex_lock_operation<MutexType> {
 public:
-  constexpr scoped_async_mutex_lock_operation(MutexType &mutex) noexcept
-      : async_mutex_lock_operation<MutexType>(mutex) {}
+  scoped_async_mutex_lock_operation(MutexType &mutex) noexcept : async_mutex_lock_operation<MutexType>(mutex) {}
 
   constexpr auto await_resume() noexcept {
     return async_mutex_lock<MutexType>(async_mutex_lock_operation<MutexType>::m_mutex, std::adopt_lock_t());
@@ -96,7 +99,8 @@ public:
     assert(!m_last);
   }
 
-  /// Unlocks the mutex. Resumes a pending coroutine if there are any.
+  /// Unlocks the mutex. Resumes a pending coroutine if there are any on its associated executor, so the coroutine is
+  /// resumed inline only if the unlocking thread already runs within that executor.
   void unlock() {
     continuations_list_item *item;
     {
@@ -125,7 +129,7 @@ public:
     assert(item);
     assert(item->continuation);
 
-    item->continuation.resume();
+    detail::resume_on(item->executor, item->continuation);
   }
 
   /// Attempts to lock the mutex. Returns true on successfull outcome, false otherwise.
@@ -140,12 +144,12 @@ public:
   }
 
   /// Returns an awaitable that suspends the awaiting coroutine until the lock is acquired.
-  constexpr auto async_lock() noexcept { return detail::async_mutex_lock_operation<async_mutex>(*this); }
+  auto async_lock() noexcept { return detail::async_mutex_lock_operation<async_mutex>(*this); }
 
   /// Returns an awaitable that suspends the awaiting coroutine until the lock is acquired.
   ///
   /// The awaitable returns an instance of async_mutex_lock that holds lock over this mutex.
-  constexpr auto async_lock_scoped() noexcept { return detail::scoped_async_mutex_lock_operation<async_mutex>(*this); }
+  auto async_lock_scoped() noexcept { return detail::scoped_async_mutex_lock_operation<async_mutex>(*this); }
 
 private:
   friend detail::async_mutex_lock_operation<async_mutex>;
@@ -154,6 +158,7 @@ private:
   struct continuations_list_item {
     continuations_list_item *next = nullptr;
     detail::coroutine_handle<> continuation;
+    detail::executor_type executor;
   };
 
   std::mutex m_mutex;
@@ -1,16 +1,21 @@
 #ifndef ASIO_CORO_EXTENSIONS_ASYNC_READ_HPP
 #define ASIO_CORO_EXTENSIONS_ASYNC_READ_HPP
 
+#include "buffer_pool.hpp"
 #include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
 
 #include <boost/asio.hpp>
 #include <boost/scope_exit.hpp>
 #include <boost/system/error_code.hpp>
 
+#include <cstdint>
+#include <tuple>
 #include <utility>
 
 namespace asio_coro {
 using async_read_result = std::pair<boost::system::error_code, std::size_t>;
+using async_read_pooled_result = std::tuple<boost::system::error_code, pooled_buffer, std::size_t>;
 
 /// Returns an awaitable that suspends the awaiting coroutine, performs one asynchronous read from the specified socket
 /// into the specified buffer, and resumes the awaiting coroutine.
@@ -19,7 +24,8 @@ using async_read_result = std::pair<boost::system::error_code, std::size_t>;
 /// the second - the amount of bytes has been read.
 ///
 /// \param stream   A socket to read data from.
-/// \param buffer   A buffer to read data into.
+/// \param buffer   A buffer or a buffer sequence to read data into, see make_buffers. All the buffers of a sequence
+///                 are read into with one readv call.
 template <class Stream, class MutableBuffer> auto async_read(Stream &stream, const MutableBuffer &buffer) {
   class awaitable {
   public:
@@ -29,21 +35,27 @@ template <class Stream, class MutableBuffer> auto async_read(Stream &stream, con
 
     async_read_result await_resume() const noexcept { return _result; }
 
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
     void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _stream);
       detail::coroutine_holder<> holder(continuation);
       BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
 
-      _stream.async_read_some(_buffer, [this, holder = std::move(holder)](const boost::system::error_code &error,
-                                                                          std::size_t size) mutable {
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                        std::size_t size) mutable {
         _result = std::make_pair(error, size);
         holder.release().resume();
-      });
+      };
+      _stream.async_read_some(_buffer, boost::asio::bind_executor(std::move(executor), std::move(handler)));
     }
 
   private:
     Stream &_stream;
     MutableBuffer _buffer;
     async_read_result _result;
+    detail::executor_type _executor;
   };
 
   return awaitable(stream, buffer);
@@ -56,7 +68,7 @@ template <class Stream, class MutableBuffer> auto async_read(Stream &stream, con
 /// The awaitable returns a value of type async_read_result, see async_read for details on return value.
 ///
 /// \param stream                   Socket to read data from.
-/// \param buffer                   The destination data buffer.
+/// \param buffer                   The destination data buffer or buffer sequence.
 /// \param completion_condition     The read completion condition. See documentation on boost::asio::async_read for
 ///                                 details.
 template <class Stream, class MutableBuffer, class CompletionCondition>
@@ -70,16 +82,21 @@ auto async_read(Stream &stream, const MutableBuffer &buffer, const CompletionCon
 
     async_read_result await_resume() const noexcept { return _result; }
 
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
     void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _stream);
       detail::coroutine_holder<> holder(continuation);
       BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
 
-      boost::asio::async_read(
-          _stream, _buffer, _completion_condition,
-          [holder = std::move(holder), this](const boost::system::error_code &error, std::size_t size) mutable {
-            _result = std::make_pair(error, size);
-            holder.release().resume();
-          });
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                        std::size_t size) mutable {
+        _result = std::make_pair(error, size);
+        holder.release().resume();
+      };
+      boost::asio::async_read(_stream, _buffer, _completion_condition,
+                              boost::asio::bind_executor(std::move(executor), std::move(handler)));
     }
 
   private:
@@ -87,10 +104,180 @@ auto async_read(Stream &stream, const MutableBuffer &buffer, const CompletionCon
     MutableBuffer _buffer;
     CompletionCondition _completion_condition;
     async_read_result _result;
+    detail::executor_type _executor;
   };
 
   return awaitable(stream, buffer, completion_condition);
 }
+
+/// Returns an awaitable that suspends the awaiting coroutine, performs one asynchronous read from the specified device
+/// at the specified offset into the specified buffer, and resumes the awaiting coroutine.
+///
+/// The awaitable returns a value of type async_read_result, see async_read for details on return value.
+///
+/// \param device   A random access device to read data from, e.g. random_access_file.
+/// \param offset   The offset to read data at.
+/// \param buffer   A buffer or a buffer sequence to read data into.
+template <class Device, class MutableBuffer>
+auto async_read_at(Device &device, std::uint64_t offset, const MutableBuffer &buffer) {
+  class awaitable {
+  public:
+    explicit awaitable(Device &device, std::uint64_t offset, const MutableBuffer &buffer)
+        : _device(device), _offset(offset), _buffer(buffer) {}
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    async_read_result await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _device);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                        std::size_t size) mutable {
+        _result = std::make_pair(error, size);
+        holder.release().resume();
+      };
+      _device.async_read_some_at(_offset, _buffer,
+                                 boost::asio::bind_executor(std::move(executor), std::move(handler)));
+    }
+
+  private:
+    Device &_device;
+    std::uint64_t _offset;
+    MutableBuffer _buffer;
+    async_read_result _result;
+    detail::executor_type _executor;
+  };
+
+  return awaitable(device, offset, buffer);
+}
+
+/// Returns an awaitable that suspends the awaiting coroutine, performs one or more reads from the specified device at
+/// the specified offset into the specified buffer upon either the completion condition is met or an error is occurred.
+///
+/// The awaitable returns a value of type async_read_result, see async_read for details on return value.
+///
+/// \param device                   A random access device to read data from, e.g. random_access_file.
+/// \param offset                   The offset to read data at.
+/// \param buffer                   The destination data buffer or buffer sequence.
+/// \param completion_condition     The read completion condition. See documentation on boost::asio::async_read_at for
+///                                 details.
+template <class Device, class MutableBuffer, class CompletionCondition>
+auto async_read_at(Device &device, std::uint64_t offset, const MutableBuffer &buffer,
+                   const CompletionCondition &completion_condition) {
+  class awaitable {
+  public:
+    explicit awaitable(Device &device, std::uint64_t offset, const MutableBuffer &buffer,
+                       const CompletionCondition &completion_condition)
+        : _device(device), _offset(offset), _buffer(buffer), _completion_condition(completion_condition) {}
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    async_read_result await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _device);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                        std::size_t size) mutable {
+        _result = std::make_pair(error, size);
+        holder.release().resume();
+      };
+      boost::asio::async_read_at(_device, _offset, _buffer, _completion_condition,
+                                 boost::asio::bind_executor(std::move(executor), std::move(handler)));
+    }
+
+  private:
+    Device &_device;
+    std::uint64_t _offset;
+    MutableBuffer _buffer;
+    CompletionCondition _completion_condition;
+    async_read_result _result;
+    detail::executor_type _executor;
+  };
+
+  return awaitable(device, offset, buffer, completion_condition);
+}
+
+/// Returns an awaitable that suspends the awaiting coroutine until the specified socket has data to read, takes a
+/// buffer from the specified pool, performs one read into the buffer, and resumes the awaiting coroutine.
+///
+/// Unlike async_read, no buffer is held while the socket is idle, so the memory consumed by idle connections doesn't
+/// depend on the read buffer size. The read is started right after the readiness notification, and it completes
+/// without another reactor round trip because the data is already there.
+///
+/// The awaitable returns a value of type async_read_pooled_result, where the first item contains the operation result,
+/// the second - the buffer the data has been read into, resized to the amount of bytes has been read, and the third -
+/// the amount of bytes has been read. The buffer is returned to the pool once the caller drops all the handles to it,
+/// so it may be passed on to async_write as is. The buffer is empty if waiting for the data fails.
+///
+/// \param socket   A socket to read data from.
+/// \param pool     A pool to take the buffer from.
+template <class Socket> auto async_read_pooled(Socket &socket, buffer_pool &pool) {
+  class awaitable {
+  public:
+    explicit awaitable(Socket &socket, buffer_pool &pool) : _socket(socket), _pool(pool) {}
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    async_read_pooled_result await_resume() noexcept { return std::move(_result); }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _socket);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, executor, holder = std::move(holder)](const boost::system::error_code &error) mutable {
+        if (error) {
+          std::get<0>(_result) = error;
+          holder.release().resume();
+          return;
+        }
+
+        read(std::move(executor), std::move(holder));
+      };
+      _socket.async_wait(Socket::wait_read, boost::asio::bind_executor(executor, std::move(handler)));
+    }
+
+  private:
+    Socket &_socket;
+    buffer_pool &_pool;
+    async_read_pooled_result _result;
+    detail::executor_type _executor;
+
+    void read(detail::executor_type executor, detail::coroutine_holder<> holder) {
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto &buffer = std::get<1>(_result);
+      buffer = _pool.acquire();
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                        std::size_t size) mutable {
+        std::get<0>(_result) = error;
+        std::get<1>(_result).resize(size);
+        std::get<2>(_result) = size;
+        holder.release().resume();
+      };
+      _socket.async_read_some(boost::asio::mutable_buffer(buffer.data(), buffer.size()),
+                              boost::asio::bind_executor(std::move(executor), std::move(handler)));
+    }
+  };
+
+  return awaitable(socket, pool);
+}
 } // namespace asio_coro
 
 #endif // ASIO_CORO_EXTENSIONS_ASYNC_READ_HPP
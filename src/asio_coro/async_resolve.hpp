@@ -0,0 +1,341 @@
+#ifndef ASIO_CORO_EXTENSIONS_ASYNC_RESOLVE_HPP
+#define ASIO_CORO_EXTENSIONS_ASYNC_RESOLVE_HPP
+
+#include "detail/coroutine.hpp"
+#include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/scope_exit.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace asio_coro {
+/// The result of a name resolution: the error occurred if any, and the resolved endpoints.
+template <class Resolver = boost::asio::ip::tcp::resolver>
+using async_resolve_result = std::pair<boost::system::error_code, typename Resolver::results_type>;
+
+/// Returns an awaitable that suspends the awaiting coroutine until the specified host name and service are resolved
+/// with the specified resolver.
+///
+/// The awaitable returns a value of type async_resolve_result.
+///
+/// \param resolver   A resolver, e.g. boost::asio::ip::tcp::resolver.
+/// \param host       The host name or address to resolve.
+/// \param service    The service name or port number to resolve.
+template <class Resolver> auto async_resolve(Resolver &resolver, std::string host, std::string service) {
+  class awaitable {
+  public:
+    explicit awaitable(Resolver &resolver, std::string host, std::string service)
+        : _resolver(resolver), _host(std::move(host)), _service(std::move(service)) {}
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    async_resolve_result<Resolver> await_resume() noexcept { return std::move(_result); }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _resolver);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                        typename Resolver::results_type results) mutable {
+        _result = async_resolve_result<Resolver>(error, std::move(results));
+        holder.release().resume();
+      };
+      _resolver.async_resolve(_host, _service, boost::asio::bind_executor(std::move(executor), std::move(handler)));
+    }
+
+  private:
+    Resolver &_resolver;
+    std::string _host;
+    std::string _service;
+    async_resolve_result<Resolver> _result;
+    detail::executor_type _executor;
+  };
+
+  return awaitable(resolver, std::move(host), std::move(service));
+}
+
+/// A cache of name resolutions shared by the coroutines of a process, which may run on many threads.
+///
+/// Resolutions are cached for the time-to-live, and failures for the negative time-to-live. The system resolver doesn't
+/// report the TTL of the DNS records, so the time-to-live is the same for all the names. Concurrent lookups of the same
+/// name are coalesced into one resolution. An expired resolution is served for the stale period while it's being
+/// refreshed in the background, so a slow or failing name server doesn't stall the coroutines of a name that has been
+/// resolved before. A refresh that fails doesn't replace the resolution served, and isn't retried for the negative
+/// time-to-live.
+///
+/// The cache is split into shards with their own locks, which are picked by the hash of the name, so threads resolving
+/// different names rarely contend. Entries that have been expired for longer than the stale period are removed from a
+/// shard when it grows. The cache must outlive the resolutions in progress.
+///
+/// \tparam Resolver  The resolver performing the resolutions, e.g. boost::asio::ip::tcp::resolver. A new resolver is
+///                   created with the cache executor for every resolution.
+template <class Resolver = boost::asio::ip::tcp::resolver> class resolver_cache {
+public:
+  using clock_type = std::chrono::steady_clock;
+  using duration = clock_type::duration;
+  using results_type = typename Resolver::results_type;
+  using result_type = async_resolve_result<Resolver>;
+
+  /// The amount of shards the cache is split into.
+  static constexpr std::size_t shards_count = 16;
+
+  /// Constructor. Creates an empty cache.
+  ///
+  /// \param executor       The executor resolvers are created with.
+  /// \param ttl            The time resolutions are served for without refreshing them.
+  /// \param stale_period   The time expired resolutions are served for while they're being refreshed.
+  /// \param negative_ttl   The time failed resolutions are served for.
+  template <class Executor>
+  explicit resolver_cache(const Executor &executor, duration ttl = std::chrono::seconds(30),
+                          duration stale_period = std::chrono::minutes(5),
+                          duration negative_ttl = std::chrono::seconds(1))
+      : _executor(executor), _ttl(ttl), _stale_period(stale_period), _negative_ttl(negative_ttl) {}
+
+  resolver_cache(const resolver_cache &) = delete;
+
+  resolver_cache &operator=(const resolver_cache &) = delete;
+
+  /// Returns the amount of cached entries.
+  std::size_t size() const {
+    std::size_t result = 0;
+    for (auto &shard : _shards) {
+      std::lock_guard lock(shard.mutex);
+      result += shard.entries.size();
+    }
+
+    return result;
+  }
+
+  /// Returns the amount of resolutions performed, including the background refreshes.
+  std::size_t resolutions() const noexcept { return _resolutions.load(std::memory_order_relaxed); }
+
+  /// Removes all the entries except for the ones being resolved.
+  void clear() {
+    for (auto &shard : _shards) {
+      std::lock_guard lock(shard.mutex);
+      std::erase_if(shard.entries, [](const auto &item) { return !item.second.resolving; });
+    }
+  }
+
+  /// Returns an awaitable that returns the cached resolution of the specified host name and service, and suspends the
+  /// awaiting coroutine only if there is none or it has been expired for longer than the stale period, until the name
+  /// is resolved.
+  ///
+  /// The awaitable returns a value of type async_resolve_result.
+  ///
+  /// \param host       The host name or address to resolve.
+  /// \param service    The service name or port number to resolve.
+  auto async_resolve(std::string host, std::string service) {
+    class awaitable {
+    public:
+      explicit awaitable(resolver_cache &cache, std::string host, std::string service)
+          : _cache(cache), _host(std::move(host)), _service(std::move(service)) {}
+
+      constexpr bool await_ready() const noexcept { return false; }
+
+      result_type await_resume() noexcept { return std::move(_result); }
+
+      /// Sets the executor the awaiting coroutine is resumed on.
+      void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+      bool await_suspend(detail::coroutine_handle<> continuation) {
+        return _cache.lookup(_host, _service, _result, continuation, std::move(_executor));
+      }
+
+    private:
+      resolver_cache &_cache;
+      std::string _host;
+      std::string _service;
+      result_type _result;
+      detail::executor_type _executor;
+    };
+
+    return awaitable(*this, std::move(host), std::move(service));
+  }
+
+private:
+  /// A coroutine waiting for a name to be resolved.
+  struct waiter {
+    detail::coroutine_handle<> continuation;
+    detail::executor_type executor;
+    result_type *result;
+  };
+
+  struct entry {
+    result_type result;
+    clock_type::time_point expires_at;
+    clock_type::time_point refresh_at;
+    bool resolved = false;
+    bool resolving = false;
+    std::vector<waiter> waiters;
+  };
+
+  struct shard {
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, entry> entries;
+    std::size_t purge_size = 64;
+  };
+
+  detail::executor_type _executor;
+  duration _ttl;
+  duration _stale_period;
+  duration _negative_ttl;
+  std::array<shard, shards_count> _shards;
+  std::atomic<std::size_t> _resolutions = 0;
+
+  static std::string make_key(std::string_view host, std::string_view service) {
+    std::string key;
+    key.reserve(host.size() + service.size() + 1);
+    key.append(host).append(1, '\0').append(service);
+
+    return key;
+  }
+
+  shard &shard_of(const std::string &key) noexcept { return _shards[std::hash<std::string>()(key) % shards_count]; }
+
+  /// Returns the cached resolution if it's usable, starts a resolution if the cached one is expired, and queues the
+  /// coroutine if it has to wait for the resolution. Returns whether the coroutine is suspended.
+  bool lookup(const std::string &host, const std::string &service, result_type &result,
+              detail::coroutine_handle<> continuation, detail::executor_type executor) {
+    auto key = make_key(host, service);
+    auto &shard = shard_of(key);
+    const auto now = clock_type::now();
+
+    std::unique_lock lock(shard.mutex);
+    auto [it, inserted] = shard.entries.try_emplace(std::move(key));
+    if (inserted) {
+      purge(shard, now);
+    }
+
+    auto &entry = it->second;
+    const auto fresh = entry.resolved && now < entry.expires_at;
+    const auto stale = entry.resolved && !entry.result.first && now < entry.expires_at + _stale_period;
+    if (fresh || stale) {
+      result = entry.result;
+    } else {
+      entry.waiters.push_back(waiter{continuation, std::move(executor), &result});
+    }
+
+    if (!fresh && !entry.resolving && (!stale || entry.refresh_at <= now)) {
+      entry.resolving = true;
+      auto resolved_key = it->first;
+      lock.unlock();
+      try {
+        resolve(resolved_key, host, service);
+      } catch (...) {
+        abandon(resolved_key, &result);
+        throw;
+      }
+    }
+
+    return !fresh && !stale;
+  }
+
+  /// Removes the entries expired for longer than the stale period if the shard has doubled since the last purge.
+  void purge(shard &shard, clock_type::time_point now) {
+    if (shard.entries.size() < shard.purge_size) {
+      return;
+    }
+
+    std::erase_if(shard.entries, [&](const auto &item) {
+      const auto &entry = item.second;
+      return entry.resolved && !entry.resolving && entry.expires_at + _stale_period <= now;
+    });
+    shard.purge_size = std::max<std::size_t>(64, shard.entries.size() * 2);
+  }
+
+  void resolve(std::string key, const std::string &host, const std::string &service) {
+    _resolutions.fetch_add(1, std::memory_order_relaxed);
+
+    auto resolver = std::make_shared<Resolver>(_executor);
+    auto &resolver_ref = *resolver;
+    resolver_ref.async_resolve(
+        host, service,
+        [this, key = std::move(key), resolver = std::move(resolver)](const boost::system::error_code &error,
+                                                                     results_type results) mutable {
+          complete(key, result_type(error, std::move(results)));
+        });
+  }
+
+  /// Stores the resolution unless it's a failed refresh of a successful one, which is retried after the negative
+  /// time-to-live instead, and resumes the waiting coroutines.
+  void complete(const std::string &key, result_type result) {
+    auto &shard = shard_of(key);
+    std::vector<waiter> waiters;
+    {
+      std::lock_guard lock(shard.mutex);
+      auto &entry = shard.entries[key];
+      entry.resolving = false;
+      const auto now = clock_type::now();
+      if (!result.first || !entry.resolved || entry.result.first) {
+        entry.expires_at = now + (result.first ? _negative_ttl : _ttl);
+        entry.result = result;
+        entry.resolved = true;
+      } else {
+        entry.refresh_at = now + _negative_ttl;
+      }
+
+      waiters.swap(entry.waiters);
+    }
+
+    for (auto &waiter : waiters) {
+      *waiter.result = result;
+      detail::resume_on(waiter.executor, waiter.continuation);
+    }
+  }
+
+  /// Gives up the resolution that has failed to start: resumes the coroutines that have queued for it meanwhile with an
+  /// error, and removes the waiter of the coroutine the exception is propagated to, if it has queued.
+  void abandon(const std::string &key, const result_type *result) {
+    auto &shard = shard_of(key);
+    std::vector<waiter> waiters;
+    {
+      std::lock_guard lock(shard.mutex);
+      auto &entry = shard.entries[key];
+      entry.resolving = false;
+      waiters.swap(entry.waiters);
+    }
+
+    for (auto &waiter : waiters) {
+      if (waiter.result != result) {
+        *waiter.result = result_type(boost::asio::error::operation_aborted, results_type());
+        detail::resume_on(waiter.executor, waiter.continuation);
+      }
+    }
+  }
+};
+
+/// Returns an awaitable that resolves the specified host name and service using the specified cache, see
+/// resolver_cache::async_resolve for details.
+///
+/// \param cache      The resolution cache.
+/// \param host       The host name or address to resolve.
+/// \param service    The service name or port number to resolve.
+template <class Resolver>
+auto async_resolve(resolver_cache<Resolver> &cache, std::string host, std::string service) {
+  return cache.async_resolve(std::move(host), std::move(service));
+}
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_ASYNC_RESOLVE_HPP
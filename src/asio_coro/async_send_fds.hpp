@@ -0,0 +1,217 @@
+#ifndef ASIO_CORO_EXTENSIONS_ASYNC_SEND_FDS_HPP
+#define ASIO_CORO_EXTENSIONS_ASYNC_SEND_FDS_HPP
+
+#include "async_sendfile.hpp"
+
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace asio_coro {
+namespace detail {
+/// The maximum amount of file descriptors passed with one message, which is SCM_MAX_FD of the Linux kernel.
+constexpr std::size_t max_passed_fds = 253;
+
+/// Sends some of the data with sendmsg(2), attaching the file descriptors as SCM_RIGHTS ancillary data if there are
+/// any. Returns the amount of bytes sent, or -1 and sets errno.
+inline ssize_t send_with_fds(int socket, const void *data, std::size_t size, const std::vector<int> &fds) {
+  iovec iov{const_cast<void *>(data), size};
+  msghdr message{};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+
+  std::vector<char> control;
+  if (!fds.empty()) {
+    control.resize(CMSG_SPACE(fds.size() * sizeof(int)));
+    message.msg_control = control.data();
+    message.msg_controllen = control.size();
+
+    auto header = CMSG_FIRSTHDR(&message);
+    header->cmsg_level = SOL_SOCKET;
+    header->cmsg_type = SCM_RIGHTS;
+    header->cmsg_len = CMSG_LEN(fds.size() * sizeof(int));
+    std::memcpy(CMSG_DATA(header), fds.data(), fds.size() * sizeof(int));
+  }
+
+  return ::sendmsg(socket, &message, MSG_DONTWAIT | MSG_NOSIGNAL);
+}
+
+/// Receives some data with recvmsg(2), and appends the file descriptors passed with it to the specified vector. The
+/// received file descriptors have the close-on-exec flag set. Returns the amount of bytes received, or -1 and sets
+/// errno. Sets truncated if the message has had more file descriptors than the maximum, the rest of which are closed by
+/// the kernel.
+inline ssize_t receive_with_fds(int socket, void *data, std::size_t size, std::vector<int> &fds, std::size_t max_fds,
+                                bool &truncated) {
+  iovec iov{data, size};
+  msghdr message{};
+  message.msg_iov = &iov;
+  message.msg_iovlen = 1;
+
+  std::vector<char> control(CMSG_SPACE(std::max<std::size_t>(max_fds, 1) * sizeof(int)));
+  message.msg_control = control.data();
+  message.msg_controllen = control.size();
+
+  const auto received = ::recvmsg(socket, &message, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+  if (received == -1) {
+    return received;
+  }
+
+  for (auto header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+    if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+      const auto count = (header->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+      const auto first = fds.size();
+      fds.resize(first + count);
+      std::memcpy(fds.data() + first, CMSG_DATA(header), count * sizeof(int));
+    }
+  }
+
+  truncated = (message.msg_flags & MSG_CTRUNC) != 0;
+  return received;
+}
+
+/// A transfer sending data and file descriptors over a Unix domain socket, see async_send_fds.
+template <class Socket> class send_fds_transfer {
+public:
+  send_fds_transfer(Socket &socket, boost::asio::const_buffer buffer, std::vector<int> fds)
+      : _socket(socket), _buffer(buffer), _fds(std::move(fds)) {}
+
+  auto get_executor() { return _socket.get_executor(); }
+
+  bool step(async_transfer_result &result) {
+    if (_buffer.size() == 0 && !_fds.empty()) {
+      // Ancillary data can't be sent without any data over a stream socket.
+      result.first = boost::asio::error::invalid_argument;
+      return true;
+    }
+
+    while (result.second != _buffer.size()) {
+      const auto data = static_cast<const char *>(_buffer.data()) + result.second;
+      const auto sent = send_with_fds(_socket.native_handle(), data, _buffer.size() - result.second, _fds);
+      if (sent >= 0) {
+        // The file descriptors are passed with the first byte sent.
+        result.second += static_cast<std::size_t>(sent);
+        _fds.clear();
+      } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return false;
+      } else if (errno != EINTR) {
+        result.first = last_system_error();
+        return true;
+      }
+    }
+
+    return true;
+  }
+
+  template <class Handler> void async_wait(Handler &&handler) {
+    _socket.async_wait(Socket::wait_write, std::forward<Handler>(handler));
+  }
+
+private:
+  Socket &_socket;
+  boost::asio::const_buffer _buffer;
+  std::vector<int> _fds;
+};
+
+/// A transfer receiving data and file descriptors over a Unix domain socket, see async_receive_fds.
+template <class Socket> class receive_fds_transfer {
+public:
+  receive_fds_transfer(Socket &socket, boost::asio::mutable_buffer buffer, std::vector<int> &fds,
+                       std::size_t max_fds)
+      : _socket(socket), _buffer(buffer), _fds(fds), _max_fds(max_fds) {}
+
+  auto get_executor() { return _socket.get_executor(); }
+
+  bool step(async_transfer_result &result) {
+    while (true) {
+      auto truncated = false;
+      const auto received =
+          receive_with_fds(_socket.native_handle(), _buffer.data(), _buffer.size(), _fds, _max_fds, truncated);
+      if (received > 0) {
+        result.second = static_cast<std::size_t>(received);
+        if (truncated) {
+          result.first = boost::asio::error::message_size;
+        }
+
+        return true;
+      }
+
+      if (received == 0) {
+        result.first = boost::asio::error::eof;
+        return true;
+      }
+
+      if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return false;
+      }
+
+      if (errno != EINTR) {
+        result.first = last_system_error();
+        return true;
+      }
+    }
+  }
+
+  template <class Handler> void async_wait(Handler &&handler) {
+    _socket.async_wait(Socket::wait_read, std::forward<Handler>(handler));
+  }
+
+private:
+  Socket &_socket;
+  boost::asio::mutable_buffer _buffer;
+  std::vector<int> &_fds;
+  std::size_t _max_fds;
+};
+} // namespace detail
+
+/// Returns an awaitable that sends the specified data and passes the specified file descriptors along with it over
+/// the specified Unix domain socket, as SCM_RIGHTS ancillary data. The receiving process gets duplicates of the file
+/// descriptors, which refer to the same open files, sockets or pipes, so e.g. a listening socket keeps its backlog.
+///
+/// The file descriptors are passed with the first byte of the data, so the data must not be empty if there are any.
+/// The awaiting coroutine is suspended until the socket becomes writable every time its buffer is full, until all the
+/// data is sent. The file descriptors remain open in the sending process.
+///
+/// The awaitable returns a value of type async_transfer_result.
+///
+/// \param socket   A connected Unix domain socket, e.g. boost::asio::local::stream_protocol::socket.
+/// \param buffer   The data to send.
+/// \param fds      The file descriptors to pass, up to 253 of them.
+template <class Socket, class ConstBuffer>
+auto async_send_fds(Socket &socket, const ConstBuffer &buffer, std::vector<int> fds) {
+  return detail::async_transfer(
+      detail::send_fds_transfer<Socket>(socket, boost::asio::const_buffer(buffer), std::move(fds)));
+}
+
+/// Returns an awaitable that receives some data and the file descriptors passed along with it over the specified Unix
+/// domain socket, see async_send_fds. The awaiting coroutine is suspended until the socket becomes readable if there is
+/// no data to receive.
+///
+/// The received file descriptors are appended to the specified vector with the close-on-exec flag set, and the caller
+/// becomes responsible for closing them. If the message has had more file descriptors than the maximum, the rest are
+/// closed by the kernel, and the transfer fails with boost::asio::error::message_size after receiving the data.
+///
+/// The awaitable returns a value of type async_transfer_result.
+///
+/// \param socket   A connected Unix domain socket, e.g. boost::asio::local::stream_protocol::socket.
+/// \param buffer   The buffer to receive the data into, which must not be empty.
+/// \param fds      The vector to append the received file descriptors to.
+/// \param max_fds  The maximum amount of file descriptors to receive.
+template <class Socket, class MutableBuffer>
+auto async_receive_fds(Socket &socket, const MutableBuffer &buffer, std::vector<int> &fds,
+                       std::size_t max_fds = detail::max_passed_fds) {
+  return detail::async_transfer(
+      detail::receive_fds_transfer<Socket>(socket, boost::asio::mutable_buffer(buffer), fds, max_fds));
+}
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_ASYNC_SEND_FDS_HPP
@@ -0,0 +1,268 @@
+#ifndef ASIO_CORO_EXTENSIONS_ASYNC_SENDFILE_HPP
+#define ASIO_CORO_EXTENSIONS_ASYNC_SENDFILE_HPP
+
+#include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/scope_exit.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/sendfile.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace asio_coro {
+/// The result of a zero-copy transfer: the error occurred if any, and the amount of bytes transferred. The amount is
+/// meaningful even if the transfer fails, e.g. when the source ends before the requested amount of bytes is transferred
+/// the error is boost::asio::error::eof and the amount is the amount of bytes the source had.
+using async_transfer_result = std::pair<boost::system::error_code, std::size_t>;
+
+namespace detail {
+/// The maximum amount of bytes transferred by one sendfile or splice call, which is the limit of a single call of the
+/// Linux kernel.
+constexpr std::size_t max_transfer_size = 0x7ffff000;
+
+/// Returns the file descriptor of the specified file, which is either a file descriptor itself or an object having
+/// one, e.g. random_access_file or boost::asio::posix::stream_descriptor.
+inline int native_handle_of(int file) noexcept { return file; }
+
+template <class File> int native_handle_of(File &file) noexcept { return file.native_handle(); }
+
+/// Returns an error code corresponding to the errno value.
+inline boost::system::error_code last_system_error() noexcept {
+  return boost::system::error_code(errno, boost::system::system_category());
+}
+
+/// Returns an awaitable that repeats the specified non-blocking transfer until it's complete, waiting for the readiness
+/// of the file descriptor blocking the transfer in between. The transfer is attempted right away, so the awaiting
+/// coroutine isn't suspended if the transfer doesn't block.
+///
+/// The epoll reactor re-registers the descriptor whenever a wait is queued on it, which reports the readiness the
+/// descriptor already has, so a readiness event consumed by another thread running the io_context between a blocked
+/// call and the wait doesn't leave the wait hanging, and the transfer needn't be retried after the wait is queued.
+///
+/// The Transfer must provide the following member functions:
+///  - bool step(async_transfer_result &result), which makes system calls until the transfer is complete or fails, and
+///    returns true, or until a call would block, and returns false;
+///  - void async_wait(Handler &&handler), which waits for the readiness the transfer is blocked on;
+///  - get_executor(), which returns the executor of the I/O object.
+template <class Transfer> auto async_transfer(Transfer transfer) {
+  class awaitable {
+  public:
+    explicit awaitable(Transfer transfer) : _transfer(std::move(transfer)) {}
+
+    bool await_ready() { return _transfer.step(_result); }
+
+    async_transfer_result await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      wait(detail::get_executor(_executor, _transfer), detail::coroutine_holder<>(continuation));
+    }
+
+  private:
+    Transfer _transfer;
+    async_transfer_result _result;
+    detail::executor_type _executor;
+
+    void wait(detail::executor_type executor, detail::coroutine_holder<> holder) {
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, executor, holder = std::move(holder)](const boost::system::error_code &error) mutable {
+        if (error) {
+          _result.first = error;
+          holder.release().resume();
+          return;
+        }
+
+        if (_transfer.step(_result)) {
+          holder.release().resume();
+          return;
+        }
+
+        wait(std::move(executor), std::move(holder));
+      };
+      _transfer.async_wait(boost::asio::bind_executor(executor, std::move(handler)));
+    }
+  };
+
+  return awaitable(std::move(transfer));
+}
+
+/// Switches the I/O object to the non-blocking mode. Returns false and sets the result error if it fails.
+template <class IoObject> bool make_non_blocking(IoObject &io_object, async_transfer_result &result) {
+  io_object.native_non_blocking(true, result.first);
+  return !result.first;
+}
+
+/// A transfer sending a file to a socket with sendfile, see async_sendfile.
+template <class Socket> class sendfile_transfer {
+public:
+  sendfile_transfer(Socket &socket, int file, std::uint64_t offset, std::size_t size)
+      : _socket(socket), _file(file), _offset(static_cast<off_t>(offset)), _size(size) {}
+
+  auto get_executor() { return _socket.get_executor(); }
+
+  bool step(async_transfer_result &result) {
+    if (!_non_blocking) {
+      if (!make_non_blocking(_socket, result)) {
+        return true;
+      }
+
+      _non_blocking = true;
+    }
+
+    while (result.second != _size) {
+      const auto count = std::min(_size - result.second, max_transfer_size);
+      const auto sent = ::sendfile(_socket.native_handle(), _file, &_offset, count);
+      if (sent > 0) {
+        result.second += static_cast<std::size_t>(sent);
+      } else if (sent == 0) {
+        result.first = boost::asio::error::eof;
+        return true;
+      } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return false;
+      } else if (errno != EINTR) {
+        result.first = last_system_error();
+        return true;
+      }
+    }
+
+    return true;
+  }
+
+  template <class Handler> void async_wait(Handler &&handler) {
+    _socket.async_wait(Socket::wait_write, std::forward<Handler>(handler));
+  }
+
+private:
+  Socket &_socket;
+  int _file;
+  off_t _offset;
+  std::size_t _size;
+  bool _non_blocking = false;
+};
+
+/// A transfer moving data between two file descriptors with splice, see async_splice.
+template <class Source, class Destination> class splice_transfer {
+public:
+  splice_transfer(Source &source, Destination &destination, std::size_t size, bool partial)
+      : _source(source), _destination(destination), _size(size), _partial(partial) {}
+
+  auto get_executor() { return _destination.get_executor(); }
+
+  bool step(async_transfer_result &result) {
+    if (!_non_blocking) {
+      if (!make_non_blocking(_source, result) || !make_non_blocking(_destination, result)) {
+        return true;
+      }
+
+      _non_blocking = true;
+    }
+
+    while (result.second != _size) {
+      const auto count = std::min(_size - result.second, max_transfer_size);
+      const auto moved = ::splice(_source.native_handle(), nullptr, _destination.native_handle(), nullptr, count,
+                                  SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+      if (moved > 0) {
+        result.second += static_cast<std::size_t>(moved);
+        if (_partial) {
+          return true;
+        }
+      } else if (moved == 0) {
+        result.first = boost::asio::error::eof;
+        return true;
+      } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return false;
+      } else if (errno != EINTR) {
+        result.first = last_system_error();
+        return true;
+      }
+    }
+
+    return true;
+  }
+
+  template <class Handler> void async_wait(Handler &&handler) {
+    // splice doesn't tell which side would block, so the source is checked for data without waiting.
+    pollfd source_poll{_source.native_handle(), POLLIN, 0};
+    if (::poll(&source_poll, 1, 0) == 1) {
+      _destination.async_wait(Destination::wait_write, std::forward<Handler>(handler));
+    } else {
+      _source.async_wait(Source::wait_read, std::forward<Handler>(handler));
+    }
+  }
+
+private:
+  Source &_source;
+  Destination &_destination;
+  std::size_t _size;
+  bool _partial;
+  bool _non_blocking = false;
+};
+} // namespace detail
+
+/// Returns an awaitable that sends the specified range of the specified file to the specified socket with sendfile(2),
+/// so the data is copied by the kernel without passing it through user space buffers.
+///
+/// The socket is switched to the non-blocking mode, and the awaiting coroutine is suspended until the socket becomes
+/// writable every time the socket buffer is full. The transfer is complete when all the bytes of the range are sent,
+/// if the file ends before that, the transfer fails with boost::asio::error::eof.
+///
+/// The awaitable returns a value of type async_transfer_result.
+///
+/// \param socket   A connected stream socket.
+/// \param file     The file to send, either a file descriptor or an object having native_handle(), e.g.
+///                 random_access_file. The file must support mmap-like operations, e.g. a regular file.
+/// \param offset   The offset of the range to send.
+/// \param size     The size of the range to send.
+template <class Socket, class File>
+auto async_sendfile(Socket &socket, File &&file, std::uint64_t offset, std::size_t size) {
+  return detail::async_transfer(
+      detail::sendfile_transfer<Socket>(socket, detail::native_handle_of(file), offset, size));
+}
+
+/// Returns an awaitable that moves the specified amount of bytes from the source to the destination with splice(2),
+/// without copying the data to user space. One of the two must be a pipe, so a proxy moves the data from one socket to
+/// another one through an intermediate pipe, see async_splice_some.
+///
+/// Both of the objects are switched to the non-blocking mode. If the transfer blocks, the awaiting coroutine is
+/// suspended until the source becomes readable if it has no data, or until the destination becomes writable otherwise.
+/// If the source ends before the requested amount of bytes is moved, the transfer fails with boost::asio::error::eof.
+///
+/// The awaitable returns a value of type async_transfer_result.
+///
+/// \param source       The object to read data from, e.g. a socket or a boost::asio::posix::stream_descriptor.
+/// \param destination  The object to write data to.
+/// \param size         The amount of bytes to move.
+template <class Source, class Destination>
+auto async_splice(Source &source, Destination &destination, std::size_t size) {
+  return detail::async_transfer(detail::splice_transfer<Source, Destination>(source, destination, size, false));
+}
+
+/// Returns an awaitable that moves up to the specified amount of bytes from the source to the destination with
+/// splice(2), and completes as soon as any data is moved. See async_splice for details.
+///
+/// A proxy splices whatever has arrived from the source socket to a pipe with async_splice_some, and then the same
+/// amount of bytes from the pipe to the destination socket with async_splice.
+///
+/// \param source       The object to read data from.
+/// \param destination  The object to write data to.
+/// \param max_size     The maximum amount of bytes to move.
+template <class Source, class Destination>
+auto async_splice_some(Source &source, Destination &destination, std::size_t max_size) {
+  return detail::async_transfer(detail::splice_transfer<Source, Destination>(source, destination, max_size, true));
+}
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_ASYNC_SENDFILE_HPP
@@ -2,7 +2,9 @@
 #define ASIO_CORO_EXTENSIONS_ASYNC_WAIT_HPP
 
 #include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
 
+#include <boost/asio/bind_executor.hpp>
 #include <boost/scope_exit.hpp>
 #include <boost/system/error_code.hpp>
 
@@ -24,19 +26,25 @@ template <class Timer> auto async_wait(Timer &timer) {
 
     boost::system::error_code await_resume() const noexcept { return _result; }
 
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
     void await_suspend(detail::coroutine_handle<> continuation) {
-      detail::coroutine_holder holder(continuation);
-      BOOST_SCOPE_EXIT_ALL(&holder) { holder.release(); };
+      auto executor = detail::get_executor(_executor, _timer);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
 
-      _timer.async_wait([this, holder = std::move(holder)](const boost::system::error_code &error) mutable {
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error) mutable {
         _result = error;
         holder.release().resume();
-      });
+      };
+      _timer.async_wait(boost::asio::bind_executor(std::move(executor), std::move(handler)));
     }
 
   private:
     Timer &_timer;
     boost::system::error_code _result;
+    detail::executor_type _executor;
   };
 
   return awaitable(timer);
@@ -0,0 +1,79 @@
+#ifndef ASIO_CORO_EXTENSIONS_ASYNC_WAIT_READY_HPP
+#define ASIO_CORO_EXTENSIONS_ASYNC_WAIT_READY_HPP
+
+#include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/scope_exit.hpp>
+#include <boost/system/error_code.hpp>
+
+namespace asio_coro {
+/// Returns an awaitable that suspends the awaiting coroutine until the specified socket is ready in the specified
+/// direction, without transferring any data. See async_wait_readable and async_wait_writable for details.
+///
+/// \param socket     A socket or a posix descriptor, e.g. boost::asio::posix::stream_descriptor, to wait for.
+/// \param wait_type  The readiness to wait for, e.g. boost::asio::socket_base::wait_read for a socket or
+///                   boost::asio::posix::descriptor_base::wait_read for a descriptor.
+template <class Socket> auto async_wait_ready(Socket &socket, typename Socket::wait_type wait_type) {
+  class awaitable {
+  public:
+    explicit awaitable(Socket &socket, typename Socket::wait_type wait_type)
+        : _socket(socket), _wait_type(wait_type) {}
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    boost::system::error_code await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _socket);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error) mutable {
+        _result = error;
+        holder.release().resume();
+      };
+      _socket.async_wait(_wait_type, boost::asio::bind_executor(std::move(executor), std::move(handler)));
+    }
+
+  private:
+    Socket &_socket;
+    typename Socket::wait_type _wait_type;
+    boost::system::error_code _result;
+    detail::executor_type _executor;
+  };
+
+  return awaitable(socket, wait_type);
+}
+
+/// Returns an awaitable that suspends the awaiting coroutine until the specified socket has data to read, or the peer
+/// has closed the connection. No data is read, so the awaiting coroutine doesn't need to hold a read buffer while the
+/// connection is idle.
+///
+/// The socket may be a posix descriptor as well, so a coroutine may wait for kernel objects created by other libraries,
+/// e.g. an eventfd, a timerfd, a signalfd or a pipe to a child process, wrapped into a
+/// boost::asio::posix::stream_descriptor, without a thread blocking on them.
+///
+/// The awaitable returns an instance of boost::system::error_code that contains the operation result.
+///
+/// \param socket   A socket or a posix descriptor to wait for.
+template <class Socket> auto async_wait_readable(Socket &socket) {
+  return async_wait_ready(socket, Socket::wait_read);
+}
+
+/// Returns an awaitable that suspends the awaiting coroutine until data can be written to the specified socket without
+/// blocking.
+///
+/// The awaitable returns an instance of boost::system::error_code that contains the operation result.
+///
+/// \param socket   A socket or a posix descriptor to wait for.
+template <class Socket> auto async_wait_writable(Socket &socket) {
+  return async_wait_ready(socket, Socket::wait_write);
+}
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_ASYNC_WAIT_READY_HPP
@@ -2,7 +2,9 @@
 #define ASIO_CORO_EXTENSIONS_ASYNC_WAIT_SIGNAL_HPP
 
 #include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
 
+#include <boost/asio/bind_executor.hpp>
 #include <boost/scope_exit.hpp>
 #include <boost/system/error_code.hpp>
 
@@ -27,20 +29,25 @@ template <class SignalSet> auto async_wait_signal(SignalSet &signal_set) {
 
     async_wait_signal_result await_resume() const noexcept { return _result; }
 
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
     void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _signal_set);
       detail::coroutine_holder<> holder(continuation);
       BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
 
-      _signal_set.async_wait(
-          [this, holder = std::move(holder)](const boost::system::error_code &error, int signal) mutable {
-            _result = std::make_pair(error, signal);
-            holder.release().resume();
-          });
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error, int signal) mutable {
+        _result = std::make_pair(error, signal);
+        holder.release().resume();
+      };
+      _signal_set.async_wait(boost::asio::bind_executor(std::move(executor), std::move(handler)));
     }
 
   private:
     SignalSet &_signal_set;
     async_wait_signal_result _result;
+    detail::executor_type _executor;
   };
 
   return awaitable(signal_set);
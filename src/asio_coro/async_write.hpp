@@ -2,10 +2,15 @@
 #define ASIO_CORO_EXTENSIONS_ASYNC_WRITE_HPP
 
 #include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
 
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/asio/write_at.hpp>
 #include <boost/scope_exit.hpp>
 #include <boost/system/error_code.hpp>
 
+#include <cstdint>
 #include <utility>
 
 namespace asio_coro {
@@ -18,7 +23,8 @@ using async_write_result = std::pair<boost::system::error_code, std::size_t>;
 /// second item - the amount of bytes written.
 ///
 /// \param stream   A socket to write data into.
-/// \param buffer   A source buffer to read data from.
+/// \param buffer   A source buffer or a buffer sequence to read data from, see make_buffers. All the buffers of a
+///                 sequence are written with one writev call.
 template <class Stream, class Buffer> auto async_write(Stream &stream, const Buffer &buffer) {
   class awaitable {
   public:
@@ -28,21 +34,27 @@ template <class Stream, class Buffer> auto async_write(Stream &stream, const Buf
 
     async_write_result await_resume() const noexcept { return _result; }
 
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
     void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _stream);
       detail::coroutine_holder<> holder(continuation);
       BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
 
-      _stream.async_write_some(_buffer, [this, holder = std::move(holder)](const boost::system::error_code &error,
-                                                                           std::size_t size) mutable {
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                        std::size_t size) mutable {
         _result = std::make_pair(error, size);
         holder.release().resume();
-      });
+      };
+      _stream.async_write_some(_buffer, boost::asio::bind_executor(std::move(executor), std::move(handler)));
     }
 
   private:
     Stream &_stream;
     Buffer _buffer;
     async_write_result _result;
+    detail::executor_type _executor;
   };
 
   return awaitable(stream, buffer);
@@ -55,7 +67,7 @@ template <class Stream, class Buffer> auto async_write(Stream &stream, const Buf
 /// The awaitable returns an instance of async_write_result, see async_write for details.
 ///
 /// \param stream                 A socket to write data into.
-/// \param buffer                 A buffer to read data from.
+/// \param buffer                 A buffer or a buffer sequence to read data from.
 /// \param completion_condition   A write completion condition, see boost::asio::async_read for details.
 template <class Stream, class Buffer, class CompletionCondition>
 auto async_write(Stream &stream, const Buffer &buffer, const CompletionCondition &completion_condition) {
@@ -68,16 +80,21 @@ auto async_write(Stream &stream, const Buffer &buffer, const CompletionCondition
 
     async_write_result await_resume() const noexcept { return _result; }
 
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
     void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _stream);
       detail::coroutine_holder<> holder(continuation);
       BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
 
-      boost::asio::async_write(
-          _stream, _buffer, _completion_condition,
-          [this, holder = std::move(holder)](const boost::system::error_code &error, std::size_t size) mutable {
-            _result = std::make_pair(error, size);
-            holder.release().resume();
-          });
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                        std::size_t size) mutable {
+        _result = std::make_pair(error, size);
+        holder.release().resume();
+      };
+      boost::asio::async_write(_stream, _buffer, _completion_condition,
+                               boost::asio::bind_executor(std::move(executor), std::move(handler)));
     }
 
   private:
@@ -85,10 +102,110 @@ auto async_write(Stream &stream, const Buffer &buffer, const CompletionCondition
     Buffer _buffer;
     CompletionCondition _completion_condition;
     async_write_result _result;
+    detail::executor_type _executor;
   };
 
   return awaitable(stream, buffer, completion_condition);
 }
+
+/// Returns an awaitable that suspends the awaiting coroutine, performs one asynchronous write of the specified buffer
+/// into the specified device at the specified offset, and resumes the awaiting coroutine.
+///
+/// The awaitable returns a value of type async_write_result, see async_write for details.
+///
+/// \param device   A random access device to write data into, e.g. random_access_file.
+/// \param offset   The offset to write data at.
+/// \param buffer   A source buffer or a buffer sequence.
+template <class Device, class Buffer>
+auto async_write_at(Device &device, std::uint64_t offset, const Buffer &buffer) {
+  class awaitable {
+  public:
+    explicit awaitable(Device &device, std::uint64_t offset, const Buffer &buffer)
+        : _device(device), _offset(offset), _buffer(buffer) {}
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    async_write_result await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _device);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                        std::size_t size) mutable {
+        _result = std::make_pair(error, size);
+        holder.release().resume();
+      };
+      _device.async_write_some_at(_offset, _buffer,
+                                  boost::asio::bind_executor(std::move(executor), std::move(handler)));
+    }
+
+  private:
+    Device &_device;
+    std::uint64_t _offset;
+    Buffer _buffer;
+    async_write_result _result;
+    detail::executor_type _executor;
+  };
+
+  return awaitable(device, offset, buffer);
+}
+
+/// Returns an awaitable that suspends the awaiting coroutine, performs one or more writes of the specified buffer into
+/// the specified device at the specified offset upon either the completion condition is met or an error is occurred.
+///
+/// The awaitable returns a value of type async_write_result, see async_write for details.
+///
+/// \param device                   A random access device to write data into, e.g. random_access_file.
+/// \param offset                   The offset to write data at.
+/// \param buffer                   The source data buffer or buffer sequence.
+/// \param completion_condition     The write completion condition. See documentation on boost::asio::async_write_at for
+///                                 details.
+template <class Device, class Buffer, class CompletionCondition>
+auto async_write_at(Device &device, std::uint64_t offset, const Buffer &buffer,
+                   const CompletionCondition &completion_condition) {
+  class awaitable {
+  public:
+    explicit awaitable(Device &device, std::uint64_t offset, const Buffer &buffer,
+                       const CompletionCondition &completion_condition)
+        : _device(device), _offset(offset), _buffer(buffer), _completion_condition(completion_condition) {}
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    async_write_result await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _device);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                        std::size_t size) mutable {
+        _result = std::make_pair(error, size);
+        holder.release().resume();
+      };
+      boost::asio::async_write_at(_device, _offset, _buffer, _completion_condition,
+                                 boost::asio::bind_executor(std::move(executor), std::move(handler)));
+    }
+
+  private:
+    Device &_device;
+    std::uint64_t _offset;
+    Buffer _buffer;
+    CompletionCondition _completion_condition;
+    async_write_result _result;
+    detail::executor_type _executor;
+  };
+
+  return awaitable(device, offset, buffer, completion_condition);
+}
 } // namespace asio_coro
 
 #endif // ASIO_CORO_EXTENSIONS_ASYNC_WRITE_HPP
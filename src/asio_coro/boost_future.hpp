@@ -2,6 +2,7 @@
 #define ASIO_CORO_EXTENSIONS_FUTURE_HPP
 
 #include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
 
 #include <boost/scope_exit.hpp>
 #include <boost/thread/future.hpp>
@@ -9,7 +10,8 @@
 #ifdef BOOST_THREAD_PROVIDES_FUTURE_CONTINUATION
 
 namespace asio_coro {
-/// Returns an awaitable that suspends the awaiting coroutine upon the speicifed future is resolved.
+/// Returns an awaitable that suspends the awaiting coroutine upon the speicifed future is resolved. The coroutine is
+/// resumed on its associated executor if it has one, otherwise it's resumed by the thread that resolves the future.
 ///
 /// The awaitable returns an instance of boost::future<ResultType> that resolves to the result of awaited future.
 ///
@@ -23,19 +25,24 @@ template <class ResultType> auto async_wait_future(boost::future<ResultType> &&f
 
     decltype(auto) await_resume() { return _then_future.get(); }
 
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
     void await_suspend(detail::coroutine_handle<> continuation) {
       detail::coroutine_holder<> holder(continuation);
       BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
 
-      _future.then(boost::launch::sync, [this, holder = std::move(holder)](auto &&future) mutable {
-        _then_future = std::move(future);
-        holder.release().resume();
-      });
+      _future.then(boost::launch::sync,
+                   [this, executor = _executor, holder = std::move(holder)](auto &&future) mutable {
+                     _then_future = std::move(future);
+                     detail::resume_on(executor, holder.release());
+                   });
     }
 
   private:
     boost::future<ResultType> _future;
     boost::future<ResultType> _then_future;
+    detail::executor_type _executor;
   };
 
   return awaitable(std::move(future));
@@ -0,0 +1,330 @@
+#ifndef ASIO_CORO_EXTENSIONS_BUFFER_POOL_HPP
+#define ASIO_CORO_EXTENSIONS_BUFFER_POOL_HPP
+
+#include "detail/buffer_pool.hpp"
+
+#include <boost/asio/buffer.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+
+namespace asio_coro {
+/// A reference-counted handle to a fixed-size buffer taken from a buffer_pool. Copies of the handle share the same
+/// buffer, which is returned to the pool once the last handle is destroyed, so a buffer that has been read into may be
+/// passed on to a write without copying the data. Handles may be copied and destroyed from any thread.
+///
+/// The handle is a mutable buffer sequence of one buffer, so it may be passed to async_read and async_write directly.
+/// The handle size is the amount of bytes it refers to, which is the whole buffer capacity unless it has been resized.
+class pooled_buffer {
+public:
+  using self_type = pooled_buffer;
+  using value_type = boost::asio::mutable_buffer;
+  using const_iterator = const boost::asio::mutable_buffer *;
+
+  /// Default constructor. Creates a pooled_buffer that refers to no buffer.
+  pooled_buffer() noexcept = default;
+
+  /// Copy constructor. Creates one more handle to the buffer other refers to.
+  pooled_buffer(const self_type &other) noexcept : _header(other._header), _buffer(other._buffer) {
+    if (_header) {
+      _header->references.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /// Move constructor. Transfers the buffer reference from other to the newly created pooled_buffer.
+  pooled_buffer(self_type &&other) noexcept : _header(other._header), _buffer(other._buffer) {
+    other._header = nullptr;
+    other._buffer = boost::asio::mutable_buffer();
+  }
+
+  /// Destructor. Returns the buffer to the pool if this is the last handle to it.
+  ~pooled_buffer() { reset(); }
+
+  /// Copy assignment. Releases the buffer this handle refers to, and refers to the buffer other refers to.
+  self_type &operator=(const self_type &other) noexcept {
+    if (this != std::addressof(other)) {
+      *this = self_type(other);
+    }
+
+    return *this;
+  }
+
+  /// Move assignment. Releases the buffer this handle refers to, then transfers the buffer reference from other to this
+  /// pooled_buffer.
+  self_type &operator=(self_type &&other) noexcept {
+    if (this != std::addressof(other)) {
+      reset();
+
+      _header = other._header;
+      _buffer = other._buffer;
+      other._header = nullptr;
+      other._buffer = boost::asio::mutable_buffer();
+    }
+
+    return *this;
+  }
+
+  /// Releases the buffer, returns it to the pool if this was the last handle to it.
+  inline void reset() noexcept;
+
+  /// Returns the pointer to the buffer data.
+  char *data() const noexcept { return static_cast<char *>(_buffer.data()); }
+
+  /// Returns the amount of bytes the handle refers to.
+  std::size_t size() const noexcept { return _buffer.size(); }
+
+  /// Returns the buffer size.
+  inline std::size_t capacity() const noexcept;
+
+  /// Sets the amount of bytes the handle refers to. The size must not exceed the buffer capacity.
+  void resize(std::size_t size) noexcept {
+    assert(size <= capacity());
+    _buffer = boost::asio::mutable_buffer(_buffer.data(), size);
+  }
+
+  /// Checks whether this pooled_buffer refers to a buffer.
+  bool valid() const noexcept { return _header != nullptr; }
+
+  /// Returns the amount of handles that refer to the buffer.
+  std::size_t use_count() const noexcept {
+    return _header ? _header->references.load(std::memory_order_relaxed) : 0;
+  }
+
+  /// Returns the beginning of the buffer sequence.
+  const_iterator begin() const noexcept { return &_buffer; }
+
+  /// Returns the end of the buffer sequence.
+  const_iterator end() const noexcept { return &_buffer + 1; }
+
+private:
+  friend buffer_pool;
+
+  detail::buffer_header *_header = nullptr;
+  boost::asio::mutable_buffer _buffer;
+
+  pooled_buffer(detail::buffer_header *header, std::size_t size) noexcept
+      : _header(header), _buffer(header->data(), size) {
+    _header->references.store(1, std::memory_order_relaxed);
+  }
+};
+
+/// A pool of fixed-size buffers. The pool allocates buffers in slabs, and never returns the memory until destroyed, so
+/// the memory held by the pool is bounded by the peak amount of buffers in use rounded up to the slab size. The pool
+/// must outlive all the buffers taken from it.
+///
+/// Released buffers are put onto a free list of the releasing thread, so threads reuse their own buffers, which are
+/// likely still in the CPU cache, without any synchronization. Free lists that grow beyond the slab size are partially
+/// flushed to the list shared by all threads, which threads with empty free lists refill from.
+class buffer_pool {
+public:
+  /// Constructor. Creates an empty pool of buffers of the specified size.
+  ///
+  /// \param buffer_size        The size of the pooled buffers.
+  /// \param buffers_per_slab   The amount of buffers allocated at once.
+  explicit buffer_pool(std::size_t buffer_size, std::size_t buffers_per_slab = 64)
+      : _buffer_size(buffer_size), _buffers_per_slab(buffers_per_slab) {
+    assert(buffer_size != 0);
+    assert(buffers_per_slab != 0);
+
+    std::lock_guard lock(registry_mutex());
+    _id = ++last_id();
+    registry().emplace(_id, this);
+  }
+
+  buffer_pool(const buffer_pool &) = delete;
+
+  buffer_pool &operator=(const buffer_pool &) = delete;
+
+  /// Destructor. All the buffers must be returned to the pool prior to its destruction.
+  ~buffer_pool() {
+    {
+      std::lock_guard lock(registry_mutex());
+      registry().erase(_id);
+    }
+
+    // The free lists of other threads that refer to this pool are left as is: the pool id is never reused, so they are
+    // merely dropped once evicted.
+    for (auto &list : thread_cache().lists) {
+      if (list.pool_id == _id) {
+        list = detail::buffer_free_list();
+      }
+    }
+
+    for (auto *slab : _slabs) {
+      ::operator delete(slab, std::align_val_t(detail::buffer_alignment));
+    }
+  }
+
+  /// Takes a free buffer from the pool, allocates a new slab if there are no free buffers.
+  pooled_buffer acquire() {
+    auto &list = thread_list();
+    auto *header = list.pop();
+    if (!header) {
+      header = refill(list);
+    }
+
+    return pooled_buffer(header, _buffer_size);
+  }
+
+  /// Returns the size of the pool buffers.
+  std::size_t buffer_size() const noexcept { return _buffer_size; }
+
+  /// Returns the amount of buffers allocated at once.
+  std::size_t buffers_per_slab() const noexcept { return _buffers_per_slab; }
+
+  /// Returns the amount of buffers allocated by the pool.
+  std::size_t size() {
+    std::lock_guard lock(_mutex);
+    return _slabs.size() * _buffers_per_slab;
+  }
+
+private:
+  friend pooled_buffer;
+  friend detail::buffer_thread_cache;
+
+  const std::size_t _buffer_size;
+  const std::size_t _buffers_per_slab;
+  std::uint64_t _id = 0;
+  std::mutex _mutex;
+  std::vector<void *> _slabs;
+  detail::buffer_free_list _shared;
+
+  static std::mutex &registry_mutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
+
+  static std::unordered_map<std::uint64_t, buffer_pool *> &registry() {
+    static std::unordered_map<std::uint64_t, buffer_pool *> pools;
+    return pools;
+  }
+
+  static std::uint64_t &last_id() {
+    static std::uint64_t id = 0;
+    return id;
+  }
+
+  static detail::buffer_thread_cache &thread_cache() {
+    thread_local detail::buffer_thread_cache cache;
+    return cache;
+  }
+
+  /// Returns the distance between neighbouring buffers within a slab.
+  std::size_t stride() const noexcept {
+    return sizeof(detail::buffer_header) + detail::align_buffer_size(_buffer_size);
+  }
+
+  /// Returns the free list of the current thread for this pool, evicts a free list of another pool if needed.
+  detail::buffer_free_list &thread_list() {
+    auto &cache = thread_cache();
+    for (auto &list : cache.lists) {
+      if (list.pool_id == _id) {
+        return list;
+      }
+    }
+
+    auto &list = cache.lists[cache.next_victim];
+    cache.next_victim = (cache.next_victim + 1) % cache.lists.size();
+
+    flush(list);
+    list.pool_id = _id;
+
+    return list;
+  }
+
+  /// Moves a half of the slab worth of buffers from the shared free list to the specified one, allocates a new slab if
+  /// the shared list is empty. Returns a buffer to hand out.
+  detail::buffer_header *refill(detail::buffer_free_list &list) {
+    std::lock_guard lock(_mutex);
+    if (!_shared.head) {
+      allocate_slab();
+    }
+
+    auto *header = _shared.pop();
+
+    const auto count = std::max<std::size_t>(1, _buffers_per_slab / 2);
+    for (std::size_t i = 1; i < count && _shared.head; ++i) {
+      list.push(_shared.pop());
+    }
+
+    return header;
+  }
+
+  /// Allocates a new slab and puts its buffers onto the shared free list. Must be called under the lock.
+  void allocate_slab() {
+    auto *slab = static_cast<char *>(
+        ::operator new(stride() * _buffers_per_slab, std::align_val_t(detail::buffer_alignment)));
+    _slabs.push_back(slab);
+
+    for (auto i = _buffers_per_slab; i != 0; --i) {
+      auto *header = new (slab + (i - 1) * stride()) detail::buffer_header();
+      header->pool = this;
+      _shared.push(header);
+    }
+  }
+
+  /// Returns a released buffer to the free list of the current thread, flushes a half of the list to the shared one if
+  /// the list has grown beyond the slab size.
+  void release(detail::buffer_header *header) {
+    auto &list = thread_list();
+    list.push(header);
+    if (list.size <= _buffers_per_slab) {
+      return;
+    }
+
+    std::lock_guard lock(_mutex);
+    while (list.size > _buffers_per_slab / 2) {
+      _shared.push(list.pop());
+    }
+  }
+
+  /// Moves all the buffers from the specified free list back to the shared list of their pool, unless the pool has
+  /// been destroyed already.
+  static void flush(detail::buffer_free_list &list) {
+    if (list.head) {
+      std::lock_guard registry_lock(registry_mutex());
+      const auto it = registry().find(list.pool_id);
+      if (it != registry().end()) {
+        auto &pool = *it->second;
+
+        std::lock_guard lock(pool._mutex);
+        while (list.head) {
+          pool._shared.push(list.pop());
+        }
+      }
+    }
+
+    list = detail::buffer_free_list();
+  }
+};
+
+inline void pooled_buffer::reset() noexcept {
+  if (_header) {
+    if (_header->references.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      _header->pool->release(_header);
+    }
+
+    _header = nullptr;
+    _buffer = boost::asio::mutable_buffer();
+  }
+}
+
+inline std::size_t pooled_buffer::capacity() const noexcept { return _header ? _header->pool->buffer_size() : 0; }
+} // namespace asio_coro
+
+namespace asio_coro::detail {
+inline buffer_thread_cache::~buffer_thread_cache() {
+  for (auto &list : lists) {
+    buffer_pool::flush(list);
+  }
+}
+} // namespace asio_coro::detail
+
+#endif // ASIO_CORO_EXTENSIONS_BUFFER_POOL_HPP
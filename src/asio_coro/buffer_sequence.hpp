@@ -0,0 +1,56 @@
+#ifndef ASIO_CORO_EXTENSIONS_BUFFER_SEQUENCE_HPP
+#define ASIO_CORO_EXTENSIONS_BUFFER_SEQUENCE_HPP
+
+#include <boost/asio/buffer.hpp>
+#include <boost/container/small_vector.hpp>
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+
+namespace asio_coro {
+/// A buffer sequence that keeps up to N buffers inline and allocates only if more buffers are added. Use it to build
+/// scatter/gather sequences whose length is known only at runtime, e.g. a list of queued messages.
+template <std::size_t N = 8> using const_buffer_vector = boost::container::small_vector<boost::asio::const_buffer, N>;
+
+/// A mutable counterpart of const_buffer_vector.
+template <std::size_t N = 8>
+using mutable_buffer_vector = boost::container::small_vector<boost::asio::mutable_buffer, N>;
+
+namespace detail {
+/// Returns the argument as a plain buffer if it's a buffer already, otherwise makes a buffer over it with
+/// boost::asio::buffer.
+template <class Buffer> auto as_buffer(Buffer &&buffer) noexcept {
+  using buffer_type = std::remove_reference_t<Buffer>;
+  if constexpr (std::is_convertible_v<buffer_type &, boost::asio::mutable_buffer>) {
+    return boost::asio::mutable_buffer(buffer);
+  } else if constexpr (std::is_convertible_v<buffer_type &, boost::asio::const_buffer>) {
+    return boost::asio::const_buffer(buffer);
+  } else {
+    return boost::asio::buffer(buffer);
+  }
+}
+
+template <class Buffer>
+constexpr bool is_mutable_buffer_v =
+    std::is_convertible_v<decltype(as_buffer(std::declval<Buffer>())), boost::asio::mutable_buffer>;
+} // namespace detail
+
+/// Returns a fixed-size buffer sequence of the specified buffers, which is built without any allocation. Passing the
+/// sequence to async_read or async_write reads or writes all the buffers with one readv/writev call, e.g. a header and
+/// a body of a message are written at once without copying them into a contiguous buffer.
+///
+/// The sequence is an std::array of boost::asio::mutable_buffer if every buffer is mutable, and an std::array of
+/// boost::asio::const_buffer otherwise. The sequence only refers to the memory of the buffers without owning it, so
+/// the memory must outlive the sequence and every operation the sequence is passed to.
+///
+/// \param buffers  Buffers, or anything boost::asio::buffer accepts, such as strings, vectors and arrays.
+template <class... Buffers> auto make_buffers(Buffers &&...buffers) noexcept {
+  using buffer_type = std::conditional_t<(detail::is_mutable_buffer_v<Buffers> && ...), boost::asio::mutable_buffer,
+                                         boost::asio::const_buffer>;
+
+  return std::array<buffer_type, sizeof...(Buffers)>{buffer_type(detail::as_buffer(buffers))...};
+}
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_BUFFER_SEQUENCE_HPP
@@ -0,0 +1,254 @@
+#ifndef ASIO_CORO_EXTENSIONS_BUFFERED_STREAM_HPP
+#define ASIO_CORO_EXTENSIONS_BUFFERED_STREAM_HPP
+
+#include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
+#include "detail/find_delimiter.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/scope_exit.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <utility>
+
+namespace asio_coro {
+using buffered_read_result = std::pair<boost::system::error_code, std::string_view>;
+
+/// A read-ahead buffer over a stream for delimiter- and length-based protocols.
+///
+/// Every read from the stream fills all the free space of the buffer, so a line protocol makes one read call per buffer
+/// rather than one per line, and messages are returned as views into the buffer instead of being copied out. A message
+/// stays in the buffer until it's consumed, so the caller parses it in place and calls consume once it's done with it.
+/// The buffer is allocated upon the first read, grows up to the maximum size, and consumed data is compacted away
+/// before the next read, so unconsumed data is always contiguous.
+///
+/// Writes are passed through to the underlying stream, so a buffered_stream can be used with async_write and
+/// coalescing_writer as is. The buffered_stream must outlive all the operations on it, and there mustn't be more than
+/// one read in progress at a time.
+template <class Stream> class buffered_stream {
+public:
+  using executor_type = typename Stream::executor_type;
+
+  /// Constructor. Creates a buffered_stream over the specified stream.
+  ///
+  /// \param stream         A stream to read data from.
+  /// \param initial_size   The size the buffer is allocated with upon the first read.
+  /// \param max_size       The size the buffer may grow up to. It limits the size of a message.
+  explicit buffered_stream(Stream &stream, std::size_t initial_size = 4096, std::size_t max_size = 64 * 1024)
+      : _stream(stream), _initial_size(std::max<std::size_t>(std::min(initial_size, max_size), 1)),
+        _max_size(std::max<std::size_t>(max_size, 1)) {}
+
+  buffered_stream(const buffered_stream &) = delete;
+
+  buffered_stream &operator=(const buffered_stream &) = delete;
+
+  /// Returns the underlying stream.
+  Stream &next_layer() noexcept { return _stream; }
+
+  /// Returns the executor of the underlying stream.
+  executor_type get_executor() { return _stream.get_executor(); }
+
+  /// Returns the data read from the stream but not consumed yet.
+  std::string_view data() const noexcept { return std::string_view(_data.get() + _begin, _end - _begin); }
+
+  /// Returns the amount of bytes read from the stream but not consumed yet.
+  std::size_t size() const noexcept { return _end - _begin; }
+
+  /// Returns the current size of the buffer.
+  std::size_t capacity() const noexcept { return _capacity; }
+
+  /// Returns the size the buffer may grow up to.
+  std::size_t max_size() const noexcept { return _max_size; }
+
+  /// Removes the specified amount of bytes from the beginning of the buffered data. Views returned by the reads stay
+  /// valid until the next read is started.
+  ///
+  /// \param size   The amount of bytes to remove, it's clamped to the amount of buffered bytes.
+  void consume(std::size_t size) noexcept {
+    _begin += std::min(size, this->size());
+    if (_begin == _end) {
+      _begin = 0;
+      _end = 0;
+    }
+  }
+
+  /// Returns an awaitable that reads from the stream until the buffered data contains the specified delimiter, and
+  /// resumes the awaiting coroutine. The awaiting coroutine is not suspended if the delimiter is already buffered.
+  ///
+  /// The awaitable returns a value of type buffered_read_result, where the first item contains the operation result,
+  /// and the second - the view of the buffered data up to and including the delimiter. The view is not consumed. The
+  /// operation fails with boost::asio::error::not_found if the buffer has reached its maximum size without the
+  /// delimiter, and with the read error (e.g. boost::asio::error::eof) if the read fails; the data read so far stays
+  /// buffered in both cases.
+  ///
+  /// \param delimiter  A delimiter to look for. It must stay valid until the operation completes.
+  auto async_read_until(std::string_view delimiter) {
+    return fill([delimiter, scanned = std::size_t(0)](std::string_view data) mutable {
+      const auto position = detail::find_delimiter(data.substr(scanned), delimiter);
+      if (position == std::string_view::npos) {
+        // The data scanned so far can't contain the beginning of the delimiter except for its last few bytes.
+        scanned = data.size() >= delimiter.size() ? data.size() - delimiter.size() + 1 : 0;
+        return position;
+      }
+
+      return scanned + position + delimiter.size();
+    });
+  }
+
+  /// Returns an awaitable that reads from the stream until the buffered data contains the specified delimiter, see the
+  /// string_view overload for details.
+  ///
+  /// \param delimiter  A delimiter to look for.
+  auto async_read_until(char delimiter) {
+    return fill([delimiter, scanned = std::size_t(0)](std::string_view data) mutable {
+      const auto position = detail::find_delimiter(data.substr(scanned), std::string_view(&delimiter, 1));
+      if (position == std::string_view::npos) {
+        scanned = data.size();
+        return position;
+      }
+
+      return scanned + position + 1;
+    });
+  }
+
+  /// Returns an awaitable that reads from the stream until the specified amount of bytes is buffered, and resumes the
+  /// awaiting coroutine. The awaiting coroutine is not suspended if enough data is already buffered.
+  ///
+  /// The awaitable returns a value of type buffered_read_result, where the first item contains the operation result,
+  /// and the second - the view of the first size buffered bytes. The view is not consumed. The operation fails with
+  /// boost::asio::error::not_found if the size exceeds the maximum size of the buffer, and with the read error if the
+  /// read fails.
+  ///
+  /// \param size   The amount of bytes to read.
+  auto async_read_exactly(std::size_t size) {
+    return fill([size](std::string_view) { return size; });
+  }
+
+  /// Returns an awaitable that reads from the stream until a complete message is buffered, and resumes the awaiting
+  /// coroutine. The awaiting coroutine is not suspended if the message is already buffered, so a length-prefixed
+  /// message whose header and body arrive together is read with one read call rather than one per part.
+  ///
+  /// The awaitable returns a value of type buffered_read_result, where the first item contains the operation result,
+  /// and the second - the view of the message. The view is not consumed. The operation fails with
+  /// boost::asio::error::not_found if the message exceeds the maximum size of the buffer, and with the read error if
+  /// the read fails.
+  ///
+  /// \param size_of    A function accepting the buffered data, which returns the size of the message at its beginning,
+  ///                   or std::string_view::npos if more data is needed to tell it, e.g. a part of the header.
+  template <class SizeFunction> auto async_read_message(SizeFunction size_of) { return fill(std::move(size_of)); }
+
+  /// Starts an asynchronous write of the specified buffers to the underlying stream.
+  template <class ConstBufferSequence, class WriteHandler>
+  auto async_write_some(const ConstBufferSequence &buffers, WriteHandler &&handler) {
+    return _stream.async_write_some(buffers, std::forward<WriteHandler>(handler));
+  }
+
+private:
+  Stream &_stream;
+  const std::size_t _initial_size;
+  const std::size_t _max_size;
+  std::unique_ptr<char[]> _data;
+  std::size_t _capacity = 0;
+  std::size_t _begin = 0;
+  std::size_t _end = 0;
+
+  /// Returns an awaitable that reads from the stream until the read is complete according to the condition. The
+  /// condition accepts the buffered data, and returns the size of the message, or npos if it's not known yet.
+  template <class Condition> auto fill(Condition condition) {
+    class awaitable {
+    public:
+      explicit awaitable(buffered_stream &stream, Condition condition)
+          : _stream(stream), _condition(std::move(condition)) {}
+
+      bool await_ready() { return _stream.complete(_condition, _result); }
+
+      buffered_read_result await_resume() const noexcept { return _result; }
+
+      /// Sets the executor the awaiting coroutine is resumed on.
+      void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+      void await_suspend(detail::coroutine_handle<> continuation) {
+        read(detail::get_executor(_executor, _stream._stream), detail::coroutine_holder<>(continuation));
+      }
+
+    private:
+      buffered_stream &_stream;
+      Condition _condition;
+      buffered_read_result _result;
+      detail::executor_type _executor;
+
+      void read(detail::executor_type executor, detail::coroutine_holder<> holder) {
+        BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+        auto handler = [this, executor, holder = std::move(holder)](const boost::system::error_code &error,
+                                                                    std::size_t size) mutable {
+          _stream._end += size;
+          if (_stream.complete(_condition, _result)) {
+            holder.release().resume();
+            return;
+          }
+
+          if (error) {
+            _result = buffered_read_result(error, {});
+            holder.release().resume();
+            return;
+          }
+
+          read(std::move(executor), std::move(holder));
+        };
+        _stream._stream.async_read_some(_stream.prepare(), boost::asio::bind_executor(executor, std::move(handler)));
+      }
+    };
+
+    return awaitable(*this, std::move(condition));
+  }
+
+  /// Checks whether the read is complete according to the condition, and sets the result if it is.
+  template <class Condition> bool complete(Condition &condition, buffered_read_result &result) {
+    const auto size = condition(data());
+    if (size <= this->size()) {
+      result = buffered_read_result({}, data().substr(0, size));
+      return true;
+    }
+
+    if (this->size() >= _max_size || (size != std::string_view::npos && size > _max_size)) {
+      result = buffered_read_result(boost::asio::error::not_found, {});
+      return true;
+    }
+
+    return false;
+  }
+
+  /// Returns the free space of the buffer to read into. Consumed data is compacted away if the free space at the end
+  /// runs low, and the buffer grows if it's full.
+  boost::asio::mutable_buffer prepare() {
+    if (_capacity - _end <= _capacity / 4 && _begin != 0) {
+      std::memmove(_data.get(), _data.get() + _begin, _end - _begin);
+      _end -= _begin;
+      _begin = 0;
+    }
+
+    if (_end == _capacity) {
+      const auto capacity = _capacity == 0 ? _initial_size : std::min(_capacity * 2, _max_size);
+      std::unique_ptr<char[]> data(new char[capacity]);
+      if (_end != 0) {
+        std::memcpy(data.get(), _data.get(), _end);
+      }
+
+      _data = std::move(data);
+      _capacity = capacity;
+    }
+
+    return boost::asio::mutable_buffer(_data.get() + _end, _capacity - _end);
+  }
+};
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_BUFFERED_STREAM_HPP
@@ -0,0 +1,273 @@
+#ifndef ASIO_CORO_EXTENSIONS_COALESCING_WRITER_HPP
+#define ASIO_CORO_EXTENSIONS_COALESCING_WRITER_HPP
+
+#include "buffer_pool.hpp"
+#include "buffer_sequence.hpp"
+#include "detail/coroutine.hpp"
+#include "detail/executor.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <deque>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace asio_coro {
+/// A write queue of a stream, which lets many coroutines write messages to the same stream without interleaving them
+/// and without waiting for each other.
+///
+/// Writers put their messages to the queue and go on. The first message queued within a reactor turn posts a flush,
+/// which writes all the messages queued by then with one gathered write, so writers that fan out a message to many
+/// streams, or many writers of the same stream, make one writev call per stream instead of one per message. Writers are
+/// suspended while the amount of queued bytes exceeds the high-water mark, which bounds the memory held by the queue if
+/// the peer doesn't keep up.
+///
+/// The writer owns the queued messages until they're written, so messages are passed either as a pooled_buffer, which
+/// lets a message be shared by many writers without copying, or as a string moved into the queue. All the writers must
+/// share the same strand, and the coalescing_writer must outlive all the operations on it, so await async_flush prior
+/// to its destruction.
+template <class Stream> class coalescing_writer {
+public:
+  /// The maximum amount of messages written with one gathered write.
+  static constexpr std::size_t max_gathered_messages = 64;
+
+  /// Constructor. Creates an empty queue of the specified stream.
+  ///
+  /// \param stream             A stream to write messages into.
+  /// \param high_water_mark    The amount of queued bytes writers are suspended beyond.
+  explicit coalescing_writer(Stream &stream, std::size_t high_water_mark = 64 * 1024)
+      : _stream(stream), _high_water_mark(high_water_mark) {}
+
+  coalescing_writer(const coalescing_writer &) = delete;
+
+  coalescing_writer &operator=(const coalescing_writer &) = delete;
+
+  /// Destructor. There mustn't be any messages queued upon the writer destruction.
+  ~coalescing_writer() {
+    assert(!_flushing);
+    assert(_writers.empty());
+    assert(_flushers.empty());
+  }
+
+  /// Returns an awaitable that queues the specified message, and suspends the awaiting coroutine only if the queue has
+  /// exceeded the high-water mark, until it drops back below the mark.
+  ///
+  /// The awaitable returns an instance of boost::system::error_code, which contains the error the last failed write
+  /// has completed with. Once a write has failed, all the queued messages are dropped and new ones are not queued.
+  ///
+  /// \param message  A message to write.
+  auto async_write(pooled_buffer message) { return enqueue(entry{std::move(message), {}}); }
+
+  /// Returns an awaitable that queues the specified message, see the pooled_buffer overload for details.
+  ///
+  /// \param message  A message to write.
+  auto async_write(std::string message) { return enqueue(entry{{}, std::move(message)}); }
+
+  /// Returns an awaitable that queues the specified header followed by the specified message, so no other message gets
+  /// in between them, and they're written with the same gathered write without copying them together. See the
+  /// single-message overload for details.
+  ///
+  /// \param header   A header of the message, e.g. its length. Short headers are kept inline by the string.
+  /// \param message  A message to write.
+  auto async_write(std::string header, pooled_buffer message) {
+    return enqueue(entry{{}, std::move(header)}, entry{std::move(message), {}});
+  }
+
+  /// Returns an awaitable that queues the specified header followed by the specified message, see the pooled_buffer
+  /// overload for details.
+  ///
+  /// \param header   A header of the message.
+  /// \param message  A message to write.
+  auto async_write(std::string header, std::string message) {
+    return enqueue(entry{{}, std::move(header)}, entry{{}, std::move(message)});
+  }
+
+  /// Returns an awaitable that suspends the awaiting coroutine until all the queued messages are written.
+  ///
+  /// The awaitable returns an instance of boost::system::error_code, see async_write for details.
+  auto async_flush() {
+    class awaitable {
+    public:
+      explicit awaitable(coalescing_writer &writer) : _writer(writer) {}
+
+      /// Sets the executor the awaiting coroutine is resumed on.
+      void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+      bool await_ready() const noexcept { return !_writer._flushing; }
+
+      boost::system::error_code await_resume() const noexcept { return _writer._error; }
+
+      void await_suspend(detail::coroutine_handle<> continuation) {
+        _writer._flushers.push_back(waiter{continuation, std::move(_executor)});
+      }
+
+    private:
+      coalescing_writer &_writer;
+      detail::executor_type _executor;
+    };
+
+    return awaitable(*this);
+  }
+
+  /// Returns the amount of bytes queued.
+  std::size_t queued_size() const noexcept { return _queued_size; }
+
+  /// Returns the amount of gathered writes started so far, each of which is one write_some call on the stream.
+  std::size_t writes() const noexcept { return _writes; }
+
+  /// Returns the error the last failed write has completed with.
+  boost::system::error_code error() const noexcept { return _error; }
+
+private:
+  /// A queued message.
+  struct entry {
+    pooled_buffer pooled;
+    std::string owned;
+
+    boost::asio::const_buffer buffer() const noexcept {
+      return pooled.valid() ? boost::asio::const_buffer(pooled.data(), pooled.size())
+                            : boost::asio::const_buffer(owned.data(), owned.size());
+    }
+  };
+
+  /// A suspended coroutine.
+  struct waiter {
+    detail::coroutine_handle<> continuation;
+    detail::executor_type executor;
+  };
+
+  Stream &_stream;
+  const std::size_t _high_water_mark;
+  std::deque<entry> _queue;
+  std::size_t _queued_size = 0;
+  std::size_t _offset = 0;
+  std::size_t _writes = 0;
+  bool _flushing = false;
+  boost::system::error_code _error;
+  detail::executor_type _flush_executor;
+  std::vector<waiter> _writers;
+  std::vector<waiter> _flushers;
+
+  /// Returns an awaitable that queues the message, and the trailer right after it unless the trailer is empty.
+  auto enqueue(entry message, entry trailer = {}) {
+    class awaitable {
+    public:
+      explicit awaitable(coalescing_writer &writer, entry message, entry trailer)
+          : _writer(writer), _message(std::move(message)), _trailer(std::move(trailer)) {}
+
+      /// Sets the executor the awaiting coroutine is resumed on.
+      void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+      constexpr bool await_ready() const noexcept { return false; }
+
+      boost::system::error_code await_resume() const noexcept { return _writer._error; }
+
+      bool await_suspend(detail::coroutine_handle<> continuation) {
+        if (_writer._error) {
+          return false;
+        }
+
+        auto executor = detail::get_executor(_executor, _writer._stream);
+        _writer.push(std::move(_message), executor);
+        _writer.push(std::move(_trailer), std::move(executor));
+        if (_writer._queued_size <= _writer._high_water_mark) {
+          return false;
+        }
+
+        _writer._writers.push_back(waiter{continuation, std::move(_executor)});
+        return true;
+      }
+
+    private:
+      coalescing_writer &_writer;
+      entry _message;
+      entry _trailer;
+      detail::executor_type _executor;
+    };
+
+    return awaitable(*this, std::move(message), std::move(trailer));
+  }
+
+  /// Queues the message unless it's empty, and posts a flush if there is no flush in progress yet.
+  void push(entry message, detail::executor_type executor) {
+    if (message.buffer().size() == 0) {
+      return;
+    }
+
+    _queued_size += message.buffer().size();
+    _queue.push_back(std::move(message));
+    if (_flushing) {
+      return;
+    }
+
+    _flushing = true;
+    _flush_executor = std::move(executor);
+    boost::asio::post(_flush_executor, [this]() { flush(); });
+  }
+
+  /// Writes the queued messages with one gathered write. The stream's write_some is called directly, because composed
+  /// writes split buffer sequences into chunks of 16 buffers.
+  void flush() {
+    const auto count = std::min(_queue.size(), max_gathered_messages);
+
+    const_buffer_vector<max_gathered_messages> buffers;
+    buffers.push_back(_queue.front().buffer() + _offset);
+    for (std::size_t i = 1; i != count; ++i) {
+      buffers.push_back(_queue[i].buffer());
+    }
+
+    ++_writes;
+
+    auto handler = [this](const boost::system::error_code &error, std::size_t size) { on_written(error, size); };
+    _stream.async_write_some(buffers, boost::asio::bind_executor(_flush_executor, std::move(handler)));
+  }
+
+  /// Drops the written messages, and either starts the next write, or resumes the flushers if the queue is empty.
+  /// Writers are resumed once the queue drops below the high-water mark.
+  void on_written(const boost::system::error_code &error, std::size_t size) {
+    std::vector<waiter> resumed;
+    if (error) {
+      _error = error;
+      _queue.clear();
+      _queued_size = 0;
+      _offset = 0;
+    } else {
+      _queued_size -= size;
+
+      // The last message written may have been written partially, so the next write continues from the offset.
+      size += _offset;
+      while (size != 0 && size >= _queue.front().buffer().size()) {
+        size -= _queue.front().buffer().size();
+        _queue.pop_front();
+      }
+      _offset = size;
+    }
+
+    if (_queued_size <= _high_water_mark) {
+      resumed = std::move(_writers);
+      _writers.clear();
+    }
+
+    if (_queue.empty()) {
+      _flushing = false;
+      resumed.insert(resumed.end(), _flushers.begin(), _flushers.end());
+      _flushers.clear();
+    } else {
+      flush();
+    }
+
+    // The resumed coroutines may destroy the writer, so it mustn't be accessed any more.
+    for (auto &item : resumed) {
+      detail::resume_on(item.executor, item.continuation);
+    }
+  }
+};
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_COALESCING_WRITER_HPP
@@ -0,0 +1,548 @@
+#ifndef ASIO_CORO_EXTENSIONS_CONNECTION_POOL_HPP
+#define ASIO_CORO_EXTENSIONS_CONNECTION_POOL_HPP
+
+#include "detail/coroutine.hpp"
+#include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/scope_exit.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace asio_coro {
+namespace detail {
+/// A coroutine acquiring a connection from a connection pool, see connection_pool::acquire.
+template <class Socket> struct connection_pool_request {
+  typename Socket::endpoint_type endpoint;
+  coroutine_handle<> continuation;
+  executor_type executor;
+  boost::system::error_code error;
+  std::optional<Socket> socket;
+  bool reused = false;
+  bool queued = false;
+};
+
+/// The state of a connection pool shared by the pool, the connections leased out and the idle timer handler, so that
+/// the connections may be returned after the pool is closed. All the members are guarded by the mutex.
+template <class Socket>
+class connection_pool_state : public std::enable_shared_from_this<connection_pool_state<Socket>> {
+public:
+  using endpoint_type = typename Socket::endpoint_type;
+  using clock_type = std::chrono::steady_clock;
+  using duration = clock_type::duration;
+  using request_type = connection_pool_request<Socket>;
+
+  /// The way an acquisition proceeds.
+  enum class acquisition {
+    /// The request is complete: it has got an idle connection or an error.
+    complete,
+    /// The request has got a slot and has to connect.
+    connect,
+    /// The request waits for a connection to be released.
+    queued,
+  };
+
+  template <class Executor>
+  connection_pool_state(const Executor &executor, std::size_t max_size, std::size_t max_idle_per_endpoint,
+                        duration idle_timeout)
+      : _executor(executor), _max_size(max_size), _max_idle_per_endpoint(max_idle_per_endpoint),
+        _idle_timeout(idle_timeout), _timer(_executor) {}
+
+  std::size_t size() const {
+    std::lock_guard lock(_mutex);
+    return _size;
+  }
+
+  std::size_t idle_size() const {
+    std::lock_guard lock(_mutex);
+    return _idle_size;
+  }
+
+  /// Hands an idle connection to the endpoint to the request, or reserves a slot for a new connection, evicting the
+  /// longest idle connection to another endpoint if the pool is full, or queues the request otherwise.
+  acquisition acquire(request_type &request) {
+    std::lock_guard lock(_mutex);
+    if (_closed) {
+      request.error = boost::asio::error::operation_aborted;
+      return acquisition::complete;
+    }
+
+    const auto it = _idle.find(request.endpoint);
+    if (it != _idle.end()) {
+      auto &connections = it->second;
+      const auto now = clock_type::now();
+      while (!connections.empty()) {
+        // The most recently used connection is reused first, so the rarely used ones expire.
+        auto connection = std::move(connections.back());
+        connections.pop_back();
+        --_idle_size;
+        if (connection.idle_since + _idle_timeout > now && is_healthy(connection.socket)) {
+          request.socket.emplace(std::move(connection.socket));
+          request.reused = true;
+          break;
+        }
+
+        --_size;
+      }
+
+      if (connections.empty()) {
+        _idle.erase(it);
+      }
+
+      if (request.socket) {
+        return acquisition::complete;
+      }
+    }
+
+    if (_size < _max_size) {
+      ++_size;
+      return acquisition::connect;
+    }
+
+    if (evict_oldest()) {
+      return acquisition::connect;
+    }
+
+    request.queued = true;
+    _waiters.push_back(&request);
+    return acquisition::queued;
+  }
+
+  /// Connects the request socket to the request endpoint, and resumes the request coroutine once it's connected. The
+  /// slot is released if the connection fails.
+  void connect(request_type &request, coroutine_holder<> holder) {
+    BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+    auto &socket = request.socket.emplace(_executor);
+    auto executor = get_executor(request.executor, socket);
+    auto handler = [self = this->shared_from_this(), &request,
+                    holder = std::move(holder)](const boost::system::error_code &error) mutable {
+      if (error) {
+        request.error = error;
+        request.socket.reset();
+        self->release_slot();
+      }
+
+      holder.release().resume();
+    };
+    socket.async_connect(request.endpoint, boost::asio::bind_executor(std::move(executor), std::move(handler)));
+  }
+
+  /// Removes the request from the queue, if it's still there.
+  void cancel(request_type &request) {
+    std::lock_guard lock(_mutex);
+    if (request.queued) {
+      std::erase(_waiters, &request);
+      request.queued = false;
+    }
+  }
+
+  /// Returns the connection to the pool, which hands it to a request waiting for a connection to the same endpoint if
+  /// any, and keeps it idle otherwise. The connection is closed if it's unusable or the pool can't keep it.
+  void release(Socket socket, const endpoint_type &endpoint, bool reusable) {
+    request_type *request = nullptr;
+    {
+      std::lock_guard lock(_mutex);
+      reusable = reusable && !_closed && socket.is_open();
+      if (reusable) {
+        const auto it = std::find_if(_waiters.begin(), _waiters.end(),
+                                     [&](const request_type *waiter) { return waiter->endpoint == endpoint; });
+        if (it != _waiters.end()) {
+          request = *it;
+          _waiters.erase(it);
+          request->queued = false;
+          request->socket.emplace(std::move(socket));
+          request->reused = true;
+        } else if (_waiters.empty()) {
+          reusable = keep_idle(std::move(socket), endpoint);
+        } else {
+          reusable = false;
+        }
+      }
+
+      if (!reusable) {
+        request = release_slot_locked();
+      }
+    }
+
+    if (request && request->socket) {
+      resume_on(request->executor, request->continuation);
+    } else if (request) {
+      connect(*request, coroutine_holder<>(request->continuation));
+    }
+  }
+
+  /// Closes the idle connections and fails the queued requests with operation_aborted error. The connections leased out
+  /// are closed upon release.
+  void close() {
+    std::deque<request_type *> waiters;
+    {
+      std::lock_guard lock(_mutex);
+      _closed = true;
+      _size -= _idle_size;
+      _idle_size = 0;
+      _idle.clear();
+      _timer.cancel();
+      waiters.swap(_waiters);
+    }
+
+    for (auto request : waiters) {
+      request->queued = false;
+      request->error = boost::asio::error::operation_aborted;
+      resume_on(request->executor, request->continuation);
+    }
+  }
+
+private:
+  /// A connection kept open for reuse.
+  struct idle_connection {
+    Socket socket;
+    clock_type::time_point idle_since;
+  };
+
+  mutable std::mutex _mutex;
+  executor_type _executor;
+  std::size_t _max_size;
+  std::size_t _max_idle_per_endpoint;
+  duration _idle_timeout;
+  boost::asio::steady_timer _timer;
+  bool _timer_armed = false;
+  bool _closed = false;
+  std::size_t _size = 0;
+  std::size_t _idle_size = 0;
+  std::map<endpoint_type, std::deque<idle_connection>> _idle;
+  std::deque<request_type *> _waiters;
+
+  /// Returns whether the idle connection is still usable: the peer hasn't closed it, and there is no unexpected data
+  /// the next request would be confused by.
+  static bool is_healthy(Socket &socket) noexcept {
+    char byte;
+    const auto received = ::recv(socket.native_handle(), &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    return received == -1 && (errno == EAGAIN || errno == EWOULDBLOCK);
+  }
+
+  /// Keeps the connection idle unless the endpoint already has the maximum amount of idle connections. Returns whether
+  /// the connection is kept.
+  bool keep_idle(Socket socket, const endpoint_type &endpoint) {
+    auto &connections = _idle[endpoint];
+    if (connections.size() >= _max_idle_per_endpoint) {
+      if (connections.empty()) {
+        _idle.erase(endpoint);
+      }
+
+      return false;
+    }
+
+    connections.push_back(idle_connection{std::move(socket), clock_type::now()});
+    ++_idle_size;
+    arm_timer();
+
+    return true;
+  }
+
+  /// Closes the connection that has been idle for the longest time, so its slot may be used for another endpoint.
+  /// Returns false if there are no idle connections.
+  bool evict_oldest() {
+    auto oldest = _idle.end();
+    for (auto it = _idle.begin(); it != _idle.end(); ++it) {
+      if (oldest == _idle.end() || it->second.front().idle_since < oldest->second.front().idle_since) {
+        oldest = it;
+      }
+    }
+
+    if (oldest == _idle.end()) {
+      return false;
+    }
+
+    oldest->second.pop_front();
+    if (oldest->second.empty()) {
+      _idle.erase(oldest);
+    }
+
+    --_idle_size;
+    return true;
+  }
+
+  /// Releases the slot of a closed connection. Returns the first queued request, which takes the slot over and has to
+  /// connect, if there is any.
+  request_type *release_slot_locked() {
+    if (_waiters.empty() || _closed) {
+      --_size;
+      return nullptr;
+    }
+
+    auto request = _waiters.front();
+    _waiters.pop_front();
+    request->queued = false;
+
+    return request;
+  }
+
+  void release_slot() {
+    request_type *request;
+    {
+      std::lock_guard lock(_mutex);
+      request = release_slot_locked();
+    }
+
+    if (request) {
+      connect(*request, coroutine_holder<>(request->continuation));
+    }
+  }
+
+  /// Arms the idle timer to expire the oldest idle connection, unless it's armed already. Connections become idle in
+  /// the order they expire in, so the timer is never armed for a later time than it has to.
+  void arm_timer() {
+    if (_timer_armed || _idle.empty()) {
+      return;
+    }
+
+    auto expires_at = clock_type::time_point::max();
+    for (const auto &[endpoint, connections] : _idle) {
+      expires_at = std::min(expires_at, connections.front().idle_since + _idle_timeout);
+    }
+
+    _timer_armed = true;
+    _timer.expires_at(expires_at);
+    _timer.async_wait([self = this->shared_from_this()](const boost::system::error_code &error) {
+      std::lock_guard lock(self->_mutex);
+      self->_timer_armed = false;
+      if (!error && !self->_closed) {
+        self->expire_idle();
+        self->arm_timer();
+      }
+    });
+  }
+
+  /// Closes the connections that have been idle for the idle timeout.
+  void expire_idle() {
+    const auto now = clock_type::now();
+    for (auto it = _idle.begin(); it != _idle.end();) {
+      auto &connections = it->second;
+      while (!connections.empty() && connections.front().idle_since + _idle_timeout <= now) {
+        connections.pop_front();
+        --_idle_size;
+        --_size;
+      }
+
+      it = connections.empty() ? _idle.erase(it) : std::next(it);
+    }
+  }
+};
+} // namespace detail
+
+/// A pool of client connections reused across requests, so that a request doesn't pay for the connection handshake
+/// when a connection to the same endpoint has been used before.
+///
+/// A coroutine acquires a lease on a connection with acquire(), which returns an idle connection to the endpoint if
+/// there is a healthy one, connects a new one if the pool has fewer connections than its maximum size, and waits for
+/// a connection to be released otherwise. The lease returns the connection to the pool upon destruction. A connection
+/// that has been closed by the peer or has unexpected data pending isn't reused. The pool keeps up to the specified
+/// amount of idle connections per endpoint, and closes the connections that have been idle for the idle timeout with a
+/// single timer shared by all the connections.
+///
+/// The pool may be used by coroutines running on different threads. The connections leased out may outlive the pool,
+/// they're closed upon release then. The idle timer keeps the executor busy while there are idle connections, so the
+/// pool has to be closed or destroyed for io_context::run to return.
+///
+/// \tparam Socket  The connection socket type, e.g. boost::asio::ip::tcp::socket.
+template <class Socket = boost::asio::ip::tcp::socket> class connection_pool {
+public:
+  using endpoint_type = typename Socket::endpoint_type;
+  using duration = std::chrono::steady_clock::duration;
+
+  /// A lease on a pooled connection, which returns the connection to the pool upon destruction.
+  class lease {
+  public:
+    /// Default constructor. Creates a lease that holds no connection.
+    lease() noexcept = default;
+
+    /// Move constructor. Takes over the connection of the other lease.
+    lease(lease &&other) noexcept
+        : _state(std::move(other._state)), _socket(std::move(other._socket)), _endpoint(other._endpoint),
+          _reused(other._reused), _reusable(other._reusable) {
+      other._socket.reset();
+    }
+
+    /// Move assignment. Releases the connection held if any, and takes over the connection of the other lease.
+    lease &operator=(lease &&other) noexcept {
+      if (std::addressof(other) != this) {
+        release();
+        _state = std::move(other._state);
+        _socket = std::move(other._socket);
+        other._socket.reset();
+        _endpoint = other._endpoint;
+        _reused = other._reused;
+        _reusable = other._reusable;
+      }
+
+      return *this;
+    }
+
+    /// Destructor. Returns the connection to the pool.
+    ~lease() { release(); }
+
+    /// Returns true if the lease holds a connection.
+    explicit operator bool() const noexcept { return _socket.has_value(); }
+
+    /// Returns the connection socket.
+    Socket &socket() noexcept {
+      assert(_socket);
+      return *_socket;
+    }
+
+    Socket &operator*() noexcept { return socket(); }
+
+    Socket *operator->() noexcept { return &socket(); }
+
+    /// Returns the endpoint the connection is connected to.
+    const endpoint_type &endpoint() const noexcept { return _endpoint; }
+
+    /// Returns true if the connection has been used before, i.e. it may have been closed by the peer in the meantime.
+    bool reused() const noexcept { return _reused; }
+
+    /// Marks the connection unusable, e.g. after an I/O error or a response the connection can't be reused after, so
+    /// it's closed instead of being returned to the pool.
+    void discard() noexcept { _reusable = false; }
+
+    /// Returns the connection to the pool ahead of the lease destruction.
+    void release() {
+      if (_socket) {
+        auto socket = std::move(*_socket);
+        _socket.reset();
+        _state->release(std::move(socket), _endpoint, _reusable);
+        _state.reset();
+      }
+    }
+
+  private:
+    friend connection_pool;
+
+    std::shared_ptr<detail::connection_pool_state<Socket>> _state;
+    std::optional<Socket> _socket;
+    endpoint_type _endpoint;
+    bool _reused = false;
+    bool _reusable = true;
+
+    lease(std::shared_ptr<detail::connection_pool_state<Socket>> state, Socket socket, const endpoint_type &endpoint,
+          bool reused)
+        : _state(std::move(state)), _socket(std::move(socket)), _endpoint(endpoint), _reused(reused) {}
+  };
+
+  /// The result of acquire: the error occurred if no connection has been acquired, and the lease on the connection.
+  using acquire_result = std::pair<boost::system::error_code, lease>;
+
+  /// Constructor. Creates an empty pool.
+  ///
+  /// \param executor               The executor the connections are created with.
+  /// \param max_size               The maximum amount of connections, including the ones leased out and connecting.
+  /// \param max_idle_per_endpoint  The maximum amount of idle connections kept per endpoint.
+  /// \param idle_timeout           The time idle connections are kept for.
+  template <class Executor>
+  explicit connection_pool(const Executor &executor, std::size_t max_size = 64, std::size_t max_idle_per_endpoint = 8,
+                           duration idle_timeout = std::chrono::seconds(30))
+      : _state(std::make_shared<detail::connection_pool_state<Socket>>(executor, max_size, max_idle_per_endpoint,
+                                                                       idle_timeout)) {}
+
+  connection_pool(const connection_pool &) = delete;
+
+  connection_pool &operator=(const connection_pool &) = delete;
+
+  /// Destructor. Closes the pool.
+  ~connection_pool() { close(); }
+
+  /// Returns the amount of connections, including the ones leased out and connecting.
+  std::size_t size() const { return _state->size(); }
+
+  /// Returns the amount of idle connections.
+  std::size_t idle_size() const { return _state->idle_size(); }
+
+  /// Closes the idle connections, and resumes the coroutines waiting for a connection with operation_aborted error.
+  /// Acquiring a connection after the pool is closed fails with the same error.
+  void close() { _state->close(); }
+
+  /// Returns an awaitable that acquires a lease on a connection to the specified endpoint, and suspends the awaiting
+  /// coroutine only if a new connection has to be established or the pool is full, until there is a connection.
+  ///
+  /// The awaitable returns a value of type acquire_result.
+  ///
+  /// \param endpoint   The endpoint to connect to.
+  auto acquire(const endpoint_type &endpoint) {
+    using state_type = detail::connection_pool_state<Socket>;
+
+    class awaitable {
+    public:
+      explicit awaitable(std::shared_ptr<state_type> state, const endpoint_type &endpoint) : _state(std::move(state)) {
+        _request.endpoint = endpoint;
+      }
+
+      awaitable(awaitable &&other) noexcept = default;
+
+      // The awaiting coroutine may be destroyed without being resumed, e.g. upon io_context destruction.
+      ~awaitable() {
+        if (_state) {
+          _state->cancel(_request);
+        }
+      }
+
+      constexpr bool await_ready() const noexcept { return false; }
+
+      acquire_result await_resume() {
+        if (!_request.socket) {
+          return acquire_result(_request.error, lease());
+        }
+
+        return acquire_result(boost::system::error_code(),
+                              lease(_state, std::move(*_request.socket), _request.endpoint, _request.reused));
+      }
+
+      /// Sets the executor the awaiting coroutine is resumed on.
+      void set_executor(detail::executor_type executor) noexcept { _request.executor = std::move(executor); }
+
+      bool await_suspend(detail::coroutine_handle<> continuation) {
+        _request.continuation = continuation;
+        switch (_state->acquire(_request)) {
+        case state_type::acquisition::complete:
+          return false;
+        case state_type::acquisition::connect:
+          _state->connect(_request, detail::coroutine_holder<>(continuation));
+          return true;
+        case state_type::acquisition::queued:
+          return true;
+        }
+
+        return false;
+      }
+
+    private:
+      std::shared_ptr<state_type> _state;
+      detail::connection_pool_request<Socket> _request;
+    };
+
+    return awaitable(_state, endpoint);
+  }
+
+private:
+  std::shared_ptr<detail::connection_pool_state<Socket>> _state;
+};
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_CONNECTION_POOL_HPP
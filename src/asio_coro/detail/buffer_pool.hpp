@@ -0,0 +1,67 @@
+#ifndef ASIO_CORO_EXTENSIONS_DETAIL_BUFFER_POOL_HPP
+#define ASIO_CORO_EXTENSIONS_DETAIL_BUFFER_POOL_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace asio_coro {
+class buffer_pool;
+} // namespace asio_coro
+
+namespace asio_coro::detail {
+/// The alignment of the pooled buffers, so neighbouring buffers never share a cache line.
+constexpr std::size_t buffer_alignment = 64;
+
+/// Rounds the specified size up to the buffer alignment.
+constexpr std::size_t align_buffer_size(std::size_t size) noexcept {
+  return (size + buffer_alignment - 1) / buffer_alignment * buffer_alignment;
+}
+
+/// The header that precedes every buffer within a slab.
+struct alignas(buffer_alignment) buffer_header {
+  std::atomic<std::size_t> references{0};
+  buffer_pool *pool = nullptr;
+  buffer_header *next = nullptr;
+
+  /// Returns the pointer to the buffer data that follows the header.
+  char *data() noexcept { return reinterpret_cast<char *>(this) + sizeof(buffer_header); }
+};
+
+/// A free list of a thread, that holds the buffers released by the thread back to the pool with the specified id.
+struct buffer_free_list {
+  std::uint64_t pool_id = 0;
+  buffer_header *head = nullptr;
+  std::size_t size = 0;
+
+  /// Pops a buffer off the list, returns nullptr if the list is empty.
+  buffer_header *pop() noexcept {
+    auto *header = head;
+    if (header) {
+      head = header->next;
+      --size;
+    }
+
+    return header;
+  }
+
+  /// Pushes the buffer to the list.
+  void push(buffer_header *header) noexcept {
+    header->next = head;
+    head = header;
+    ++size;
+  }
+};
+
+/// The per-thread free lists of a thread. A thread keeps free lists for a few pools at once, so a thread that reads
+/// into buffers from one pool and writes from another doesn't flush its free lists back and forth.
+struct buffer_thread_cache {
+  std::array<buffer_free_list, 4> lists;
+  std::size_t next_victim = 0;
+
+  inline ~buffer_thread_cache();
+};
+} // namespace asio_coro::detail
+
+#endif // ASIO_CORO_EXTENSIONS_DETAIL_BUFFER_POOL_HPP
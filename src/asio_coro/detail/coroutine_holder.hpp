@@ -45,6 +45,9 @@ public:
     return result;
   }
 
+  /// Returns the associated coroutine handle keeping the ownership over it.
+  CoroutineHandle get() const noexcept { return _coroutine; }
+
   /// Destroys the associated coroutine if any.
   void clear() noexcept {
     if (_coroutine) {
@@ -0,0 +1,77 @@
+#ifndef ASIO_CORO_EXTENSIONS_DETAIL_CRC32C_HPP
+#define ASIO_CORO_EXTENSIONS_DETAIL_CRC32C_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+namespace asio_coro::detail {
+/// The table of the byte-wise software CRC32C, built for the reflected Castagnoli polynomial.
+constexpr std::array<std::uint32_t, 256> crc32c_table = []() {
+  std::array<std::uint32_t, 256> table{};
+  for (std::uint32_t i = 0; i != table.size(); ++i) {
+    auto crc = i;
+    for (auto bit = 0; bit != 8; ++bit) {
+      crc = (crc >> 1) ^ ((crc & 1) ? 0x82f63b78u : 0);
+    }
+
+    table[i] = crc;
+  }
+
+  return table;
+}();
+
+/// Returns the CRC32C of the data computed a byte at a time. The crc is the checksum of the preceding data, so a
+/// checksum may be computed in pieces.
+inline std::uint32_t crc32c_software(const void *data, std::size_t size, std::uint32_t crc = 0) noexcept {
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  crc = ~crc;
+  for (std::size_t i = 0; i != size; ++i) {
+    crc = crc32c_table[(crc ^ bytes[i]) & 0xff] ^ (crc >> 8);
+  }
+
+  return ~crc;
+}
+
+#if defined(__x86_64__)
+/// Returns the CRC32C of the data computed 8 bytes at a time with the crc32 instruction of SSE4.2, see crc32c_software.
+/// Must be called only if the CPU supports SSE4.2.
+__attribute__((target("sse4.2"))) inline std::uint32_t crc32c_hardware(const void *data, std::size_t size,
+                                                                       std::uint32_t crc = 0) noexcept {
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  std::uint64_t state = ~crc;
+  for (; size >= 8; size -= 8, bytes += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, bytes, sizeof(word));
+    state = _mm_crc32_u64(state, word);
+  }
+
+  auto result = static_cast<std::uint32_t>(state);
+  for (; size != 0; --size, ++bytes) {
+    result = _mm_crc32_u8(result, *bytes);
+  }
+
+  return ~result;
+}
+#endif
+
+/// Returns the CRC32C of the data, see crc32c_software. It's computed with SSE4.2 if the CPU supports it, which is
+/// checked at runtime, so the library doesn't have to be built for SSE4.2.
+inline std::uint32_t crc32c(const void *data, std::size_t size, std::uint32_t crc = 0) noexcept {
+#if defined(__x86_64__)
+  static const bool hardware = __builtin_cpu_supports("sse4.2");
+  if (hardware) {
+    return crc32c_hardware(data, size, crc);
+  }
+#endif
+
+  return crc32c_software(data, size, crc);
+}
+} // namespace asio_coro::detail
+
+#endif // ASIO_CORO_EXTENSIONS_DETAIL_CRC32C_HPP
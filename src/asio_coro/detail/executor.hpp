@@ -0,0 +1,63 @@
+#ifndef ASIO_CORO_EXTENSIONS_DETAIL_EXECUTOR_HPP
+#define ASIO_CORO_EXTENSIONS_DETAIL_EXECUTOR_HPP
+
+#include "coroutine_holder.hpp"
+
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/execution_context.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <type_traits>
+#include <utility>
+
+namespace asio_coro::detail {
+/// A type-erased executor tasks and awaitables resume their continuations on.
+using executor_type = boost::asio::any_io_executor;
+
+/// Checks whether the awaitable accepts the executor of the awaiting coroutine.
+template <class Awaitable, class = void> struct has_set_executor : std::false_type {};
+
+template <class Awaitable>
+struct has_set_executor<
+    Awaitable, std::void_t<decltype(std::declval<Awaitable &>().set_executor(std::declval<const executor_type &>()))>>
+    : std::true_type {};
+
+/// Checks whether the executor is a strand.
+template <class Executor> struct is_strand : std::false_type {};
+
+template <class Executor> struct is_strand<boost::asio::strand<Executor>> : std::true_type {};
+
+/// Returns the specified executor if it's not empty, or the executor of the I/O object otherwise.
+template <class IoObject> executor_type get_executor(const executor_type &executor, IoObject &io_object) {
+  if (executor) {
+    return executor;
+  }
+
+  return io_object.get_executor();
+}
+
+/// Returns the default executor for coroutines spawned on the specified executor or execution context: the strand
+/// itself if it's already a strand, a new strand otherwise.
+template <class Executor> executor_type make_default_executor(Executor &executor) {
+  if constexpr (is_strand<std::remove_cv_t<Executor>>::value) {
+    return executor;
+  } else {
+    return boost::asio::make_strand(executor);
+  }
+}
+
+/// Resumes the coroutine on the specified executor. The coroutine is resumed inline if the executor is empty or the
+/// calling thread is already running within the executor (e.g. the same strand), otherwise the resumption is queued.
+inline void resume_on(const executor_type &executor, coroutine_handle<> coroutine) {
+  if (!executor) {
+    coroutine.resume();
+    return;
+  }
+
+  coroutine_holder<> holder(coroutine);
+  boost::asio::dispatch(executor, [holder = std::move(holder)]() mutable { holder.release().resume(); });
+}
+} // namespace asio_coro::detail
+
+#endif // ASIO_CORO_EXTENSIONS_DETAIL_EXECUTOR_HPP
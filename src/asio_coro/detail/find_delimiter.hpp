@@ -0,0 +1,65 @@
+#ifndef ASIO_CORO_EXTENSIONS_DETAIL_FIND_DELIMITER_HPP
+#define ASIO_CORO_EXTENSIONS_DETAIL_FIND_DELIMITER_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace asio_coro::detail {
+/// Returns the position of the first occurrence of the delimiter in the data, or std::string_view::npos if there is
+/// none.
+///
+/// Single character delimiters are looked up with memchr, which is vectorized by the C library. Longer delimiters are
+/// looked up 16 candidate positions at a time: a position is a candidate if both the first and the last character of
+/// the delimiter match, and only the candidates are compared in full, so the scan rarely falls back to byte by byte
+/// comparison even on text with many occurrences of the delimiter's first character.
+inline std::size_t find_delimiter(std::string_view data, std::string_view delimiter) noexcept {
+  if (delimiter.empty()) {
+    return 0;
+  }
+
+  if (delimiter.size() > data.size()) {
+    return std::string_view::npos;
+  }
+
+  if (delimiter.size() == 1) {
+    const auto *position = static_cast<const char *>(std::memchr(data.data(), delimiter.front(), data.size()));
+    return position ? static_cast<std::size_t>(position - data.data()) : std::string_view::npos;
+  }
+
+  auto offset = std::size_t(0);
+
+#if defined(__SSE2__)
+  const auto last_offset = delimiter.size() - 1;
+  const auto candidates_count = data.size() - last_offset;
+  const auto first = _mm_set1_epi8(delimiter.front());
+  const auto last = _mm_set1_epi8(delimiter.back());
+
+  for (; offset + 16 <= candidates_count; offset += 16) {
+    const auto *block = data.data() + offset;
+    const auto first_block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block));
+    const auto last_block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(block + last_offset));
+    auto mask = static_cast<unsigned>(
+        _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, first_block), _mm_cmpeq_epi8(last, last_block))));
+
+    while (mask != 0) {
+      const auto index = static_cast<std::size_t>(__builtin_ctz(mask));
+      if (std::memcmp(block + index + 1, delimiter.data() + 1, delimiter.size() - 2) == 0) {
+        return offset + index;
+      }
+
+      mask &= mask - 1;
+    }
+  }
+#endif
+
+  const auto position = data.substr(offset).find(delimiter);
+  return position == std::string_view::npos ? position : offset + position;
+}
+} // namespace asio_coro::detail
+
+#endif // ASIO_CORO_EXTENSIONS_DETAIL_FIND_DELIMITER_HPP
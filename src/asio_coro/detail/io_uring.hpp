@@ -0,0 +1,188 @@
+#ifndef ASIO_CORO_EXTENSIONS_DETAIL_IO_URING_HPP
+#define ASIO_CORO_EXTENSIONS_DETAIL_IO_URING_HPP
+
+#include "coroutine.hpp"
+#include "executor.hpp"
+
+#include <boost/system/error_code.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace asio_coro::detail {
+/// Throws boost::system::system_error with the specified error number.
+[[noreturn]] inline void throw_system_error(int error, const char *what) {
+  throw boost::system::system_error(boost::system::error_code(error, boost::system::system_category()), what);
+}
+
+/// The submission and completion queues of an io_uring instance mapped into user space.
+///
+/// The queues are accessed with plain loads and stores except for the indices shared with the kernel, which are
+/// accessed with acquire/release semantics as the io_uring ABI requires. The queue is not thread-safe.
+class io_uring_queue {
+public:
+  /// Constructor. Sets up an io_uring instance with the specified amount of submission queue entries. Throws
+  /// boost::system::system_error if io_uring isn't available.
+  explicit io_uring_queue(unsigned entries) {
+    io_uring_params params{};
+    _fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (_fd < 0) {
+      throw_system_error(errno, "io_uring_setup");
+    }
+
+    if ((params.features & IORING_FEAT_SINGLE_MMAP) == 0) {
+      ::close(_fd);
+      throw_system_error(ENOSYS, "io_uring_setup");
+    }
+
+    _ring_size = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                          params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    _sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+
+    auto *const ring = ::mmap(nullptr, _ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd,
+                              static_cast<off_t>(IORING_OFF_SQ_RING));
+    if (ring == MAP_FAILED) {
+      const auto error = errno;
+      ::close(_fd);
+      throw_system_error(error, "mmap");
+    }
+
+    auto *const sqes = ::mmap(nullptr, _sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd,
+                              static_cast<off_t>(IORING_OFF_SQES));
+    if (sqes == MAP_FAILED) {
+      const auto error = errno;
+      ::munmap(ring, _ring_size);
+      ::close(_fd);
+      throw_system_error(error, "mmap");
+    }
+
+    _ring = static_cast<char *>(ring);
+    _sqes = static_cast<io_uring_sqe *>(sqes);
+    _sq_head = reinterpret_cast<unsigned *>(_ring + params.sq_off.head);
+    _sq_tail = reinterpret_cast<unsigned *>(_ring + params.sq_off.tail);
+    _sq_mask = *reinterpret_cast<unsigned *>(_ring + params.sq_off.ring_mask);
+    _sq_entries = params.sq_entries;
+    _cq_head = reinterpret_cast<unsigned *>(_ring + params.cq_off.head);
+    _cq_tail = reinterpret_cast<unsigned *>(_ring + params.cq_off.tail);
+    _cq_mask = *reinterpret_cast<unsigned *>(_ring + params.cq_off.ring_mask);
+    _cqes = reinterpret_cast<io_uring_cqe *>(_ring + params.cq_off.cqes);
+
+    // Submission queue entries are used in order, so the indirection array maps every slot to itself.
+    auto *const array = reinterpret_cast<unsigned *>(_ring + params.sq_off.array);
+    for (unsigned i = 0; i != _sq_entries; ++i) {
+      array[i] = i;
+    }
+
+    _sqe_tail = *_sq_tail;
+    _submitted_tail = _sqe_tail;
+  }
+
+  io_uring_queue(const io_uring_queue &) = delete;
+
+  io_uring_queue &operator=(const io_uring_queue &) = delete;
+
+  /// Destructor. Unmaps the queues and closes the io_uring instance, which cancels the operations in flight.
+  ~io_uring_queue() {
+    ::munmap(_sqes, _sqes_size);
+    ::munmap(_ring, _ring_size);
+    ::close(_fd);
+  }
+
+  /// Returns the io_uring file descriptor.
+  int fd() const noexcept { return _fd; }
+
+  /// Returns a zeroed submission queue entry, or nullptr if the submission queue is full.
+  io_uring_sqe *get_sqe() noexcept {
+    if (_sqe_tail - __atomic_load_n(_sq_head, __ATOMIC_ACQUIRE) == _sq_entries) {
+      return nullptr;
+    }
+
+    auto *const sqe = &_sqes[_sqe_tail & _sq_mask];
+    ++_sqe_tail;
+    std::memset(sqe, 0, sizeof(*sqe));
+
+    return sqe;
+  }
+
+  /// Returns the amount of entries filled but not submitted yet.
+  unsigned pending() const noexcept { return _sqe_tail - _submitted_tail; }
+
+  /// Submits the filled entries with io_uring_enter. Returns the amount of entries consumed by the kernel, or a negated
+  /// error number.
+  int submit() noexcept {
+    __atomic_store_n(_sq_tail, _sqe_tail, __ATOMIC_RELEASE);
+
+    int result;
+    do {
+      result = static_cast<int>(::syscall(__NR_io_uring_enter, _fd, pending(), 0, 0, nullptr, 0));
+    } while (result < 0 && errno == EINTR);
+
+    if (result < 0) {
+      return -errno;
+    }
+
+    _submitted_tail += static_cast<unsigned>(result);
+    return result;
+  }
+
+  /// Calls the function for every completion queue entry posted so far and marks them as seen. Returns the amount of
+  /// entries seen.
+  template <class Function> unsigned reap(Function &&function) {
+    const auto head = *_cq_head;
+    const auto tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+    for (auto index = head; index != tail; ++index) {
+      function(_cqes[index & _cq_mask]);
+    }
+
+    __atomic_store_n(_cq_head, tail, __ATOMIC_RELEASE);
+    return tail - head;
+  }
+
+  /// Checks whether there are completion queue entries not seen yet.
+  bool has_completions() const noexcept { return *_cq_head != __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE); }
+
+  /// Calls io_uring_register. Returns zero or a negated error number.
+  int register_resource(unsigned opcode, const void *argument, unsigned count) noexcept {
+    const auto result = ::syscall(__NR_io_uring_register, _fd, opcode, argument, count);
+    return result < 0 ? -errno : 0;
+  }
+
+private:
+  int _fd = -1;
+  char *_ring = nullptr;
+  std::size_t _ring_size = 0;
+  io_uring_sqe *_sqes = nullptr;
+  std::size_t _sqes_size = 0;
+  unsigned *_sq_head = nullptr;
+  unsigned *_sq_tail = nullptr;
+  unsigned _sq_mask = 0;
+  unsigned _sq_entries = 0;
+  unsigned _sqe_tail = 0;
+  unsigned _submitted_tail = 0;
+  unsigned *_cq_head = nullptr;
+  unsigned *_cq_tail = nullptr;
+  unsigned _cq_mask = 0;
+  io_uring_cqe *_cqes = nullptr;
+};
+
+/// An io_uring operation in flight. Its address is the user data of the submission. The operation is either owned by
+/// an awaitable, and completes by resuming the continuation, or owned by itself, and completes by calling complete.
+struct io_uring_operation {
+  coroutine_handle<> continuation;
+  executor_type executor;
+  void (*complete)(io_uring_operation *operation) = nullptr;
+  int result = 0;
+  std::uint32_t flags = 0;
+};
+} // namespace asio_coro::detail
+
+#endif // ASIO_CORO_EXTENSIONS_DETAIL_IO_URING_HPP
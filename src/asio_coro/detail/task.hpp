@@ -2,6 +2,7 @@
 #define ASIO_CORO_DETAIL_EXTENSIONS_TASK_HPP
 
 #include "coroutine_holder.hpp"
+#include "executor.hpp"
 
 #include <cassert>
 #include <memory>
@@ -44,7 +45,7 @@ public:
 
       constexpr void await_resume() const noexcept {}
 
-      auto await_suspend(coroutine_handle<> continuation) {
+      auto await_suspend(coroutine_handle<> continuation) noexcept {
         assert(continuation);
         assert(_continuation);
 
@@ -77,6 +78,22 @@ public:
     _continuation = continuation;
   }
 
+  /// Sets the executor the coroutine and the awaitables it awaits resume on.
+  void set_executor(executor_type executor) noexcept { _executor = std::move(executor); }
+
+  /// Returns the executor associated with the coroutine. The executor is empty unless the coroutine has been spawned
+  /// with spawn_coroutine or awaited by a coroutine that has one.
+  const executor_type &get_executor() const noexcept { return _executor; }
+
+  /// Passes the executor associated with the coroutine to the awaitable if the awaitable accepts one.
+  template <class Awaitable> Awaitable &&await_transform(Awaitable &&awaitable) noexcept {
+    if constexpr (has_set_executor<std::remove_reference_t<Awaitable>>::value) {
+      awaitable.set_executor(_executor);
+    }
+
+    return std::forward<Awaitable>(awaitable);
+  }
+
   /// Either returns the coroutine return value or throws the captured exception.
   decltype(auto) get_return_value() {
     assert(!std::holds_alternative<none_type>(_value));
@@ -102,6 +119,7 @@ private:
   using none_type = std::monostate;
 
   coroutine_handle<> _continuation;
+  executor_type _executor;
   std::variant<std::monostate, exception_type, value_type> _value;
 };
 
@@ -199,6 +217,14 @@ public:
     return awaitable(_coroutine_holder.release());
   }
 
+  /// Sets the executor the associated coroutine resumes on. A task awaited by another task inherits the executor of the
+  /// awaiting task, so the awaiting task may be resumed directly upon the awaited task completion.
+  void set_executor(executor_type executor) noexcept {
+    assert(_coroutine_holder.valid());
+
+    _coroutine_holder.get().promise().set_executor(std::move(executor));
+  }
+
   /// Releases the ownership over the associated coroutine object.
   coroutine_handle_type release() noexcept { return _coroutine_holder.release(); }
 
@@ -0,0 +1,177 @@
+#ifndef ASIO_CORO_EXTENSIONS_DETAIL_TIMER_POOL_HPP
+#define ASIO_CORO_EXTENSIONS_DETAIL_TIMER_POOL_HPP
+
+#include "executor.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/execution.hpp>
+#include <boost/asio/execution_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <cassert>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace asio_coro::detail {
+/// A pooled timer shared by all the sleepers whose deadlines fall into the same slack window.
+struct pooled_timer {
+  explicit pooled_timer(const executor_type &executor) : timer(executor) {}
+
+  boost::asio::steady_timer timer;
+  std::size_t waiters = 0;
+  bool active = false;
+};
+
+/// An execution context service that owns the timers used by the sleep_for/sleep_until awaitables.
+///
+/// Timers are taken from the free list and returned back once every sleeper awaiting them is resumed, so sleeping
+/// doesn't register a new timer with the timer service each time. Deadlines are rounded up to the slack, and sleepers
+/// whose rounded deadlines are equal share one timer, so the timer queue holds one timer per slack window instead of
+/// one timer per sleeper and the reactor re-arms its timerfd less often.
+class timer_pool_service : public boost::asio::execution_context::service {
+public:
+  using key_type = timer_pool_service;
+  using clock_type = std::chrono::steady_clock;
+  using duration = clock_type::duration;
+
+  inline static boost::asio::execution_context::id id;
+
+  /// Constructor. Creates the service with zero slack.
+  explicit timer_pool_service(boost::asio::execution_context &context) : service(context) {}
+
+  /// Sets the slack deadlines are rounded up to.
+  void set_slack(duration slack) {
+    assert(slack >= duration::zero());
+
+    std::lock_guard lock(_mutex);
+    _slack = slack;
+  }
+
+  /// Returns the deadline the specified one is rounded up to.
+  clock_type::time_point round_deadline(clock_type::time_point deadline) {
+    std::lock_guard lock(_mutex);
+    if (_slack == duration::zero()) {
+      return deadline;
+    }
+
+    const auto since_epoch = deadline.time_since_epoch();
+    const auto remainder = since_epoch % _slack;
+
+    return remainder == duration::zero() ? deadline : deadline + (_slack - remainder);
+  }
+
+  /// Adds a sleeper to the timer expiring at the specified deadline. The handler is invoked on the specified executor
+  /// upon the timer expiration, the sleeper is removed from the timer prior to that.
+  ///
+  /// \param deadline      The deadline of the timer.
+  /// \param io_executor   The executor new timers are created with. It mustn't be a strand, since the timers are
+  ///                      shared by the sleepers of different strands.
+  /// \param executor      The executor the handler is invoked on.
+  /// \param handler       The handler accepting the wait result.
+  template <class Handler>
+  void wait(clock_type::time_point deadline, const executor_type &io_executor, const executor_type &executor,
+            Handler &&handler) {
+    std::lock_guard lock(_mutex);
+
+    auto &timer = _active[deadline];
+    if (!timer) {
+      timer = acquire(io_executor);
+      timer->active = true;
+      timer->timer.expires_at(deadline);
+    }
+
+    ++timer->waiters;
+
+    auto release_handler = [this, timer, handler = std::forward<Handler>(handler)](
+                               const boost::system::error_code &error) mutable {
+      release(timer);
+      handler(error);
+    };
+    timer->timer.async_wait(boost::asio::bind_executor(executor, std::move(release_handler)));
+  }
+
+  /// Returns the amount of timers owned by the service.
+  std::size_t size() {
+    std::lock_guard lock(_mutex);
+    return _timers.size();
+  }
+
+private:
+  std::mutex _mutex;
+  duration _slack = duration::zero();
+  std::vector<std::unique_ptr<pooled_timer>> _timers;
+  std::vector<pooled_timer *> _free;
+  std::map<clock_type::time_point, pooled_timer *> _active;
+
+  /// Destroys the timers while the timer service they're registered with is still alive: the service is created after
+  /// this one, so it's destroyed earlier. The pending waits have been destroyed by the shutdown of the timer service.
+  void shutdown() override {
+    std::lock_guard lock(_mutex);
+    _active.clear();
+    _free.clear();
+    _timers.clear();
+  }
+
+  /// Takes a timer from the free list or creates a new one. Must be called under the lock.
+  pooled_timer *acquire(const executor_type &executor) {
+    if (!_free.empty()) {
+      auto *timer = _free.back();
+      _free.pop_back();
+      return timer;
+    }
+
+    _timers.push_back(std::make_unique<pooled_timer>(executor));
+    return _timers.back().get();
+  }
+
+  /// Removes the expired sleeper from the timer, and returns the timer to the free list if it was the last one.
+  void release(pooled_timer *timer) {
+    std::lock_guard lock(_mutex);
+
+    assert(timer->waiters != 0);
+    if (timer->active) {
+      // The timer has expired, so newcomers mustn't join it any more.
+      _active.erase(timer->timer.expiry());
+      timer->active = false;
+    }
+
+    if (--timer->waiters == 0) {
+      _free.push_back(timer);
+    }
+  }
+};
+
+/// Returns the execution context of the specified executor or the execution context itself.
+template <class Executor> boost::asio::execution_context &get_execution_context(Executor &executor) {
+  if constexpr (std::is_base_of_v<boost::asio::execution_context, Executor>) {
+    return executor;
+  } else {
+    return boost::asio::query(executor, boost::asio::execution::context);
+  }
+}
+
+/// Returns the executor of the specified executor or execution context.
+template <class Executor> executor_type get_io_executor(Executor &executor) {
+  if constexpr (std::is_base_of_v<boost::asio::execution_context, Executor>) {
+    return executor.get_executor();
+  } else {
+    return executor;
+  }
+}
+
+/// Returns the executor pooled timers are created with: the executor of the specified execution context, or the
+/// specified executor with its strand, if any, stripped.
+template <class Executor> executor_type get_timer_executor(Executor &executor) {
+  if constexpr (is_strand<std::remove_cv_t<Executor>>::value) {
+    return executor.get_inner_executor();
+  } else {
+    return get_io_executor(executor);
+  }
+}
+} // namespace asio_coro::detail
+
+#endif // ASIO_CORO_EXTENSIONS_DETAIL_TIMER_POOL_HPP
@@ -0,0 +1,386 @@
+#ifndef ASIO_CORO_EXTENSIONS_DETAIL_TIMER_WHEEL_HPP
+#define ASIO_CORO_EXTENSIONS_DETAIL_TIMER_WHEEL_HPP
+
+#include "coroutine.hpp"
+#include "executor.hpp"
+
+#include <boost/asio/steady_timer.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace asio_coro::detail {
+/// An element of the timer wheel slot intrusive doubly-linked list. Entries are owned by the awaitables, so arming and
+/// cancelling a timer never allocates.
+struct timer_wheel_entry {
+  timer_wheel_entry *prev = nullptr;
+  timer_wheel_entry *next = nullptr;
+  timer_wheel_entry **slot = nullptr;
+  std::uint64_t expiry_tick = 0;
+
+  /// The tick of the last activity and the idle timeout in ticks if the entry waits for inactivity, the entry is
+  /// re-armed upon expiration unless it has been inactive for idle_ticks.
+  const std::atomic<std::uint64_t> *last_active_tick = nullptr;
+  std::uint64_t idle_ticks = 0;
+
+  coroutine_handle<> continuation;
+  executor_type executor;
+  boost::system::error_code result;
+  bool linked = false;
+};
+
+/// The hierarchical timing wheel shared between timer_wheel and the pending tick handler.
+///
+/// The first level has 256 slots one tick each, every next level has 64 slots each spanning the whole previous level.
+/// Entries of a higher level slot are cascaded down to the lower levels once the wheel reaches the slot, so arming,
+/// re-arming and cancelling take constant time regardless of the amount of pending entries.
+class timer_wheel_state : public std::enable_shared_from_this<timer_wheel_state> {
+public:
+  using clock_type = std::chrono::steady_clock;
+  using duration = clock_type::duration;
+
+  timer_wheel_state(const executor_type &executor, duration resolution)
+      : _timer(executor), _resolution(resolution), _origin(clock_type::now()) {
+    assert(resolution > duration::zero());
+  }
+
+  ~timer_wheel_state() {
+    // All the waiters must be resumed by stop() prior to destruction.
+    assert(_size == 0);
+  }
+
+  /// Returns the tick the specified time point falls into.
+  std::uint64_t to_tick(clock_type::time_point time) const noexcept {
+    if (time <= _origin) {
+      return 0;
+    }
+
+    return static_cast<std::uint64_t>((time - _origin) / _resolution);
+  }
+
+  /// Returns the first tick that starts at or after the specified time point, so a timer expiring at this tick never
+  /// fires early.
+  std::uint64_t to_tick_ceil(clock_type::time_point time) const noexcept {
+    if (time <= _origin) {
+      return 0;
+    }
+
+    return to_ticks_ceil(time - _origin);
+  }
+
+  /// Returns the amount of ticks that covers the specified duration.
+  std::uint64_t to_ticks_ceil(duration value) const noexcept {
+    if (value <= duration::zero()) {
+      return 0;
+    }
+
+    return static_cast<std::uint64_t>((value + _resolution - duration(1)) / _resolution);
+  }
+
+  /// Returns the tick of the current time.
+  std::uint64_t now_tick() const noexcept { return to_tick(clock_type::now()); }
+
+  /// Returns the duration of one tick.
+  duration resolution() const noexcept { return _resolution; }
+
+  /// Arms the entry to expire at entry->expiry_tick. Returns false if the wheel is stopped, the entry is left unarmed
+  /// in that case.
+  bool arm(timer_wheel_entry *entry) {
+    std::lock_guard lock(_mutex);
+    if (_stopped) {
+      return false;
+    }
+
+    if (_size == 0) {
+      // Skip the ticks elapsed while the wheel had nothing to wait for.
+      _tick = std::max(_tick, now_tick());
+    }
+
+    entry->expiry_tick = std::max(entry->expiry_tick, _tick + 1);
+    link(entry);
+
+    // Wake up earlier if the entry expires before the scheduled tick.
+    if (_scheduled && entry->expiry_tick < _scheduled_tick) {
+      _scheduled = false;
+    }
+
+    schedule();
+
+    return true;
+  }
+
+  /// Cancels the armed entry and resumes its continuation with operation_aborted error. Does nothing if the entry has
+  /// already expired.
+  void cancel(timer_wheel_entry *entry) {
+    {
+      std::lock_guard lock(_mutex);
+      if (!entry->linked) {
+        return;
+      }
+
+      unlink(entry);
+    }
+
+    entry->result = boost::asio::error::operation_aborted;
+    resume_on(entry->executor, entry->continuation);
+  }
+
+  /// Unlinks the armed entry without resuming its continuation. Does nothing if the entry isn't armed.
+  void remove(timer_wheel_entry *entry) noexcept {
+    std::lock_guard lock(_mutex);
+    if (entry->linked) {
+      unlink(entry);
+    }
+  }
+
+  /// Cancels all the armed entries and refuses arming new ones.
+  void stop() {
+    timer_wheel_entry *cancelled = nullptr;
+    {
+      std::lock_guard lock(_mutex);
+      _stopped = true;
+      _timer.cancel();
+
+      for (auto &level : _levels) {
+        for (auto &slot : level) {
+          while (slot) {
+            auto *entry = slot;
+            unlink(entry);
+            entry->next = cancelled;
+            cancelled = entry;
+          }
+        }
+      }
+    }
+
+    resume_all(cancelled, boost::asio::error::operation_aborted);
+  }
+
+private:
+  static constexpr std::size_t levels_count = 4;
+  static constexpr std::size_t first_level_bits = 8;
+  static constexpr std::size_t level_bits = 6;
+  static constexpr std::size_t slots_count = std::size_t(1) << first_level_bits;
+  static constexpr std::uint64_t max_delta =
+      (std::uint64_t(1) << (first_level_bits + (levels_count - 1) * level_bits)) - 1;
+
+  using slot_type = timer_wheel_entry *;
+  using level_type = std::array<slot_type, slots_count>;
+
+  boost::asio::steady_timer _timer;
+  const duration _resolution;
+  const clock_type::time_point _origin;
+
+  std::mutex _mutex;
+  std::array<level_type, levels_count> _levels{};
+  std::uint64_t _tick = 0;
+  std::uint64_t _scheduled_tick = 0;
+  std::size_t _size = 0;
+  /// The amount of entries linked into the first level, the level is skipped as a whole if it's empty.
+  std::size_t _first_level_size = 0;
+  bool _scheduled = false;
+  bool _stopped = false;
+
+  /// Returns the amount of bits the tick is shifted by to get the slot index of the specified level.
+  static constexpr std::size_t level_shift(std::size_t level) noexcept {
+    return level == 0 ? 0 : first_level_bits + (level - 1) * level_bits;
+  }
+
+  /// Returns the mask of the slot index of the specified level.
+  static constexpr std::uint64_t level_mask(std::size_t level) noexcept {
+    return level == 0 ? slots_count - 1 : (std::uint64_t(1) << level_bits) - 1;
+  }
+
+  /// Checks whether the slot belongs to the first level.
+  bool is_first_level(const slot_type *slot) const noexcept {
+    return slot >= _levels[0].data() && slot < _levels[0].data() + slots_count;
+  }
+
+  /// Links the entry into the slot its expiry tick falls into. The expiry tick must not precede the current tick. An
+  /// entry expiring beyond the range of the wheel is linked into the farthest slot, and linked again once the wheel
+  /// reaches it, so the expiry tick itself is kept as is.
+  void link(timer_wheel_entry *entry) noexcept {
+    assert(!entry->linked);
+    assert(entry->expiry_tick >= _tick);
+
+    const auto delta = std::min(entry->expiry_tick - _tick, max_delta);
+    const auto slot_tick = _tick + delta;
+    auto level = std::size_t(0);
+    while (level + 1 != levels_count && delta >> level_shift(level + 1) != 0) {
+      ++level;
+    }
+
+    auto &slot = _levels[level][(slot_tick >> level_shift(level)) & level_mask(level)];
+    entry->prev = nullptr;
+    entry->next = slot;
+    if (slot) {
+      slot->prev = entry;
+    }
+
+    slot = entry;
+    entry->slot = &slot;
+    entry->linked = true;
+    ++_size;
+    _first_level_size += level == 0;
+  }
+
+  /// Unlinks the entry from the slot it's linked into.
+  void unlink(timer_wheel_entry *entry) noexcept {
+    assert(entry->linked);
+
+    if (entry->prev) {
+      entry->prev->next = entry->next;
+    } else {
+      *entry->slot = entry->next;
+    }
+
+    if (entry->next) {
+      entry->next->prev = entry->prev;
+    }
+
+    _first_level_size -= is_first_level(entry->slot);
+    entry->prev = nullptr;
+    entry->next = nullptr;
+    entry->slot = nullptr;
+    entry->linked = false;
+    --_size;
+  }
+
+  /// Detaches and returns the list of entries linked into the slot.
+  timer_wheel_entry *detach(slot_type &slot) noexcept {
+    auto *entries = slot;
+    slot = nullptr;
+
+    const auto first_level = is_first_level(&slot);
+    for (auto *entry = entries; entry; entry = entry->next) {
+      entry->linked = false;
+      --_size;
+      _first_level_size -= first_level;
+    }
+
+    return entries;
+  }
+
+  /// Moves the wheel to the next tick and appends the expired entries to the expired list, so the list is ordered by
+  /// expiration.
+  void advance(timer_wheel_entry **&expired_tail) noexcept {
+    ++_tick;
+
+    // Cascade the higher level slots reached by the wheel down to the lower levels.
+    for (auto level = std::size_t(1); level != levels_count; ++level) {
+      if ((_tick & ((std::uint64_t(1) << level_shift(level)) - 1)) != 0) {
+        break;
+      }
+
+      auto *entry = detach(_levels[level][(_tick >> level_shift(level)) & level_mask(level)]);
+      while (entry) {
+        auto *next = entry->next;
+        link(entry);
+        entry = next;
+      }
+    }
+
+    auto *entry = detach(_levels[0][_tick & level_mask(0)]);
+    while (entry) {
+      auto *next = entry->next;
+      assert(entry->expiry_tick >= _tick);
+
+      // An idle entry that has been active since it was armed is re-armed to the end of the idle timeout.
+      const auto active_until =
+          entry->last_active_tick ? entry->last_active_tick->load(std::memory_order_relaxed) + entry->idle_ticks : 0;
+      if (entry->expiry_tick > _tick) {
+        // The entry expires beyond the range the wheel had when the entry was linked.
+        link(entry);
+      } else if (active_until > _tick) {
+        entry->expiry_tick = active_until;
+        link(entry);
+      } else {
+        entry->next = nullptr;
+        *expired_tail = entry;
+        expired_tail = &entry->next;
+      }
+
+      entry = next;
+    }
+  }
+
+  /// Returns the next tick the wheel has to be woken up at: either the nearest non-empty slot of the first level or
+  /// the first level wrap around whichever comes first.
+  std::uint64_t next_tick() const noexcept {
+    if (_first_level_size == 0) {
+      return (_tick | level_mask(0)) + 1;
+    }
+
+    auto tick = _tick + 1;
+    for (; (tick & level_mask(0)) != 0; ++tick) {
+      if (_levels[0][tick & level_mask(0)]) {
+        break;
+      }
+    }
+
+    return tick;
+  }
+
+  /// Schedules the tick handler unless it's already scheduled or the wheel is empty. Must be called under the lock.
+  void schedule() {
+    if (_scheduled || _size == 0) {
+      return;
+    }
+
+    // Setting the expiry cancels the pending wait if the wheel is rescheduled to an earlier tick.
+    _scheduled = true;
+    _scheduled_tick = next_tick();
+    _timer.expires_at(_origin + _resolution * static_cast<duration::rep>(_scheduled_tick));
+    _timer.async_wait([self = shared_from_this()](const boost::system::error_code &error) {
+      if (error != boost::asio::error::operation_aborted) {
+        self->on_tick();
+      }
+    });
+  }
+
+  /// Advances the wheel up to the current time and resumes the expired entries.
+  void on_tick() {
+    timer_wheel_entry *expired = nullptr;
+    auto **expired_tail = &expired;
+    {
+      std::lock_guard lock(_mutex);
+      _scheduled = false;
+      if (_stopped) {
+        return;
+      }
+
+      const auto tick = now_tick();
+      while (_tick < tick && _size != 0) {
+        // The empty first level slots preceding the next cascade are skipped rather than advanced through one by one.
+        _tick = std::min(next_tick(), tick) - 1;
+        advance(expired_tail);
+      }
+
+      _tick = std::max(_tick, tick);
+      schedule();
+    }
+
+    resume_all(expired, boost::system::error_code());
+  }
+
+  /// Resumes all the entries of the list with the specified result.
+  static void resume_all(timer_wheel_entry *entry, const boost::system::error_code &result) {
+    while (entry) {
+      // The entry is owned by the resumed coroutine, so it mustn't be accessed after resumption.
+      auto *next = entry->next;
+      entry->result = result;
+      resume_on(entry->executor, entry->continuation);
+      entry = next;
+    }
+  }
+};
+} // namespace asio_coro::detail
+
+#endif // ASIO_CORO_EXTENSIONS_DETAIL_TIMER_WHEEL_HPP
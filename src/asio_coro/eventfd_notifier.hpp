@@ -0,0 +1,160 @@
+#ifndef ASIO_CORO_EXTENSIONS_EVENTFD_NOTIFIER_HPP
+#define ASIO_CORO_EXTENSIONS_EVENTFD_NOTIFIER_HPP
+
+#include "detail/coroutine.hpp"
+#include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/scope_exit.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace asio_coro {
+/// An auto-reset event a coroutine awaits, which may be notified from any thread, including the threads that don't run
+/// an io_context, e.g. the callbacks of a third-party library.
+///
+/// Notifications are coalesced: the coroutine awaiting the notifier is resumed once no matter how many times it has
+/// been notified since it started waiting, and a notification arriving while nobody waits completes the next wait at
+/// once.
+/// The state is kept in an atomic, so the eventfd is only written to wake a coroutine that is actually suspended, and a
+/// wait that finds the notifier already notified completes without any system calls.
+///
+/// Only one coroutine may await the notifier at a time.
+class eventfd_notifier {
+public:
+  /// Constructor. Creates a notifier the coroutines of the specified executor await.
+  template <class Executor>
+  explicit eventfd_notifier(const Executor &executor) : _descriptor(executor, make_eventfd()) {}
+
+  /// Constructor. Creates a notifier the coroutines of the specified io_context await.
+  explicit eventfd_notifier(boost::asio::io_context &context) : eventfd_notifier(context.get_executor()) {}
+
+  eventfd_notifier(const eventfd_notifier &) = delete;
+
+  eventfd_notifier &operator=(const eventfd_notifier &) = delete;
+
+  /// Notifies the notifier, resuming the awaiting coroutine if any. Thread-safe, and never blocks.
+  void notify() noexcept {
+    if (_state.exchange(notified, std::memory_order_acq_rel) == waiting) {
+      const std::uint64_t value = 1;
+      while (::write(_descriptor.native_handle(), &value, sizeof(value)) == -1 && errno == EINTR) {
+      }
+    }
+  }
+
+  /// Resumes the awaiting coroutine if any with operation_aborted error. Must be called within the executor of the
+  /// awaiting coroutine.
+  void cancel() { _descriptor.cancel(); }
+
+  /// Returns an awaitable that suspends the awaiting coroutine until the notifier is notified, unless it has been
+  /// notified already since the previous wait.
+  ///
+  /// The awaitable returns an instance of boost::system::error_code, which contains operation_aborted error if the wait
+  /// has been cancelled.
+  auto async_wait() {
+    class awaitable {
+    public:
+      explicit awaitable(eventfd_notifier &notifier) noexcept : _notifier(notifier) {}
+
+      bool await_ready() noexcept { return _notifier.try_reset(); }
+
+      boost::system::error_code await_resume() const noexcept { return _result; }
+
+      /// Sets the executor the awaiting coroutine is resumed on.
+      void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+      bool await_suspend(detail::coroutine_handle<> continuation) {
+        auto expected = idle;
+        if (!_notifier._state.compare_exchange_strong(expected, waiting, std::memory_order_acq_rel)) {
+          // The notifier has been notified since await_ready.
+          _notifier._state.store(idle, std::memory_order_release);
+          return false;
+        }
+
+        wait(detail::get_executor(_executor, _notifier._descriptor), detail::coroutine_holder<>(continuation));
+        return true;
+      }
+
+    private:
+      eventfd_notifier &_notifier;
+      boost::system::error_code _result;
+      detail::executor_type _executor;
+      std::uint64_t _value = 0;
+
+      /// Reads the eventfd with the descriptor's own operation, which waits for it to become readable and resets it
+      /// at once, rather than waiting for it and reading it then. A notification written while the read is being
+      /// queued isn't missed: the reactor re-registers the descriptor when the operation is queued, which reports the
+      /// readiness it already has.
+      void wait(detail::executor_type executor, detail::coroutine_holder<> holder) {
+        BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+        auto handler = [this, executor, holder = std::move(holder)](const boost::system::error_code &error,
+                                                                    std::size_t) mutable {
+          if (error) {
+            auto expected = waiting;
+            _notifier._state.compare_exchange_strong(expected, idle, std::memory_order_acq_rel);
+            _result = error;
+            holder.release().resume();
+            return;
+          }
+
+          // The eventfd is reset before the state is checked, so a notification arriving in between writes it again.
+          if (_notifier.try_reset()) {
+            holder.release().resume();
+            return;
+          }
+
+          wait(std::move(executor), std::move(holder));
+        };
+        _notifier._descriptor.async_read_some(boost::asio::buffer(&_value, sizeof(_value)),
+                                              boost::asio::bind_executor(executor, std::move(handler)));
+      }
+    };
+
+    return awaitable(*this);
+  }
+
+private:
+  /// Nobody waits, and the notifier hasn't been notified.
+  static constexpr int idle = 0;
+  /// The notifier has been notified, and the next wait completes at once.
+  static constexpr int notified = 1;
+  /// A coroutine waits for the eventfd to become readable.
+  static constexpr int waiting = 2;
+
+  boost::asio::posix::stream_descriptor _descriptor;
+  std::atomic<int> _state = idle;
+
+  static int make_eventfd() {
+    const auto fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd == -1) {
+      throw boost::system::system_error(errno, boost::system::system_category(), "eventfd");
+    }
+
+    return fd;
+  }
+
+  /// Consumes the notification if the notifier has been notified. Returns whether it has.
+  bool try_reset() noexcept {
+    auto expected = notified;
+    return _state.load(std::memory_order_relaxed) == notified &&
+           _state.compare_exchange_strong(expected, idle, std::memory_order_acq_rel);
+  }
+};
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_EVENTFD_NOTIFIER_HPP
@@ -0,0 +1,326 @@
+#ifndef ASIO_CORO_EXTENSIONS_FILE_HPP
+#define ASIO_CORO_EXTENSIONS_FILE_HPP
+
+#include "detail/executor.hpp"
+#include "io_uring.hpp"
+
+#include <boost/asio/associated_executor.hpp>
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/execution/outstanding_work.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/prefer.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/container/small_vector.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace asio_coro {
+namespace detail {
+/// The maximum amount of buffers of a sequence read or written with one vectored file operation.
+constexpr std::size_t max_file_buffers = 64;
+
+using iovec_vector = boost::container::small_vector<iovec, 8>;
+
+/// Returns the thread pool blocking file operations are run on if the file isn't operated by an io_uring.
+inline boost::asio::thread_pool &file_thread_pool() {
+  static boost::asio::thread_pool pool(std::max(4u, std::thread::hardware_concurrency()));
+  return pool;
+}
+
+/// Converts the non-empty buffers of the sequence to iovecs.
+template <class BufferSequence> iovec_vector to_iovecs(const BufferSequence &buffers) {
+  iovec_vector result;
+  const auto end = boost::asio::buffer_sequence_end(buffers);
+  for (auto it = boost::asio::buffer_sequence_begin(buffers); it != end && result.size() != max_file_buffers; ++it) {
+    const boost::asio::const_buffer buffer(*it);
+    if (buffer.size() != 0) {
+      result.push_back(iovec{const_cast<void *>(buffer.data()), buffer.size()});
+    }
+  }
+
+  return result;
+}
+
+/// Converts the result of a file operation, either a size or a negated error number, to an error code. A read of
+/// nothing means the end of file.
+inline boost::system::error_code to_file_error(long result, bool is_read) noexcept {
+  if (result < 0) {
+    return boost::system::error_code(static_cast<int>(-result), boost::system::system_category());
+  }
+
+  if (result == 0 && is_read) {
+    return boost::asio::error::eof;
+  }
+
+  return {};
+}
+
+/// Completes the handler of a file operation on the specified executor.
+template <class Handler>
+void complete_file_operation(const executor_type &executor, Handler handler, long result, bool is_read) {
+  const auto error = to_file_error(result, is_read);
+  const auto size = result < 0 ? std::size_t(0) : static_cast<std::size_t>(result);
+  boost::asio::dispatch(executor, [handler = std::move(handler), error, size]() mutable { handler(error, size); });
+}
+
+#if defined(ASIO_CORO_HAS_IO_URING)
+/// A handler-based file operation performed by an io_uring. It owns itself, and it's destroyed upon completion.
+template <class Handler> struct uring_file_operation : io_uring_operation {
+  uring_file_operation(Handler handler, executor_type executor, iovec_vector iovecs, bool is_read)
+      : handler(std::move(handler)), work_executor(std::move(executor)), iovecs(std::move(iovecs)), is_read(is_read) {
+    complete = &on_complete;
+  }
+
+  Handler handler;
+  executor_type work_executor;
+  iovec_vector iovecs;
+  bool is_read;
+
+  static void on_complete(io_uring_operation *operation) {
+    std::unique_ptr<uring_file_operation> self(static_cast<uring_file_operation *>(operation));
+    auto handler = std::move(self->handler);
+    const auto executor = std::move(self->work_executor);
+    const auto result = self->result;
+    const auto is_read = self->is_read;
+    self.reset();
+
+    complete_file_operation(executor, std::move(handler), result, is_read);
+  }
+};
+#endif
+} // namespace detail
+
+/// A file read and written at explicit offsets without blocking the calling thread, which models asio's
+/// AsyncRandomAccessReadDevice and AsyncRandomAccessWriteDevice, so it may be used with async_read_at and
+/// async_write_at as well as with boost::asio::async_read_at and boost::asio::async_write_at.
+///
+/// Operations are performed by an io_uring if the file is created with a uring_context, and by blocking preadv/pwritev
+/// calls on a shared thread pool otherwise, since regular files are always "ready" for the reactor. Handlers are
+/// invoked on their associated executor, which defaults to the executor of the file. Buffer sequences are read and
+/// written with one vectored operation of up to 64 buffers.
+class random_access_file {
+public:
+  using executor_type = detail::executor_type;
+
+  /// Constructor. Creates a closed file, whose operations run on the thread pool and complete on the specified
+  /// executor.
+  template <class Executor> explicit random_access_file(const Executor &executor) : _executor(executor) {}
+
+  /// Constructor. Creates a closed file, whose operations run on the thread pool and complete on the specified
+  /// io_context.
+  explicit random_access_file(boost::asio::io_context &context) : random_access_file(context.get_executor()) {}
+
+#if defined(ASIO_CORO_HAS_IO_URING)
+  /// Constructor. Creates a closed file, whose operations are performed by the specified ring.
+  explicit random_access_file(uring_context &ring) : _executor(ring.get_executor()), _ring(&ring) {}
+#endif
+
+  random_access_file(const random_access_file &) = delete;
+
+  random_access_file &operator=(const random_access_file &) = delete;
+
+  /// Destructor. Closes the file. There mustn't be any operations in progress.
+  ~random_access_file() { close(); }
+
+  /// Opens the file at the specified path, closing the file opened before if any.
+  ///
+  /// \param path   The path of the file.
+  /// \param flags  The open flags, see open(2).
+  /// \param mode   The mode of the file if it's created.
+  boost::system::error_code open(const char *path, int flags = O_RDONLY, mode_t mode = 0644) {
+    close();
+
+    _fd = ::open(path, flags | O_CLOEXEC, mode);
+    if (_fd == -1) {
+      return boost::system::error_code(errno, boost::system::system_category());
+    }
+
+    return {};
+  }
+
+  /// Closes the file.
+  void close() noexcept {
+    if (_fd != -1) {
+      ::close(_fd);
+      _fd = -1;
+    }
+  }
+
+  /// Checks whether the file is open.
+  bool is_open() const noexcept { return _fd != -1; }
+
+  /// Returns the file descriptor.
+  int native_handle() const noexcept { return _fd; }
+
+  /// Returns the executor handlers are invoked on by default.
+  executor_type get_executor() const noexcept { return _executor; }
+
+  /// Returns the size of the file.
+  ///
+  /// \param error  Set to the error occurred if any.
+  std::uint64_t size(boost::system::error_code &error) const {
+    struct stat status {};
+    if (::fstat(_fd, &status) == -1) {
+      error = boost::system::error_code(errno, boost::system::system_category());
+      return 0;
+    }
+
+    error = {};
+    return static_cast<std::uint64_t>(status.st_size);
+  }
+
+  /// Starts an asynchronous read at the specified offset. The handler is called with the error code and the amount of
+  /// bytes read, reading at the end of the file fails with boost::asio::error::eof.
+  template <class MutableBufferSequence, class ReadHandler>
+  void async_read_some_at(std::uint64_t offset, const MutableBufferSequence &buffers, ReadHandler &&handler) {
+    start(true, offset, detail::to_iovecs(buffers), std::forward<ReadHandler>(handler));
+  }
+
+  /// Starts an asynchronous write at the specified offset. The handler is called with the error code and the amount of
+  /// bytes written.
+  template <class ConstBufferSequence, class WriteHandler>
+  void async_write_some_at(std::uint64_t offset, const ConstBufferSequence &buffers, WriteHandler &&handler) {
+    start(false, offset, detail::to_iovecs(buffers), std::forward<WriteHandler>(handler));
+  }
+
+private:
+  executor_type _executor;
+  int _fd = -1;
+#if defined(ASIO_CORO_HAS_IO_URING)
+  uring_context *_ring = nullptr;
+#endif
+
+  template <class Handler>
+  void start(bool is_read, std::uint64_t offset, detail::iovec_vector iovecs, Handler &&handler) {
+    using handler_type = std::decay_t<Handler>;
+
+    // The handler's executor is kept busy until the handler is invoked, e.g. while the thread pool performs the call.
+    const executor_type executor =
+        boost::asio::prefer(executor_type(boost::asio::get_associated_executor(handler, _executor)),
+                            boost::asio::execution::outstanding_work.tracked);
+    if (iovecs.empty()) {
+      boost::asio::post(executor, [handler = handler_type(std::forward<Handler>(handler))]() mutable {
+        handler(boost::system::error_code(), std::size_t(0));
+      });
+      return;
+    }
+
+#if defined(ASIO_CORO_HAS_IO_URING)
+    if (_ring) {
+      auto operation = std::make_unique<detail::uring_file_operation<handler_type>>(
+          handler_type(std::forward<Handler>(handler)), executor, std::move(iovecs), is_read);
+      _ring->start_operation(*operation, [&](io_uring_sqe &sqe) {
+        uring_context::prepare_entry(sqe, is_read ? IORING_OP_READV : IORING_OP_WRITEV, uring_file{_fd},
+                                     operation->iovecs.data(), operation->iovecs.size(), offset);
+      });
+      operation.release();
+      return;
+    }
+#endif
+
+    boost::asio::post(detail::file_thread_pool(), [fd = _fd, is_read, offset, iovecs = std::move(iovecs), executor,
+                                                   handler = handler_type(std::forward<Handler>(handler))]() mutable {
+      const auto count = static_cast<int>(iovecs.size());
+      auto result = is_read ? ::preadv(fd, iovecs.data(), count, static_cast<off_t>(offset))
+                            : ::pwritev(fd, iovecs.data(), count, static_cast<off_t>(offset));
+      if (result < 0) {
+        result = -errno;
+      }
+
+      detail::complete_file_operation(executor, std::move(handler), result, is_read);
+    });
+  }
+};
+
+/// A file read and written sequentially without blocking the calling thread, which models asio's AsyncReadStream and
+/// AsyncWriteStream, so it may be used with async_read and async_write, as well as with buffered_stream.
+///
+/// The file keeps the position the next operation starts at, and advances it by the amount of bytes transferred. See
+/// random_access_file for details on how the operations are performed. There mustn't be more than one operation in
+/// progress at a time.
+class stream_file {
+public:
+  using executor_type = random_access_file::executor_type;
+
+  /// Constructor. Creates a closed file, see random_access_file for details.
+  template <class Executor> explicit stream_file(Executor &&executor) : _file(std::forward<Executor>(executor)) {}
+
+  stream_file(const stream_file &) = delete;
+
+  stream_file &operator=(const stream_file &) = delete;
+
+  /// Opens the file at the specified path and moves the position to its beginning, see random_access_file::open.
+  boost::system::error_code open(const char *path, int flags = O_RDONLY, mode_t mode = 0644) {
+    _position = 0;
+    return _file.open(path, flags, mode);
+  }
+
+  /// Closes the file.
+  void close() noexcept { _file.close(); }
+
+  /// Checks whether the file is open.
+  bool is_open() const noexcept { return _file.is_open(); }
+
+  /// Returns the file descriptor.
+  int native_handle() const noexcept { return _file.native_handle(); }
+
+  /// Returns the executor handlers are invoked on by default.
+  executor_type get_executor() const noexcept { return _file.get_executor(); }
+
+  /// Returns the size of the file.
+  std::uint64_t size(boost::system::error_code &error) const { return _file.size(error); }
+
+  /// Returns the position the next operation starts at.
+  std::uint64_t position() const noexcept { return _position; }
+
+  /// Moves the position the next operation starts at.
+  void seek(std::uint64_t position) noexcept { _position = position; }
+
+  /// Starts an asynchronous read at the current position.
+  template <class MutableBufferSequence, class ReadHandler>
+  void async_read_some(const MutableBufferSequence &buffers, ReadHandler &&handler) {
+    _file.async_read_some_at(_position, buffers, advance(std::forward<ReadHandler>(handler)));
+  }
+
+  /// Starts an asynchronous write at the current position.
+  template <class ConstBufferSequence, class WriteHandler>
+  void async_write_some(const ConstBufferSequence &buffers, WriteHandler &&handler) {
+    _file.async_write_some_at(_position, buffers, advance(std::forward<WriteHandler>(handler)));
+  }
+
+private:
+  random_access_file _file;
+  std::uint64_t _position = 0;
+
+  /// Wraps the handler with one advancing the position by the amount of bytes transferred.
+  template <class Handler> auto advance(Handler &&handler) {
+    auto executor = boost::asio::get_associated_executor(handler, get_executor());
+    auto advancing_handler = [this, handler = std::decay_t<Handler>(std::forward<Handler>(handler))](
+                                 const boost::system::error_code &error, std::size_t size) mutable {
+      _position += size;
+      handler(error, size);
+    };
+
+    return boost::asio::bind_executor(std::move(executor), std::move(advancing_handler));
+  }
+};
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_FILE_HPP
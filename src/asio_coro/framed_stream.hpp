@@ -0,0 +1,202 @@
+#ifndef ASIO_CORO_EXTENSIONS_FRAMED_STREAM_HPP
+#define ASIO_CORO_EXTENSIONS_FRAMED_STREAM_HPP
+
+#include "buffer_pool.hpp"
+#include "buffered_stream.hpp"
+#include "coalescing_writer.hpp"
+#include "detail/coroutine.hpp"
+#include "detail/crc32c.hpp"
+#include "detail/executor.hpp"
+
+#include <boost/asio/error.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace asio_coro {
+/// The checksum a framed_stream protects the payload of every frame with.
+enum class frame_checksum {
+  /// Frames carry no checksum.
+  none,
+  /// Frames carry the CRC32C of the payload, computed with SSE4.2 if the CPU supports it.
+  crc32c,
+};
+
+namespace detail {
+/// Returns the size of the header of a frame, which is the big-endian length of the payload, followed by its
+/// big-endian CRC32C if the frames are checksummed.
+constexpr std::size_t frame_header_size(frame_checksum checksum) noexcept {
+  return checksum == frame_checksum::none ? 4 : 8;
+}
+
+inline std::uint32_t load_big_endian(const char *data) noexcept {
+  const auto *bytes = reinterpret_cast<const unsigned char *>(data);
+  return (std::uint32_t(bytes[0]) << 24) | (std::uint32_t(bytes[1]) << 16) | (std::uint32_t(bytes[2]) << 8) |
+         std::uint32_t(bytes[3]);
+}
+
+inline void store_big_endian(char *data, std::uint32_t value) noexcept {
+  data[0] = static_cast<char>(value >> 24);
+  data[1] = static_cast<char>(value >> 16);
+  data[2] = static_cast<char>(value >> 8);
+  data[3] = static_cast<char>(value);
+}
+
+/// Returns the size of the frame at the beginning of the data, or npos if its header isn't complete yet.
+struct frame_size {
+  std::size_t header_size;
+
+  std::size_t operator()(std::string_view data) const noexcept {
+    return data.size() < header_size ? std::string_view::npos : header_size + load_big_endian(data.data());
+  }
+};
+} // namespace detail
+
+/// A length-prefixed message framing over a stream, which reads and writes frames made of a 4-byte big-endian payload
+/// length, an optional 4-byte big-endian CRC32C of the payload, and the payload.
+///
+/// Frames are read through a buffered_stream, so every read fills the whole free space of the buffer, and a frame
+/// whose header and payload are already in the kernel buffer, as well as the frames following it, are read without
+/// any more read calls. Payloads are returned as views into the buffer, which stay valid until the next read.
+///
+/// Frames are written through a coalescing_writer, so the header and the payload of a frame are written without
+/// copying them together, and the frames queued within a reactor turn are written with one gathered write. All the
+/// writers must share the same strand, and the framed_stream must outlive all the operations on it, so await
+/// async_flush prior to its destruction. There mustn't be more than one read in progress at a time.
+template <class Stream> class framed_stream {
+public:
+  using executor_type = typename Stream::executor_type;
+
+  /// Constructor. Creates a framed_stream over the specified stream.
+  ///
+  /// \param stream             A stream to read frames from and to write frames to.
+  /// \param checksum           The checksum of the frames, which must be the same on both sides.
+  /// \param max_payload_size   The maximum size of the payload of a frame read. The read buffer grows up to the size
+  ///                           of the largest frame.
+  /// \param high_water_mark    The amount of queued bytes writers are suspended beyond.
+  explicit framed_stream(Stream &stream, frame_checksum checksum = frame_checksum::none,
+                         std::size_t max_payload_size = 64 * 1024, std::size_t high_water_mark = 64 * 1024)
+      : _reader(stream, 4096, detail::frame_header_size(checksum) + max_payload_size),
+        _writer(stream, high_water_mark), _checksum(checksum) {}
+
+  framed_stream(const framed_stream &) = delete;
+
+  framed_stream &operator=(const framed_stream &) = delete;
+
+  /// Returns the underlying stream.
+  Stream &next_layer() noexcept { return _reader.next_layer(); }
+
+  /// Returns the executor of the underlying stream.
+  executor_type get_executor() { return _reader.get_executor(); }
+
+  /// Returns the checksum of the frames.
+  frame_checksum checksum() const noexcept { return _checksum; }
+
+  /// Returns the amount of gathered writes started so far.
+  std::size_t writes() const noexcept { return _writer.writes(); }
+
+  /// Returns an awaitable that reads the next frame, and resumes the awaiting coroutine once it's complete. The
+  /// awaiting coroutine is not suspended if the frame is already buffered. The frame returned by the previous read is
+  /// consumed.
+  ///
+  /// The awaitable returns a value of type buffered_read_result, where the first item contains the operation result,
+  /// and the second - the view of the payload. The operation fails with boost::asio::error::message_size if the
+  /// payload exceeds the maximum size, which leaves the stream unusable, with boost::system::errc::bad_message if the
+  /// checksum doesn't match, in which case the frame is skipped, and with the read error if the read fails.
+  auto async_read_frame() {
+    using inner_type = decltype(std::declval<buffered_stream<Stream> &>().async_read_message(detail::frame_size{}));
+
+    class awaitable {
+    public:
+      explicit awaitable(framed_stream &stream, inner_type inner) : _stream(stream), _inner(std::move(inner)) {}
+
+      bool await_ready() { return _inner.await_ready(); }
+
+      buffered_read_result await_resume() { return _stream.complete(_inner.await_resume()); }
+
+      /// Sets the executor the awaiting coroutine is resumed on.
+      void set_executor(detail::executor_type executor) noexcept { _inner.set_executor(std::move(executor)); }
+
+      void await_suspend(detail::coroutine_handle<> continuation) { _inner.await_suspend(continuation); }
+
+    private:
+      framed_stream &_stream;
+      inner_type _inner;
+    };
+
+    _reader.consume(std::exchange(_consumed, 0));
+    return awaitable(*this, _reader.async_read_message(detail::frame_size{detail::frame_header_size(_checksum)}));
+  }
+
+  /// Returns an awaitable that queues a frame with the specified payload, and suspends the awaiting coroutine only if
+  /// the write queue has exceeded the high-water mark, see coalescing_writer::async_write.
+  ///
+  /// The awaitable returns an instance of boost::system::error_code, which contains the error the last failed write
+  /// has completed with.
+  ///
+  /// \param payload  The payload of the frame, which may be shared with other writers without copying.
+  auto async_write_frame(pooled_buffer payload) {
+    auto header = make_header(std::string_view(payload.data(), payload.size()));
+    return _writer.async_write(std::move(header), std::move(payload));
+  }
+
+  /// Returns an awaitable that queues a frame with the specified payload, see the pooled_buffer overload for details.
+  ///
+  /// \param payload  The payload of the frame.
+  auto async_write_frame(std::string payload) {
+    auto header = make_header(payload);
+    return _writer.async_write(std::move(header), std::move(payload));
+  }
+
+  /// Returns an awaitable that suspends the awaiting coroutine until all the queued frames are written.
+  ///
+  /// The awaitable returns an instance of boost::system::error_code, see async_write_frame for details.
+  auto async_flush() { return _writer.async_flush(); }
+
+private:
+  buffered_stream<Stream> _reader;
+  coalescing_writer<Stream> _writer;
+  const frame_checksum _checksum;
+  /// The size of the frame returned by the last read, which is consumed by the next one.
+  std::size_t _consumed = 0;
+
+  std::string make_header(std::string_view payload) const {
+    assert(payload.size() <= std::numeric_limits<std::uint32_t>::max());
+
+    std::string header(detail::frame_header_size(_checksum), '\0');
+    detail::store_big_endian(header.data(), static_cast<std::uint32_t>(payload.size()));
+    if (_checksum == frame_checksum::crc32c) {
+      detail::store_big_endian(header.data() + 4, detail::crc32c(payload.data(), payload.size()));
+    }
+
+    return header;
+  }
+
+  /// Turns the frame read into its payload, and verifies the checksum.
+  buffered_read_result complete(buffered_read_result result) {
+    auto [error, frame] = result;
+    if (error) {
+      return buffered_read_result(error == boost::asio::error::not_found ? boost::asio::error::message_size : error,
+                                  {});
+    }
+
+    _consumed = frame.size();
+    const auto header_size = detail::frame_header_size(_checksum);
+    const auto payload = frame.substr(header_size);
+    if (_checksum == frame_checksum::crc32c &&
+        detail::load_big_endian(frame.data() + 4) != detail::crc32c(payload.data(), payload.size())) {
+      return buffered_read_result(boost::system::errc::make_error_code(boost::system::errc::bad_message), {});
+    }
+
+    return buffered_read_result({}, payload);
+  }
+};
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_FRAMED_STREAM_HPP
@@ -0,0 +1,133 @@
+#ifndef ASIO_CORO_EXTENSIONS_HOT_RESTART_HPP
+#define ASIO_CORO_EXTENSIONS_HOT_RESTART_HPP
+
+#include "async_send_fds.hpp"
+#include "async_sendfile.hpp"
+
+#include <boost/asio/buffer.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace asio_coro {
+namespace detail {
+/// The byte the file descriptors of the sockets handed over are attached to.
+constexpr char hand_over_tag = 'S';
+
+/// A transfer taking over the sockets handed over by another process, see async_take_over.
+template <class Channel, class Socket> class take_over_transfer {
+public:
+  take_over_transfer(Channel &channel, std::vector<Socket> &sockets, std::size_t max_count)
+      : _channel(channel), _sockets(sockets), _max_count(max_count) {}
+
+  auto get_executor() { return _channel.get_executor(); }
+
+  bool step(async_transfer_result &result) {
+    std::vector<int> fds;
+    while (true) {
+      char tag;
+      auto truncated = false;
+      const auto received = receive_with_fds(_channel.native_handle(), &tag, 1, fds, _max_count, truncated);
+      if (received == -1 && errno == EINTR) {
+        continue;
+      }
+
+      if (received == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return false;
+      }
+
+      if (received == -1) {
+        result.first = last_system_error();
+      } else if (received == 0) {
+        result.first = boost::asio::error::eof;
+      } else if (truncated) {
+        result.first = boost::asio::error::message_size;
+      }
+
+      break;
+    }
+
+    // Every socket is assigned with the protocol it has been created with, e.g. IPv4 or IPv6.
+    for (const auto fd : fds) {
+      typename Socket::endpoint_type endpoint;
+      auto size = static_cast<socklen_t>(endpoint.capacity());
+      boost::system::error_code error;
+      if (::getsockname(fd, endpoint.data(), &size) == 0) {
+        endpoint.resize(size);
+        if (_sockets.emplace_back(_channel.get_executor()).assign(endpoint.protocol(), fd, error)) {
+          _sockets.pop_back();
+        }
+      } else {
+        error = last_system_error();
+      }
+
+      if (error) {
+        ::close(fd);
+        result.first = result.first ? result.first : error;
+        continue;
+      }
+
+      ++result.second;
+    }
+
+    return true;
+  }
+
+  template <class Handler> void async_wait(Handler &&handler) {
+    _channel.async_wait(Channel::wait_read, std::forward<Handler>(handler));
+  }
+
+private:
+  Channel &_channel;
+  std::vector<Socket> &_sockets;
+  std::size_t _max_count;
+};
+} // namespace detail
+
+/// Returns an awaitable that hands the specified sockets, e.g. the listening sockets of a server, over to another
+/// process during a hot restart, passing them over the specified Unix domain socket connected to that process.
+///
+/// A zero-downtime restart goes as follows: the new process connects to a Unix domain socket the running process
+/// listens on, the running process hands its acceptors over with async_hand_over, and the new process takes them over
+/// with async_take_over and starts accepting connections. The listening sockets are never closed, so connections
+/// waiting in the backlog aren't dropped. The old process then closes its copies of the acceptors, which completes its
+/// pending async_accept calls with operation_aborted, and finishes serving the connections it has accepted. Connected
+/// sockets may be handed over the same way.
+///
+/// The awaitable returns a value of type async_transfer_result, the amount is 1 once the sockets are handed over.
+///
+/// \param channel  A connected Unix domain stream socket, e.g. boost::asio::local::stream_protocol::socket.
+/// \param sockets  The sockets to hand over, up to 253 of them. They remain open in this process.
+template <class Channel, class Socket> auto async_hand_over(Channel &channel, std::vector<Socket> &sockets) {
+  std::vector<int> fds;
+  fds.reserve(sockets.size());
+  for (auto &socket : sockets) {
+    fds.push_back(socket.native_handle());
+  }
+
+  return async_send_fds(channel, boost::asio::buffer(&detail::hand_over_tag, 1), std::move(fds));
+}
+
+/// Returns an awaitable that takes over the sockets handed over by another process with async_hand_over, and suspends
+/// the awaiting coroutine until they arrive. The sockets are appended to the specified vector in the order they are
+/// handed over in, and use the executor of the channel. The io_context of the channel must not be the one the handed
+/// over sockets are registered with, since a reactor keeps a closed socket registered while its duplicates are open.
+///
+/// The awaitable returns a value of type async_transfer_result, the amount is the amount of sockets taken over.
+///
+/// \param channel      A connected Unix domain stream socket, e.g. boost::asio::local::stream_protocol::socket.
+/// \param sockets      The vector to append the sockets to, e.g. a vector of boost::asio::ip::tcp::acceptor.
+/// \param max_count    The maximum amount of sockets to take over.
+template <class Channel, class Socket>
+auto async_take_over(Channel &channel, std::vector<Socket> &sockets, std::size_t max_count = detail::max_passed_fds) {
+  return detail::async_transfer(detail::take_over_transfer<Channel, Socket>(channel, sockets, max_count));
+}
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_HOT_RESTART_HPP
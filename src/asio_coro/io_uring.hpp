@@ -0,0 +1,666 @@
+#ifndef ASIO_CORO_EXTENSIONS_IO_URING_HPP
+#define ASIO_CORO_EXTENSIONS_IO_URING_HPP
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#define ASIO_CORO_HAS_IO_URING 1
+
+#include "async_read.hpp"
+#include "async_write.hpp"
+#include "detail/coroutine.hpp"
+#include "detail/executor.hpp"
+#include "detail/io_uring.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/container/small_vector.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace asio_coro {
+class uring_buffer_ring;
+
+/// A file descriptor operated on by a uring_context. A registered file refers to the ring's file table by index, which
+/// spares the kernel looking the descriptor up and taking a reference to the file on every operation.
+struct uring_file {
+  int fd = -1;
+  int index = -1;
+
+  /// Checks whether the file is registered with the ring.
+  bool registered() const noexcept { return index >= 0; }
+};
+
+/// A buffer the kernel has picked from a uring_buffer_ring for a receive. The buffer is given back to the ring once the
+/// handle is destroyed, so the handle should be dropped as soon as the data is processed.
+class provided_buffer {
+public:
+  /// Default constructor. Creates an empty handle.
+  provided_buffer() noexcept = default;
+
+  provided_buffer(uring_buffer_ring &ring, std::uint16_t id, std::size_t size) noexcept
+      : _ring(&ring), _id(id), _size(size) {}
+
+  provided_buffer(provided_buffer &&other) noexcept
+      : _ring(std::exchange(other._ring, nullptr)), _id(other._id), _size(std::exchange(other._size, 0)) {}
+
+  provided_buffer &operator=(provided_buffer &&other) noexcept {
+    if (this != &other) {
+      reset();
+      _ring = std::exchange(other._ring, nullptr);
+      _id = other._id;
+      _size = std::exchange(other._size, 0);
+    }
+
+    return *this;
+  }
+
+  provided_buffer(const provided_buffer &) = delete;
+
+  provided_buffer &operator=(const provided_buffer &) = delete;
+
+  /// Destructor. Gives the buffer back to the ring.
+  ~provided_buffer() { reset(); }
+
+  /// Gives the buffer back to the ring and makes the handle empty.
+  inline void reset() noexcept;
+
+  /// Returns the data of the buffer.
+  inline char *data() const noexcept;
+
+  /// Returns the amount of bytes received into the buffer.
+  std::size_t size() const noexcept { return _size; }
+
+  /// Returns the received data as a buffer, so it may be passed to a write as is.
+  boost::asio::const_buffer buffer() const noexcept { return boost::asio::const_buffer(data(), _size); }
+
+  /// Checks whether the handle refers to a buffer.
+  bool valid() const noexcept { return _ring != nullptr; }
+
+private:
+  uring_buffer_ring *_ring = nullptr;
+  std::uint16_t _id = 0;
+  std::size_t _size = 0;
+};
+
+using uring_recv_result = std::pair<boost::system::error_code, provided_buffer>;
+
+namespace detail {
+/// The state of a uring_context shared with the wait for its eventfd and the handlers it posts, so that the ring may be
+/// destroyed, e.g. by the coroutine resumed by its last completion, while they are still queued.
+class uring_state : public std::enable_shared_from_this<uring_state> {
+public:
+  template <class Executor>
+  uring_state(const Executor &executor, unsigned entries) : _executor(executor), _queue(entries), _notifier(_executor) {
+    const auto fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (fd == -1) {
+      throw_system_error(errno, "eventfd");
+    }
+
+    _notifier.assign(fd);
+    if (const auto error = _queue.register_resource(IORING_REGISTER_EVENTFD, &fd, 1)) {
+      throw_system_error(-error, "io_uring_register");
+    }
+  }
+
+  const executor_type &executor() const noexcept { return _executor; }
+
+  io_uring_queue &queue() noexcept { return _queue; }
+
+  std::size_t pending() const noexcept { return _pending; }
+
+  std::size_t operations() const noexcept { return _operations; }
+
+  std::size_t submissions() const noexcept { return _submissions; }
+
+  /// Returns a free submission queue entry, submitting the queued entries if the queue is full.
+  io_uring_sqe &get_sqe() {
+    auto *sqe = _queue.get_sqe();
+    if (!sqe) {
+      submit();
+      sqe = _queue.get_sqe();
+      if (!sqe) {
+        throw_system_error(EBUSY, "io_uring_enter");
+      }
+    }
+
+    return *sqe;
+  }
+
+  /// Accounts the operation whose entry has just been queued.
+  void started() {
+    ++_pending;
+    ++_operations;
+    schedule_submit();
+    if (!_waiting) {
+      wait();
+    }
+  }
+
+  /// Posts the submission of the queued entries, so all the entries queued within the current handler are submitted
+  /// with one system call.
+  void schedule_submit() {
+    if (_submit_scheduled) {
+      return;
+    }
+
+    _submit_scheduled = true;
+    boost::asio::post(_executor, [self = shared_from_this()]() {
+      self->_submit_scheduled = false;
+      self->submit();
+    });
+  }
+
+  /// Cancels the wait for the eventfd, so its handler releases the state. Called upon the ring destruction.
+  void close() noexcept {
+    boost::system::error_code error;
+    _notifier.cancel(error);
+  }
+
+private:
+  executor_type _executor;
+  io_uring_queue _queue;
+  boost::asio::posix::stream_descriptor _notifier;
+  std::size_t _pending = 0;
+  std::size_t _operations = 0;
+  std::size_t _submissions = 0;
+  bool _submit_scheduled = false;
+  bool _waiting = false;
+
+  /// Submits the queued entries.
+  void submit() {
+    while (_queue.pending() != 0) {
+      const auto result = _queue.submit();
+      ++_submissions;
+      if (result == -EAGAIN || result == -EBUSY) {
+        // The kernel is short of resources or the completion queue overflowed, retry once completions are reaped.
+        schedule_submit();
+        return;
+      }
+
+      if (result < 0) {
+        throw_system_error(-result, "io_uring_enter");
+      }
+    }
+  }
+
+  /// Awaits the eventfd signalled upon completions.
+  void wait() {
+    _waiting = true;
+    _notifier.async_wait(boost::asio::posix::stream_descriptor::wait_read,
+                         [self = shared_from_this()](const boost::system::error_code &error) {
+                           self->_waiting = false;
+                           if (!error) {
+                             self->reap();
+                           }
+                         });
+
+    // Completions posted after the last reap but before the wait has been started may not signal the wait.
+    if (_queue.has_completions()) {
+      boost::asio::post(_executor, [self = shared_from_this()]() { self->reap(); });
+    }
+  }
+
+  /// Takes the completed operations off the completion queue and resumes their coroutines.
+  void reap() {
+    std::uint64_t value;
+    (void)::read(_notifier.native_handle(), &value, sizeof(value));
+
+    boost::container::small_vector<io_uring_operation *, 64> completed;
+    _queue.reap([&](const io_uring_cqe &cqe) {
+      // Entries without the user data are internal, e.g. cancellations.
+      if (cqe.user_data == 0) {
+        return;
+      }
+
+      auto *const operation = reinterpret_cast<io_uring_operation *>(cqe.user_data);
+      operation->result = cqe.res;
+      operation->flags = cqe.flags;
+      completed.push_back(operation);
+    });
+
+    _pending -= completed.size();
+    if (_pending != 0 && !_waiting) {
+      wait();
+    }
+
+    // The resumed coroutines may destroy the ring. The state outlives them, as the handler calling reap holds it.
+    for (auto *operation : completed) {
+      if (operation->complete) {
+        operation->complete(operation);
+      } else {
+        resume_on(operation->executor, operation->continuation);
+      }
+    }
+  }
+};
+} // namespace detail
+
+/// An io_uring instance driven by an asio executor, which performs socket and file I/O with completion-based operations
+/// instead of the reactor's readiness notification followed by a read or write call.
+///
+/// Operations started within one handler or coroutine step are queued to the submission queue and submitted with one
+/// io_uring_enter call posted to the ring's executor, so a loop iteration costs one system call however many operations
+/// it starts. Completions are signalled through an eventfd awaited by the executor's reactor, and the completed
+/// coroutines are resumed in a batch. The eventfd is awaited only while there are operations in flight, so an idle ring
+/// doesn't keep io_context::run from returning.
+///
+/// The ring isn't thread-safe: create one ring per thread (io_context), and use it only from coroutines running on its
+/// executor. The ring must outlive all the operations on it, and there mustn't be operations in flight upon its
+/// destruction; cancel them with cancel() and await their completion first. The ring may be destroyed by the coroutine
+/// resumed by its last completion: the handlers it has queued keep its state alive.
+class uring_context {
+public:
+  /// Constructor. Creates a ring driven by the specified executor. Throws boost::system::system_error if io_uring is
+  /// not available, e.g. the kernel is too old or io_uring is disabled.
+  ///
+  /// \param executor           The executor submissions and completions are handled on.
+  /// \param entries            The size of the submission queue.
+  /// \param registered_files   The size of the registered files table.
+  template <class Executor>
+  explicit uring_context(const Executor &executor, unsigned entries = 256, unsigned registered_files = 1024)
+      : _state(std::make_shared<detail::uring_state>(executor, entries)) {
+    // The table is registered sparse, the files are put into it one by one. The ring works without the table if it
+    // can't be registered, the files just stay unregistered.
+    const std::vector<int> files(registered_files, -1);
+    if (registered_files != 0 &&
+        _state->queue().register_resource(IORING_REGISTER_FILES, files.data(), registered_files) == 0) {
+      for (auto index = registered_files; index != 0; --index) {
+        _free_file_indices.push_back(static_cast<int>(index - 1));
+      }
+    }
+  }
+
+  /// Constructor. Creates a ring driven by the specified io_context.
+  explicit uring_context(boost::asio::io_context &context, unsigned entries = 256, unsigned registered_files = 1024)
+      : uring_context(context.get_executor(), entries, registered_files) {}
+
+  uring_context(const uring_context &) = delete;
+
+  uring_context &operator=(const uring_context &) = delete;
+
+  /// Destructor. There mustn't be any operations in flight upon the ring destruction. The wait for completions is
+  /// cancelled, and the state is freed once the handlers still queued have run.
+  ~uring_context() {
+    assert(_state->pending() == 0);
+    _state->close();
+  }
+
+  /// Checks whether io_uring is available on this system.
+  static bool is_supported() noexcept {
+    try {
+      detail::io_uring_queue queue(1);
+      return true;
+    } catch (...) {
+      return false;
+    }
+  }
+
+  /// Returns the executor submissions and completions are handled on.
+  const detail::executor_type &get_executor() const noexcept { return _state->executor(); }
+
+  /// Puts the file descriptor into the registered files table. The file stays unregistered if the table is full or
+  /// the registration fails, operations on it work either way.
+  ///
+  /// \param fd   A file descriptor to register.
+  uring_file register_file(int fd) {
+    uring_file file{fd, -1};
+    if (_free_file_indices.empty()) {
+      return file;
+    }
+
+    const auto index = _free_file_indices.back();
+    if (update_file(index, fd)) {
+      _free_file_indices.pop_back();
+      file.index = index;
+    }
+
+    return file;
+  }
+
+  /// Removes the file from the registered files table. The file must not have operations in flight.
+  ///
+  /// \param file   A file to unregister, it's left unregistered.
+  void unregister_file(uring_file &file) {
+    if (file.registered() && update_file(file.index, -1)) {
+      _free_file_indices.push_back(file.index);
+    }
+
+    file.index = -1;
+  }
+
+  /// Returns an awaitable that receives data from the specified socket into the specified buffer.
+  ///
+  /// The awaitable returns a value of type async_read_result, see async_read for details. The operation fails with
+  /// boost::asio::error::eof if the peer has closed the connection.
+  ///
+  /// \param file     A socket to receive data from.
+  /// \param buffer   A buffer to receive data into.
+  inline auto async_recv(const uring_file &file, const boost::asio::mutable_buffer &buffer);
+
+  /// Returns an awaitable that receives data from the specified socket into a buffer the kernel picks from the
+  /// specified buffer ring once the data has arrived, so no buffer is held while the socket is idle.
+  ///
+  /// The awaitable returns a value of type uring_recv_result, where the first item contains the operation result, and
+  /// the second - the buffer the data has been received into. The operation fails with
+  /// boost::system::errc::no_buffer_space if the ring has run out of buffers, and with boost::asio::error::eof if the
+  /// peer has closed the connection.
+  ///
+  /// \param file   A socket to receive data from.
+  /// \param ring   A buffer ring registered with this uring_context.
+  inline auto async_recv(const uring_file &file, uring_buffer_ring &ring);
+
+  /// Returns an awaitable that sends the specified buffer to the specified socket.
+  ///
+  /// The awaitable returns a value of type async_write_result, see async_write for details.
+  ///
+  /// \param file     A socket to send data to.
+  /// \param buffer   A buffer to send.
+  inline auto async_send(const uring_file &file, const boost::asio::const_buffer &buffer);
+
+  /// Returns an awaitable that reads data from the specified file at the specified offset.
+  ///
+  /// The awaitable returns a value of type async_read_result, see async_read for details. The operation fails with
+  /// boost::asio::error::eof if the offset is at the end of the file.
+  ///
+  /// \param file     A file to read data from.
+  /// \param buffer   A buffer to read data into.
+  /// \param offset   The offset in the file to read data at.
+  inline auto async_read(const uring_file &file, const boost::asio::mutable_buffer &buffer, std::uint64_t offset);
+
+  /// Returns an awaitable that writes data to the specified file at the specified offset.
+  ///
+  /// The awaitable returns a value of type async_write_result, see async_write for details.
+  ///
+  /// \param file     A file to write data to.
+  /// \param buffer   A buffer to write.
+  /// \param offset   The offset in the file to write data at.
+  inline auto async_write(const uring_file &file, const boost::asio::const_buffer &buffer, std::uint64_t offset);
+
+  /// Cancels all the operations in flight on the specified file, they complete with operation_aborted error.
+  ///
+  /// \param file   A file to cancel the operations of.
+  void cancel(const uring_file &file) {
+    auto &sqe = _state->get_sqe();
+    prepare_entry(sqe, IORING_OP_ASYNC_CANCEL, uring_file{}, nullptr, 0, 0);
+    sqe.fd = file.registered() ? file.index : file.fd;
+    sqe.cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+    if (file.registered()) {
+      sqe.cancel_flags |= IORING_ASYNC_CANCEL_FD_FIXED;
+    }
+
+    _state->schedule_submit();
+  }
+
+  /// Queues an operation with the submission queue entry filled by the prepare function. The operation must stay
+  /// alive until it's completed either by resuming its continuation or by calling its complete function, which lets
+  /// handler-based operations be built on top of the ring.
+  ///
+  /// \param operation  The operation to start.
+  /// \param prepare    A function that fills the submission queue entry.
+  template <class Prepare> void start_operation(detail::io_uring_operation &operation, Prepare &&prepare) {
+    auto &sqe = _state->get_sqe();
+    prepare(sqe);
+    sqe.user_data = reinterpret_cast<std::uintptr_t>(&operation);
+    _state->started();
+  }
+
+  /// Fills the common fields of the submission queue entry.
+  static void prepare_entry(io_uring_sqe &sqe, std::uint8_t opcode, const uring_file &file, const void *address,
+                            std::size_t size, std::uint64_t offset) noexcept {
+    sqe.opcode = opcode;
+    sqe.fd = file.registered() ? file.index : file.fd;
+    sqe.flags = file.registered() ? IOSQE_FIXED_FILE : 0;
+    sqe.addr = reinterpret_cast<std::uintptr_t>(address);
+    sqe.len = static_cast<std::uint32_t>(size);
+    sqe.off = offset;
+  }
+
+  /// Returns the amount of operations started so far.
+  std::size_t operations() const noexcept { return _state->operations(); }
+
+  /// Returns the amount of io_uring_enter calls made so far.
+  std::size_t submissions() const noexcept { return _state->submissions(); }
+
+private:
+  friend class uring_buffer_ring;
+
+  std::shared_ptr<detail::uring_state> _state;
+  std::vector<int> _free_file_indices;
+
+  /// Returns an awaitable that fills a submission queue entry with the prepare function, and returns the result of the
+  /// complete function applied to the completed operation.
+  template <class Prepare, class Complete> auto start(Prepare prepare, Complete complete) {
+    class awaitable {
+    public:
+      explicit awaitable(uring_context &context, Prepare prepare, Complete complete)
+          : _context(context), _prepare(std::move(prepare)), _complete(std::move(complete)) {}
+
+      /// Sets the executor the awaiting coroutine is resumed on.
+      void set_executor(detail::executor_type executor) noexcept { _operation.executor = std::move(executor); }
+
+      constexpr bool await_ready() const noexcept { return false; }
+
+      auto await_resume() { return _complete(_operation); }
+
+      void await_suspend(detail::coroutine_handle<> continuation) {
+        _operation.continuation = continuation;
+        if (!_operation.executor) {
+          _operation.executor = _context.get_executor();
+        }
+
+        _context.start_operation(_operation, _prepare);
+      }
+
+    private:
+      uring_context &_context;
+      Prepare _prepare;
+      Complete _complete;
+      detail::io_uring_operation _operation;
+    };
+
+    return awaitable(*this, std::move(prepare), std::move(complete));
+  }
+
+  /// Converts the operation result to an error code. A zero-sized read of a non-empty buffer means the end of file.
+  static boost::system::error_code to_error(int result, bool zero_is_eof) noexcept {
+    if (result < 0) {
+      return boost::system::error_code(-result, boost::system::system_category());
+    }
+
+    if (result == 0 && zero_is_eof) {
+      return boost::asio::error::eof;
+    }
+
+    return {};
+  }
+
+  static std::size_t to_size(int result) noexcept { return result < 0 ? 0 : static_cast<std::size_t>(result); }
+
+  bool update_file(int index, int fd) {
+    io_uring_files_update update{};
+    update.offset = static_cast<std::uint32_t>(index);
+    update.fds = reinterpret_cast<std::uintptr_t>(&fd);
+    return _state->queue().register_resource(IORING_REGISTER_FILES_UPDATE, &update, 1) == 0;
+  }
+};
+
+
+/// A ring of buffers provided to the kernel, which picks a buffer for a receive only once the data has arrived, so a
+/// large amount of idle connections doesn't hold any buffers.
+///
+/// The buffers are allocated upon construction and given back to the ring once their provided_buffer handles are
+/// destroyed. The ring must outlive the handles and the receive operations using it.
+class uring_buffer_ring {
+public:
+  /// Constructor. Allocates the buffers and registers the ring with the specified uring_context. Throws
+  /// boost::system::system_error if the ring can't be registered, e.g. the kernel doesn't support buffer rings.
+  ///
+  /// \param context        The ring to register the buffers with.
+  /// \param group_id       The buffer group identifier, unique within the uring_context.
+  /// \param count          The amount of buffers, it's rounded up to a power of two.
+  /// \param buffer_size    The size of every buffer.
+  uring_buffer_ring(uring_context &context, std::uint16_t group_id, std::uint16_t count, std::size_t buffer_size)
+      : _context(context), _group_id(group_id), _buffer_size(buffer_size) {
+    while (_count < count && _count < 32768) {
+      _count *= 2;
+    }
+
+    _ring_size = _count * sizeof(io_uring_buf);
+    auto *const ring = ::mmap(nullptr, _ring_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ring == MAP_FAILED) {
+      detail::throw_system_error(errno, "mmap");
+    }
+
+    _ring = static_cast<io_uring_buf *>(ring);
+    _buffers.reset(new char[_count * _buffer_size]);
+
+    io_uring_buf_reg registration{};
+    registration.ring_addr = reinterpret_cast<std::uintptr_t>(_ring);
+    registration.ring_entries = _count;
+    registration.bgid = _group_id;
+    if (const auto error = _context._state->queue().register_resource(IORING_REGISTER_PBUF_RING, &registration, 1)) {
+      ::munmap(_ring, _ring_size);
+      detail::throw_system_error(-error, "io_uring_register");
+    }
+
+    for (std::uint32_t id = 0; id != _count; ++id) {
+      recycle(static_cast<std::uint16_t>(id));
+    }
+  }
+
+  uring_buffer_ring(const uring_buffer_ring &) = delete;
+
+  uring_buffer_ring &operator=(const uring_buffer_ring &) = delete;
+
+  /// Destructor. Unregisters the ring.
+  ~uring_buffer_ring() {
+    io_uring_buf_reg registration{};
+    registration.bgid = _group_id;
+    _context._state->queue().register_resource(IORING_UNREGISTER_PBUF_RING, &registration, 1);
+    ::munmap(_ring, _ring_size);
+  }
+
+  /// Returns the buffer group identifier.
+  std::uint16_t group_id() const noexcept { return _group_id; }
+
+  /// Returns the amount of buffers.
+  std::size_t count() const noexcept { return _count; }
+
+  /// Returns the size of every buffer.
+  std::size_t buffer_size() const noexcept { return _buffer_size; }
+
+  /// Returns the data of the buffer with the specified identifier.
+  char *data(std::uint16_t id) const noexcept { return _buffers.get() + id * _buffer_size; }
+
+  /// Gives the buffer with the specified identifier back to the kernel.
+  void recycle(std::uint16_t id) noexcept {
+    auto &buffer = _ring[_tail & (_count - 1)];
+    buffer.addr = reinterpret_cast<std::uintptr_t>(data(id));
+    buffer.len = static_cast<std::uint32_t>(_buffer_size);
+    buffer.bid = id;
+    ++_tail;
+
+    // The tail of the ring overlays the reserved field of the first buffer.
+    __atomic_store_n(&_ring->resv, _tail, __ATOMIC_RELEASE);
+  }
+
+private:
+  uring_context &_context;
+  const std::uint16_t _group_id;
+  const std::size_t _buffer_size;
+  std::uint32_t _count = 1;
+  std::uint16_t _tail = 0;
+  std::size_t _ring_size = 0;
+  io_uring_buf *_ring = nullptr;
+  std::unique_ptr<char[]> _buffers;
+};
+
+void provided_buffer::reset() noexcept {
+  if (_ring) {
+    _ring->recycle(_id);
+    _ring = nullptr;
+    _size = 0;
+  }
+}
+
+char *provided_buffer::data() const noexcept { return _ring ? _ring->data(_id) : nullptr; }
+
+auto uring_context::async_recv(const uring_file &file, const boost::asio::mutable_buffer &buffer) {
+  return start(
+      [file, buffer](io_uring_sqe &sqe) {
+        prepare_entry(sqe, IORING_OP_RECV, file, buffer.data(), buffer.size(), 0);
+      },
+      [size = buffer.size()](const detail::io_uring_operation &operation) {
+        return async_read_result(to_error(operation.result, size != 0), to_size(operation.result));
+      });
+}
+
+auto uring_context::async_send(const uring_file &file, const boost::asio::const_buffer &buffer) {
+  return start(
+      [file, buffer](io_uring_sqe &sqe) {
+        prepare_entry(sqe, IORING_OP_SEND, file, buffer.data(), buffer.size(), 0);
+        sqe.msg_flags = MSG_NOSIGNAL;
+      },
+      [](const detail::io_uring_operation &operation) {
+        return async_write_result(to_error(operation.result, false), to_size(operation.result));
+      });
+}
+
+auto uring_context::async_read(const uring_file &file, const boost::asio::mutable_buffer &buffer,
+                               std::uint64_t offset) {
+  return start(
+      [file, buffer, offset](io_uring_sqe &sqe) {
+        prepare_entry(sqe, IORING_OP_READ, file, buffer.data(), buffer.size(), offset);
+      },
+      [size = buffer.size()](const detail::io_uring_operation &operation) {
+        return async_read_result(to_error(operation.result, size != 0), to_size(operation.result));
+      });
+}
+
+auto uring_context::async_write(const uring_file &file, const boost::asio::const_buffer &buffer,
+                               std::uint64_t offset) {
+  return start(
+      [file, buffer, offset](io_uring_sqe &sqe) {
+        prepare_entry(sqe, IORING_OP_WRITE, file, buffer.data(), buffer.size(), offset);
+      },
+      [](const detail::io_uring_operation &operation) {
+        return async_write_result(to_error(operation.result, false), to_size(operation.result));
+      });
+}
+
+auto uring_context::async_recv(const uring_file &file, uring_buffer_ring &ring) {
+  return start(
+      [file, group_id = ring.group_id()](io_uring_sqe &sqe) {
+        prepare_entry(sqe, IORING_OP_RECV, file, nullptr, 0, 0);
+        sqe.flags |= IOSQE_BUFFER_SELECT;
+        sqe.buf_group = group_id;
+      },
+      [&ring](const detail::io_uring_operation &operation) {
+        uring_recv_result result;
+        if ((operation.flags & IORING_CQE_F_BUFFER) != 0) {
+          const auto id = static_cast<std::uint16_t>(operation.flags >> IORING_CQE_BUFFER_SHIFT);
+          result.second = provided_buffer(ring, id, to_size(operation.result));
+        }
+
+        result.first = to_error(operation.result, true);
+        return result;
+      });
+}
+} // namespace asio_coro
+
+#endif // defined(__linux__) && __has_include(<linux/io_uring.h>)
+
+#endif // ASIO_CORO_EXTENSIONS_IO_URING_HPP
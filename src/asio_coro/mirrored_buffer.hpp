@@ -0,0 +1,240 @@
+#ifndef ASIO_CORO_EXTENSIONS_MIRRORED_BUFFER_HPP
+#define ASIO_CORO_EXTENSIONS_MIRRORED_BUFFER_HPP
+
+#include "async_read.hpp"
+#include "async_write.hpp"
+#include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/scope_exit.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/system/system_error.hpp>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <utility>
+
+namespace asio_coro {
+/// A ring buffer mapped twice into adjacent virtual memory, so the byte following the last byte of the buffer is the
+/// first byte again. Both the readable and the writable region are always one contiguous span however they wrap
+/// around, so data is read into the buffer and parsed in place without splitting reads, writes, and messages at the
+/// wrap point, and without copying anything to the beginning of the buffer.
+///
+/// The buffer is backed by a memfd mapped twice with MAP_FIXED into a reserved region, so it's only available on
+/// Linux, and its capacity is a multiple of the page size. Use async_read and async_write overloads accepting a
+/// mirrored_buffer to fill and drain it.
+class mirrored_buffer {
+public:
+  /// Constructor. Creates an empty buffer. Throws boost::system::system_error if the buffer can't be mapped.
+  ///
+  /// \param capacity   The minimal capacity of the buffer, it's rounded up to the page size.
+  explicit mirrored_buffer(std::size_t capacity) {
+    const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    _capacity = std::max<std::size_t>((capacity + page_size - 1) / page_size, 1) * page_size;
+
+    const auto fd = ::memfd_create("asio_coro_mirrored_buffer", MFD_CLOEXEC);
+    if (fd == -1) {
+      throw_error("memfd_create");
+    }
+
+    // The file isn't needed once it's mapped, the mappings keep the memory alive.
+    struct file_closer {
+      int fd;
+      ~file_closer() { ::close(fd); }
+    } closer{fd};
+
+    if (::ftruncate(fd, static_cast<off_t>(_capacity)) == -1) {
+      throw_error("ftruncate");
+    }
+
+    // Reserve the address range for both mappings first, so nothing else can be mapped in between.
+    auto *const region = ::mmap(nullptr, _capacity * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED) {
+      throw_error("mmap");
+    }
+
+    _data = static_cast<char *>(region);
+    for (auto *address : {_data, _data + _capacity}) {
+      if (::mmap(address, _capacity, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        const auto error = errno;
+        ::munmap(_data, _capacity * 2);
+        errno = error;
+        throw_error("mmap");
+      }
+    }
+  }
+
+  mirrored_buffer(mirrored_buffer &&other) noexcept
+      : _data(std::exchange(other._data, nullptr)), _capacity(std::exchange(other._capacity, 0)),
+        _begin(std::exchange(other._begin, 0)), _size(std::exchange(other._size, 0)) {}
+
+  mirrored_buffer &operator=(mirrored_buffer &&other) noexcept {
+    if (this != &other) {
+      unmap();
+      _data = std::exchange(other._data, nullptr);
+      _capacity = std::exchange(other._capacity, 0);
+      _begin = std::exchange(other._begin, 0);
+      _size = std::exchange(other._size, 0);
+    }
+
+    return *this;
+  }
+
+  mirrored_buffer(const mirrored_buffer &) = delete;
+
+  mirrored_buffer &operator=(const mirrored_buffer &) = delete;
+
+  /// Destructor. Unmaps the buffer.
+  ~mirrored_buffer() { unmap(); }
+
+  /// Returns the readable region of the buffer, i.e. the data written but not consumed yet.
+  boost::asio::const_buffer data() const noexcept { return boost::asio::const_buffer(_data + _begin, _size); }
+
+  /// Returns the writable region of the buffer, i.e. all the free space.
+  boost::asio::mutable_buffer prepare() noexcept {
+    return boost::asio::mutable_buffer(_data + (_begin + _size) % _capacity, _capacity - _size);
+  }
+
+  /// Makes the specified amount of bytes at the beginning of the writable region readable.
+  void commit(std::size_t size) noexcept {
+    assert(size <= _capacity - _size);
+    _size += size;
+  }
+
+  /// Removes the specified amount of bytes from the beginning of the readable region.
+  void consume(std::size_t size) noexcept {
+    size = std::min(size, _size);
+    _begin = (_begin + size) % _capacity;
+    _size -= size;
+  }
+
+  /// Returns the amount of readable bytes.
+  std::size_t size() const noexcept { return _size; }
+
+  /// Returns the capacity of the buffer.
+  std::size_t capacity() const noexcept { return _capacity; }
+
+  /// Checks whether the buffer has no readable bytes.
+  bool empty() const noexcept { return _size == 0; }
+
+  /// Checks whether the buffer has no free space.
+  bool full() const noexcept { return _size == _capacity; }
+
+private:
+  char *_data = nullptr;
+  std::size_t _capacity = 0;
+  std::size_t _begin = 0;
+  std::size_t _size = 0;
+
+  void unmap() noexcept {
+    if (_data) {
+      ::munmap(_data, _capacity * 2);
+    }
+  }
+
+  [[noreturn]] static void throw_error(const char *what) {
+    throw boost::system::system_error(boost::system::error_code(errno, boost::system::system_category()), what);
+  }
+};
+
+/// Returns an awaitable that suspends the awaiting coroutine, performs one asynchronous read from the specified socket
+/// into the free space of the specified mirrored buffer, and resumes the awaiting coroutine.
+///
+/// The free space is always contiguous, so the read is never split at the end of the ring. The bytes read are committed
+/// to the buffer, so they're readable via mirrored_buffer::data right away.
+///
+/// The awaitable returns a value of type async_read_result, see async_read for details on return value.
+///
+/// \param stream   A socket to read data from.
+/// \param buffer   A buffer to read data into. It must have free space, and it must outlive the operation.
+template <class Stream> auto async_read(Stream &stream, mirrored_buffer &buffer) {
+  class awaitable {
+  public:
+    explicit awaitable(Stream &stream, mirrored_buffer &buffer) : _stream(stream), _buffer(buffer) {}
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    async_read_result await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _stream);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                        std::size_t size) mutable {
+        _buffer.commit(size);
+        _result = std::make_pair(error, size);
+        holder.release().resume();
+      };
+      _stream.async_read_some(_buffer.prepare(), boost::asio::bind_executor(std::move(executor), std::move(handler)));
+    }
+
+  private:
+    Stream &_stream;
+    mirrored_buffer &_buffer;
+    async_read_result _result;
+    detail::executor_type _executor;
+  };
+
+  return awaitable(stream, buffer);
+}
+
+/// Returns an awaitable that suspends the awaiting coroutine, writes some of the readable data of the specified
+/// mirrored buffer into the specified socket and resumes the suspended coroutine.
+///
+/// The readable data is always contiguous, so the write is never split at the end of the ring. The bytes written are
+/// consumed from the buffer.
+///
+/// The awaitable returns an instance of async_write_result, see async_write for details.
+///
+/// \param stream   A socket to write data into.
+/// \param buffer   A buffer to write data from. It must outlive the operation.
+template <class Stream> auto async_write(Stream &stream, mirrored_buffer &buffer) {
+  class awaitable {
+  public:
+    explicit awaitable(Stream &stream, mirrored_buffer &buffer) : _stream(stream), _buffer(buffer) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    async_write_result await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _stream);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                        std::size_t size) mutable {
+        _buffer.consume(size);
+        _result = std::make_pair(error, size);
+        holder.release().resume();
+      };
+      _stream.async_write_some(_buffer.data(), boost::asio::bind_executor(std::move(executor), std::move(handler)));
+    }
+
+  private:
+    Stream &_stream;
+    mirrored_buffer &_buffer;
+    async_write_result _result;
+    detail::executor_type _executor;
+  };
+
+  return awaitable(stream, buffer);
+}
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_MIRRORED_BUFFER_HPP
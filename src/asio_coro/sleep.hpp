@@ -0,0 +1,85 @@
+#ifndef ASIO_CORO_EXTENSIONS_SLEEP_HPP
+#define ASIO_CORO_EXTENSIONS_SLEEP_HPP
+
+#include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
+#include "detail/timer_pool.hpp"
+
+#include <boost/scope_exit.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <chrono>
+
+namespace asio_coro {
+/// Sets the slack the sleep_for/sleep_until deadlines are rounded up to within the execution context of the specified
+/// executor. Sleepers whose rounded deadlines are equal share one underlying timer, so the larger the slack, the fewer
+/// timers the reactor has to arm, at the cost of resuming sleepers up to the slack late. The slack is zero by default.
+///
+/// \param executor   An executor or an execution context.
+/// \param slack      The slack to round deadlines up to.
+template <class Executor> void set_sleep_slack(Executor &&executor, std::chrono::steady_clock::duration slack) {
+  boost::asio::use_service<detail::timer_pool_service>(detail::get_execution_context(executor)).set_slack(slack);
+}
+
+/// Returns an awaitable that suspends the awaiting coroutine until the specified time point. The underlying timer is
+/// taken from the pool of the executor's execution context and returned back upon resumption.
+///
+/// The coroutine is resumed on its associated executor if it has one, otherwise on the specified executor. The
+/// awaitable returns an instance of boost::system::error_code that contains the operation result.
+///
+/// \param executor   An executor or an execution context the timer belongs to. The awaitable doesn't keep it, so it may
+///                   be a temporary, e.g. a new strand.
+/// \param deadline   The time point to resume the coroutine at.
+template <class Executor> auto sleep_until(Executor &&executor, std::chrono::steady_clock::time_point deadline) {
+  class awaitable {
+  public:
+    explicit awaitable(Executor &executor, std::chrono::steady_clock::time_point deadline)
+        : _service(boost::asio::use_service<detail::timer_pool_service>(detail::get_execution_context(executor))),
+          _deadline(_service.round_deadline(deadline)), _io_executor(detail::get_timer_executor(executor)),
+          _executor(detail::get_io_executor(executor)) {}
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept {
+      if (executor) {
+        _executor = std::move(executor);
+      }
+    }
+
+    bool await_ready() const noexcept { return _deadline <= std::chrono::steady_clock::now(); }
+
+    boost::system::error_code await_resume() const noexcept { return _result; }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error) mutable {
+        _result = error;
+        holder.release().resume();
+      };
+      _service.wait(_deadline, _io_executor, _executor, std::move(handler));
+    }
+
+  private:
+    detail::timer_pool_service &_service;
+    std::chrono::steady_clock::time_point _deadline;
+    const detail::executor_type _io_executor;
+    detail::executor_type _executor;
+    boost::system::error_code _result;
+  };
+
+  return awaitable(executor, deadline);
+}
+
+/// Returns an awaitable that suspends the awaiting coroutine for the specified duration.
+///
+/// The awaitable returns an instance of boost::system::error_code, see sleep_until for details.
+///
+/// \param executor   An executor or an execution context the timer belongs to.
+/// \param timeout    The duration to suspend the coroutine for.
+template <class Executor> auto sleep_for(Executor &&executor, std::chrono::steady_clock::duration timeout) {
+  return sleep_until(executor, std::chrono::steady_clock::now() + timeout);
+}
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_SLEEP_HPP
@@ -0,0 +1,326 @@
+#ifndef ASIO_CORO_EXTENSIONS_SSL_STREAM_HPP
+#define ASIO_CORO_EXTENSIONS_SSL_STREAM_HPP
+
+#include "detail/coroutine.hpp"
+#include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/scope_exit.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <openssl/ssl.h>
+
+#include <array>
+#include <atomic>
+#include <ctime>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+namespace asio_coro {
+/// Returns an awaitable that suspends the awaiting coroutine, performs the TLS handshake over the specified stream, and
+/// resumes the awaiting coroutine.
+///
+/// Once the handshake is done, the data is read from and written to the stream with async_read and async_write.
+///
+/// The awaitable returns an instance of boost::system::error_code.
+///
+/// \param stream   A stream to perform the handshake over, e.g. boost::asio::ssl::stream<boost::asio::ip::tcp::socket>.
+/// \param type     The side of the connection the stream is, either boost::asio::ssl::stream_base::client or server.
+template <class Stream> auto async_handshake(Stream &stream, boost::asio::ssl::stream_base::handshake_type type) {
+  class awaitable {
+  public:
+    explicit awaitable(Stream &stream, boost::asio::ssl::stream_base::handshake_type type) noexcept
+        : _stream(stream), _type(type) {}
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    boost::system::error_code await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _stream);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error) mutable {
+        _result = error;
+        holder.release().resume();
+      };
+      _stream.async_handshake(_type, boost::asio::bind_executor(std::move(executor), std::move(handler)));
+    }
+
+  private:
+    Stream &_stream;
+    boost::asio::ssl::stream_base::handshake_type _type;
+    boost::system::error_code _result;
+    detail::executor_type _executor;
+  };
+
+  return awaitable(stream, type);
+}
+
+/// Returns an awaitable that suspends the awaiting coroutine, shuts the TLS session of the specified stream down, and
+/// resumes the awaiting coroutine. The underlying socket remains open.
+///
+/// The awaitable returns an instance of boost::system::error_code. Peers often close the connection without replying
+/// to the close notification, in which case the error is either boost::asio::error::eof or
+/// boost::asio::ssl::error::stream_truncated, and the session is shut down anyway.
+///
+/// \param stream   A stream to shut down, e.g. boost::asio::ssl::stream<boost::asio::ip::tcp::socket>.
+template <class Stream> auto async_shutdown(Stream &stream) {
+  class awaitable {
+  public:
+    explicit awaitable(Stream &stream) noexcept : _stream(stream) {}
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    boost::system::error_code await_resume() const noexcept { return _result; }
+
+    /// Sets the executor the awaiting coroutine is resumed on.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    void await_suspend(detail::coroutine_handle<> continuation) {
+      auto executor = detail::get_executor(_executor, _stream);
+      detail::coroutine_holder<> holder(continuation);
+      BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+      auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error) mutable {
+        _result = error;
+        holder.release().resume();
+      };
+      _stream.async_shutdown(boost::asio::bind_executor(std::move(executor), std::move(handler)));
+    }
+
+  private:
+    Stream &_stream;
+    boost::system::error_code _result;
+    detail::executor_type _executor;
+  };
+
+  return awaitable(stream);
+}
+
+/// Returns whether the TLS session of the specified stream has been resumed by its handshake rather than established
+/// with a full one.
+template <class Stream> bool session_reused(Stream &stream) noexcept {
+  return SSL_session_reused(stream.native_handle()) == 1;
+}
+
+/// A cache of the TLS sessions of the client connections of a process, which may run on many threads, so reconnecting
+/// to a server resumes the session established by a previous connection and skips the full handshake, i.e. the key
+/// exchange and the verification of the certificate chain.
+///
+/// Sessions are cached by keys picked by the caller, usually the host name and the port of the server. The sessions
+/// arrive via the session callback of the client context, which must be attached to the cache, so the TLS 1.3 session
+/// tickets the server sends after the handshake are cached too. Those are only processed once the client reads from
+/// the stream. OpenSSL invalidates the session of a connection freed without shutting it down, so the streams must be
+/// shut down with async_shutdown for their sessions to be resumed. A TLS 1.3 session is handed to one connection only,
+/// which stores the ticket the server sends it in turn, so concurrent connections to the same server don't share a
+/// ticket. Sessions are dropped once they time out, and the least recently stored ones are dropped once a shard is
+/// full.
+///
+/// The cache is split into shards with their own locks, which are picked by the hash of the key, so threads connecting
+/// to different servers rarely contend. The cache must outlive the streams it's used with.
+class tls_session_cache {
+public:
+  /// The amount of shards the cache is split into.
+  static constexpr std::size_t shards_count = 16;
+
+  /// Constructor. Creates an empty cache.
+  ///
+  /// \param shard_capacity   The maximum amount of sessions a shard holds.
+  explicit tls_session_cache(std::size_t shard_capacity = 256) : _shard_capacity(shard_capacity) {}
+
+  tls_session_cache(const tls_session_cache &) = delete;
+
+  tls_session_cache &operator=(const tls_session_cache &) = delete;
+
+  /// Returns the cache shared by the whole process.
+  static tls_session_cache &instance() {
+    static tls_session_cache cache;
+    return cache;
+  }
+
+  /// Makes the client connections of the specified context store their sessions into a cache once they're
+  /// established. The context must not be shared with the streams of other caches.
+  static void attach(boost::asio::ssl::context &context) {
+    // The sessions are stored by the cache only, since the internal cache of a context isn't used by clients.
+    SSL_CTX_set_session_cache_mode(context.native_handle(), SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(context.native_handle(), &on_new_session);
+  }
+
+  /// Prepares the specified client stream to resume the session cached with the specified key if any, and to store the
+  /// session it establishes with that key. Must be called before the handshake.
+  template <class Stream> void prepare(Stream &stream, std::string key) {
+    const auto ssl = stream.native_handle();
+    if (const auto session = find(key)) {
+      SSL_set_session(ssl, session.get());
+    }
+
+    delete static_cast<stream_key *>(SSL_get_ex_data(ssl, key_index()));
+    SSL_set_ex_data(ssl, key_index(), new stream_key{this, std::move(key)});
+  }
+
+  /// Returns the amount of cached sessions.
+  std::size_t size() const {
+    std::size_t result = 0;
+    for (auto &shard : _shards) {
+      std::lock_guard lock(shard.mutex);
+      result += shard.sessions.size();
+    }
+
+    return result;
+  }
+
+  /// Returns the amount of streams prepared with a cached session.
+  std::size_t hits() const noexcept { return _hits.load(std::memory_order_relaxed); }
+
+  /// Returns the amount of streams prepared without a cached session.
+  std::size_t misses() const noexcept { return _misses.load(std::memory_order_relaxed); }
+
+  /// Removes the session cached with the specified key if any, e.g. after the server has rejected it.
+  void erase(const std::string &key) {
+    auto &shard = shard_of(key);
+    std::lock_guard lock(shard.mutex);
+    if (const auto it = shard.sessions.find(key); it != shard.sessions.end()) {
+      shard.order.erase(it->second.position);
+      shard.sessions.erase(it);
+    }
+  }
+
+  /// Removes all the cached sessions.
+  void clear() {
+    for (auto &shard : _shards) {
+      std::lock_guard lock(shard.mutex);
+      shard.sessions.clear();
+      shard.order.clear();
+    }
+  }
+
+private:
+  using session_ptr = std::shared_ptr<SSL_SESSION>;
+
+  /// The cache and the key a stream stores its session with, kept in the extra data of the stream.
+  struct stream_key {
+    tls_session_cache *cache;
+    std::string key;
+  };
+
+  struct entry {
+    session_ptr session;
+    std::list<std::string>::iterator position;
+  };
+
+  struct shard {
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, entry> sessions;
+    /// The keys of the sessions, the least recently stored first.
+    std::list<std::string> order;
+  };
+
+  std::size_t _shard_capacity;
+  std::array<shard, shards_count> _shards;
+  std::atomic<std::size_t> _hits = 0;
+  std::atomic<std::size_t> _misses = 0;
+
+  shard &shard_of(const std::string &key) noexcept { return _shards[std::hash<std::string>()(key) % shards_count]; }
+
+  /// Returns the index of the extra data of SSL objects the stream key is kept in.
+  static int key_index() {
+    static const int index = SSL_get_ex_new_index(
+        0, nullptr, nullptr, nullptr,
+        [](void *, void *key, CRYPTO_EX_DATA *, int, long, void *) { delete static_cast<stream_key *>(key); });
+    return index;
+  }
+
+  static int on_new_session(SSL *ssl, SSL_SESSION *session) {
+    const auto key = static_cast<stream_key *>(SSL_get_ex_data(ssl, key_index()));
+    if (!key) {
+      // The stream hasn't been prepared, so the session isn't taken.
+      return 0;
+    }
+
+    key->cache->store(key->key, session_ptr(session, &SSL_SESSION_free));
+    return 1;
+  }
+
+  /// Returns the session cached with the specified key if it's still resumable, taking a TLS 1.3 one out of the cache.
+  session_ptr find(const std::string &key) {
+    auto &shard = shard_of(key);
+    std::unique_lock lock(shard.mutex);
+    const auto it = shard.sessions.find(key);
+    if (it == shard.sessions.end()) {
+      lock.unlock();
+      _misses.fetch_add(1, std::memory_order_relaxed);
+      return {};
+    }
+
+    const auto session = it->second.session.get();
+    if (!SSL_SESSION_is_resumable(session) ||
+        SSL_SESSION_get_time(session) + SSL_SESSION_get_timeout(session) <= std::time(nullptr)) {
+      shard.order.erase(it->second.position);
+      shard.sessions.erase(it);
+      lock.unlock();
+      _misses.fetch_add(1, std::memory_order_relaxed);
+      return {};
+    }
+
+    // A TLS 1.3 session ticket is meant to be used by one connection only, and a resumed connection receives a new one,
+    // so the ticket is taken out of the cache. The sessions of the earlier versions may be resumed by many connections.
+    auto result = it->second.session;
+    if (SSL_SESSION_get_protocol_version(session) >= TLS1_3_VERSION) {
+      shard.order.erase(it->second.position);
+      shard.sessions.erase(it);
+    }
+
+    lock.unlock();
+    _hits.fetch_add(1, std::memory_order_relaxed);
+    return result;
+  }
+
+  /// Caches the specified session with the specified key, replacing the one cached before.
+  void store(const std::string &key, session_ptr session) {
+    auto &shard = shard_of(key);
+    std::lock_guard lock(shard.mutex);
+    if (const auto it = shard.sessions.find(key); it != shard.sessions.end()) {
+      it->second.session = std::move(session);
+      shard.order.splice(shard.order.end(), shard.order, it->second.position);
+      return;
+    }
+
+    if (shard.sessions.size() >= _shard_capacity && !shard.order.empty()) {
+      shard.sessions.erase(shard.order.front());
+      shard.order.pop_front();
+    }
+
+    shard.order.push_back(key);
+    shard.sessions.emplace(key, entry{std::move(session), std::prev(shard.order.end())});
+  }
+};
+
+/// Returns an awaitable that suspends the awaiting coroutine, performs the client TLS handshake over the specified
+/// stream, resuming the session cached with the specified key if any, and resumes the awaiting coroutine. The session
+/// established by the handshake is stored into the cache, see tls_session_cache.
+///
+/// The awaitable returns an instance of boost::system::error_code. Whether the session has been resumed is returned by
+/// session_reused.
+///
+/// \param stream   A client stream, the context of which is attached to the cache with tls_session_cache::attach.
+/// \param cache    The cache to take the session from, e.g. tls_session_cache::instance().
+/// \param key      The key the session is cached with, e.g. the host name and the port of the server.
+template <class Stream> auto async_handshake(Stream &stream, tls_session_cache &cache, std::string key) {
+  cache.prepare(stream, std::move(key));
+  return async_handshake(stream, boost::asio::ssl::stream_base::client);
+}
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_SSL_STREAM_HPP
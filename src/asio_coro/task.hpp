@@ -8,23 +8,53 @@
 namespace asio_coro {
 template <class T = void> using task = detail::task<T>;
 using void_task = task<void>;
+using executor_type = detail::executor_type;
 
 /// Runs coroutine returning task<...> within the specified executor context. Coroutine may be either a function or a
 /// functional object. If coroutine is a functional object, the functional object is copied prior to running.
 ///
-/// \param executor   An executor for running the coroutine.
+/// The coroutine is associated with a strand: either the specified executor itself if it's already a strand, or a new
+/// strand created over the specified executor or execution context. The coroutine and every awaitable it awaits are
+/// resumed on that strand, so the coroutine may be safely run by an io_context running on multiple threads.
+///
+/// \param executor   An executor or an execution context for running the coroutine.
 /// \param handler    A coroutine function.
-template <class Executor, class Handler> void spawn_coroutine(Executor &executor, Handler &&handler) {
-  boost::asio::post(executor, [handler = std::move(handler)]() mutable {
+template <class Executor, class Handler> void spawn_coroutine(Executor &&executor, Handler &&handler) {
+  auto coroutine_executor = detail::make_default_executor(executor);
+  boost::asio::post(coroutine_executor, [coroutine_executor, handler = std::move(handler)]() mutable {
     auto wrapper_coroutine = [](auto &&handler_argument) mutable -> task<void> {
       auto handler = std::move(handler_argument);
       co_await handler();
     };
 
     auto wrapper_coroutine_task = wrapper_coroutine(std::move(handler));
+    wrapper_coroutine_task.set_executor(std::move(coroutine_executor));
     wrapper_coroutine_task.release().resume();
   });
 }
+
+/// Returns an awaitable that doesn't suspend the awaiting coroutine and returns the executor associated with it.
+///
+/// The awaitable returns an instance of boost::asio::any_io_executor, which is empty if the awaiting coroutine has not
+/// been spawned with spawn_coroutine.
+inline auto current_executor() noexcept {
+  class awaitable {
+  public:
+    /// Sets the executor associated with the awaiting coroutine.
+    void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+    constexpr bool await_ready() const noexcept { return true; }
+
+    detail::executor_type await_resume() noexcept { return std::move(_executor); }
+
+    constexpr void await_suspend(detail::coroutine_handle<>) const noexcept {}
+
+  private:
+    detail::executor_type _executor;
+  };
+
+  return awaitable();
+}
 } // namespace asio_coro
 
 #endif // ASIO_CORO_EXTENSIONS_TASK_HPP
@@ -0,0 +1,192 @@
+#ifndef ASIO_CORO_EXTENSIONS_TIMER_WHEEL_HPP
+#define ASIO_CORO_EXTENSIONS_TIMER_WHEEL_HPP
+
+#include "detail/executor.hpp"
+#include "detail/timer_wheel.hpp"
+
+#include <boost/system/error_code.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+namespace asio_coro {
+/// A hierarchical timing wheel that serves large amounts of coarse timeouts, e.g. idle/keep-alive connection timeouts,
+/// with a single underlying timer.
+///
+/// Timeouts are rounded up to the wheel resolution, so a waiting coroutine is never resumed early but may be resumed up
+/// to one resolution late. Arming and cancelling a timeout takes constant time and never allocates. The wheel may be
+/// shared between coroutines running on different threads.
+class timer_wheel {
+public:
+  using clock_type = std::chrono::steady_clock;
+  using duration = clock_type::duration;
+  using time_point = clock_type::time_point;
+
+  /// Constructor. Creates a timer wheel that ticks on the specified executor with the specified resolution.
+  template <class Executor>
+  explicit timer_wheel(const Executor &executor, duration resolution = std::chrono::milliseconds(100))
+      : _state(std::make_shared<detail::timer_wheel_state>(executor, resolution)) {}
+
+  /// Constructor. Creates a timer wheel that ticks on the specified io_context with the specified resolution.
+  explicit timer_wheel(boost::asio::io_context &context, duration resolution = std::chrono::milliseconds(100))
+      : timer_wheel(context.get_executor(), resolution) {}
+
+  timer_wheel(const timer_wheel &) = delete;
+
+  timer_wheel &operator=(const timer_wheel &) = delete;
+
+  /// Destructor. Resumes the pending waiters with operation_aborted error.
+  ~timer_wheel() { stop(); }
+
+  /// Resumes all the pending waiters with operation_aborted error. Waiters awaiting the wheel after it's stopped are
+  /// resumed immediately with the same error.
+  void stop() { _state->stop(); }
+
+  /// Returns the duration of one wheel tick.
+  duration resolution() const noexcept { return _state->resolution(); }
+
+  /// Returns an awaitable that suspends the awaiting coroutine until the specified time point.
+  ///
+  /// The awaitable returns an instance of boost::system::error_code, which contains operation_aborted error if the
+  /// wheel has been stopped.
+  ///
+  /// \param time   The time point to resume the coroutine at.
+  auto sleep_until(time_point time) {
+    class awaitable {
+    public:
+      explicit awaitable(detail::timer_wheel_state &state, std::uint64_t expiry_tick) : _state(state) {
+        _entry.expiry_tick = expiry_tick;
+      }
+
+      // The awaiting coroutine may be destroyed without being resumed, e.g. upon io_context destruction.
+      ~awaitable() { _state.remove(&_entry); }
+
+      /// Sets the executor the awaiting coroutine is resumed on.
+      void set_executor(detail::executor_type executor) noexcept { _entry.executor = std::move(executor); }
+
+      bool await_ready() const noexcept { return false; }
+
+      boost::system::error_code await_resume() const noexcept { return _entry.result; }
+
+      bool await_suspend(detail::coroutine_handle<> continuation) {
+        _entry.continuation = continuation;
+        if (!_state.arm(&_entry)) {
+          _entry.result = boost::asio::error::operation_aborted;
+          return false;
+        }
+
+        return true;
+      }
+
+    private:
+      detail::timer_wheel_state &_state;
+      detail::timer_wheel_entry _entry;
+    };
+
+    return awaitable(*_state, _state->to_tick_ceil(time));
+  }
+
+  /// Returns an awaitable that suspends the awaiting coroutine for the specified duration.
+  ///
+  /// The awaitable returns an instance of boost::system::error_code, see sleep_until for details.
+  ///
+  /// \param timeout  The duration to suspend the coroutine for.
+  auto sleep_for(duration timeout) { return sleep_until(clock_type::now() + timeout); }
+
+  /// An activity-based idle timeout. The owner calls touch() on every activity, which is a single atomic store, and a
+  /// watchdog coroutine awaits async_wait() that resumes once there has been no activity for the whole timeout.
+  class idle_timer {
+  public:
+    /// Constructor. Creates an idle timer with the specified timeout. The timer is considered active upon creation.
+    idle_timer(timer_wheel &wheel, duration timeout)
+        : _state(wheel._state), _idle_ticks(std::max<std::uint64_t>(_state->to_ticks_ceil(timeout), 1)),
+          _last_active_tick(_state->now_tick()) {}
+
+    idle_timer(const idle_timer &) = delete;
+
+    idle_timer &operator=(const idle_timer &) = delete;
+
+    /// Destructor. There must be no coroutine awaiting the timer upon destruction.
+    ~idle_timer() { assert(!_entry); }
+
+    /// Marks the timer active, so the idle timeout restarts from now.
+    void touch() noexcept { _last_active_tick.store(_state->now_tick(), std::memory_order_relaxed); }
+
+    /// Resumes the awaiting coroutine if any with operation_aborted error. Must be called within the executor (strand)
+    /// of the awaiting coroutine.
+    void cancel() {
+      if (_entry) {
+        _state->cancel(_entry);
+      }
+    }
+
+    /// Returns an awaitable that suspends the awaiting coroutine until the timer hasn't been touched for the whole
+    /// timeout.
+    ///
+    /// The awaitable returns an instance of boost::system::error_code, which contains operation_aborted error if the
+    /// timer has been cancelled or the wheel has been stopped.
+    auto async_wait() {
+      class awaitable {
+      public:
+        explicit awaitable(idle_timer &timer) noexcept : _timer(timer) {
+          _entry.last_active_tick = &_timer._last_active_tick;
+          _entry.idle_ticks = _timer._idle_ticks;
+        }
+
+        // The awaiting coroutine may be destroyed without being resumed, e.g. upon io_context destruction.
+        ~awaitable() {
+          _timer._state->remove(&_entry);
+          if (_timer._entry == &_entry) {
+            _timer._entry = nullptr;
+          }
+        }
+
+        /// Sets the executor the awaiting coroutine is resumed on.
+        void set_executor(detail::executor_type executor) noexcept { _entry.executor = std::move(executor); }
+
+        bool await_ready() const noexcept { return false; }
+
+        boost::system::error_code await_resume() noexcept {
+          _timer._entry = nullptr;
+          return _entry.result;
+        }
+
+        bool await_suspend(detail::coroutine_handle<> continuation) {
+          _entry.continuation = continuation;
+          _entry.expiry_tick = _timer._last_active_tick.load(std::memory_order_relaxed) + _entry.idle_ticks;
+
+          _timer._entry = &_entry;
+          if (!_timer._state->arm(&_entry)) {
+            _timer._entry = nullptr;
+            _entry.result = boost::asio::error::operation_aborted;
+            return false;
+          }
+
+          return true;
+        }
+
+      private:
+        idle_timer &_timer;
+        detail::timer_wheel_entry _entry;
+      };
+
+      return awaitable(*this);
+    }
+
+  private:
+    std::shared_ptr<detail::timer_wheel_state> _state;
+    const std::uint64_t _idle_ticks;
+    std::atomic<std::uint64_t> _last_active_tick;
+    detail::timer_wheel_entry *_entry = nullptr;
+  };
+
+private:
+  std::shared_ptr<detail::timer_wheel_state> _state;
+};
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_TIMER_WHEEL_HPP
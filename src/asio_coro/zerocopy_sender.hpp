@@ -0,0 +1,414 @@
+#ifndef ASIO_CORO_EXTENSIONS_ZEROCOPY_SENDER_HPP
+#define ASIO_CORO_EXTENSIONS_ZEROCOPY_SENDER_HPP
+
+#include "async_write.hpp"
+#include "buffer_pool.hpp"
+#include "detail/coroutine.hpp"
+#include "detail/coroutine_holder.hpp"
+#include "detail/executor.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/error.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/container/small_vector.hpp>
+#include <boost/scope_exit.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <utility>
+
+namespace asio_coro {
+namespace detail {
+/// Checks whether the sequence number a precedes the sequence number b, taking the wraparound into account.
+constexpr bool sequence_before(std::uint32_t a, std::uint32_t b) noexcept {
+  return static_cast<std::int32_t>(a - b) < 0;
+}
+
+/// The zerocopy send notifications of a socket. Every send made with MSG_ZEROCOPY gets the next sequence number, and
+/// the kernel reports ranges of sequence numbers whose pages it has released via the socket error queue.
+///
+/// The state is shared with the wait for the error queue, so it outlives the zerocopy_sender if the wait is still in
+/// progress when the sender is destroyed.
+struct zerocopy_state {
+  /// A send waiting for the kernel to release its pages: either a suspended coroutine or a buffer kept alive.
+  struct waiter {
+    std::uint32_t end;
+    coroutine_handle<> continuation;
+    executor_type executor;
+    boost::system::error_code *error = nullptr;
+    pooled_buffer buffer;
+  };
+
+  std::uint32_t next_sequence = 0;
+  std::uint32_t released = 0;
+  boost::container::small_vector<std::pair<std::uint32_t, std::uint32_t>, 4> released_out_of_order;
+  std::deque<waiter> waiters;
+  bool waiting = false;
+  std::uint64_t zerocopy_sends = 0;
+  std::uint64_t copied_sends = 0;
+
+  /// Checks whether all the sends up to the specified sequence number are released.
+  bool is_released(std::uint32_t end) const noexcept { return !sequence_before(released, end); }
+
+  /// Marks the specified inclusive range of sequence numbers released.
+  void release(std::uint32_t first, std::uint32_t last, bool copied) noexcept {
+    if (copied) {
+      copied_sends += last - first + 1;
+    }
+
+    if (first != released) {
+      released_out_of_order.emplace_back(first, last);
+      return;
+    }
+
+    released = last + 1;
+    for (auto it = released_out_of_order.begin(); it != released_out_of_order.end();) {
+      if (it->first == released) {
+        released = it->second + 1;
+        released_out_of_order.erase(it);
+        it = released_out_of_order.begin();
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  /// Reads all the notifications queued on the socket error queue without blocking.
+  void read_notifications(int fd) noexcept {
+    while (true) {
+      alignas(cmsghdr) char control[CMSG_SPACE(sizeof(sock_extended_err)) + 64];
+      msghdr message{};
+      message.msg_control = control;
+      message.msg_controllen = sizeof(control);
+      if (::recvmsg(fd, &message, MSG_ERRQUEUE | MSG_DONTWAIT) == -1) {
+        if (errno == EINTR) {
+          continue;
+        }
+
+        return;
+      }
+
+      for (auto *header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+        if (!(header->cmsg_level == SOL_IP && header->cmsg_type == IP_RECVERR) &&
+            !(header->cmsg_level == SOL_IPV6 && header->cmsg_type == IPV6_RECVERR)) {
+          continue;
+        }
+
+        const auto *const error = reinterpret_cast<const sock_extended_err *>(CMSG_DATA(header));
+        if (error->ee_errno == 0 && error->ee_origin == SO_EE_ORIGIN_ZEROCOPY) {
+          release(error->ee_info, error->ee_data, (error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0);
+        }
+      }
+    }
+  }
+
+  /// Completes the waiters whose sends are released, or all the waiters with the specified error.
+  void complete_waiters(const boost::system::error_code &error = {}) {
+    while (!waiters.empty() && (error || is_released(waiters.front().end))) {
+      auto waiter = std::move(waiters.front());
+      waiters.pop_front();
+      if (waiter.continuation) {
+        *waiter.error = error;
+        resume_on(waiter.executor, waiter.continuation);
+      }
+    }
+  }
+
+  /// Waits for the error queue of the socket to become non-empty while there are waiters. The callers read the error
+  /// queue before starting the wait, and the notifications queued since then wake the wait up, as the reactor re-arms
+  /// the socket upon starting the wait, which reports its current readiness. The error queue isn't read here, so the
+  /// coroutine that has just queued its waiter isn't resumed on the stack of its await_suspend.
+  template <class Socket> static void wait(const std::shared_ptr<zerocopy_state> &state, Socket &socket) {
+    if (state->waiting || state->waiters.empty()) {
+      return;
+    }
+
+    state->waiting = true;
+    socket.async_wait(Socket::wait_error, [state, &socket](const boost::system::error_code &error) {
+      state->waiting = false;
+      if (error) {
+        state->complete_waiters(error);
+        return;
+      }
+
+      state->read_notifications(socket.native_handle());
+      state->complete_waiters();
+      wait(state, socket);
+    });
+  }
+};
+} // namespace detail
+
+/// A sender of large payloads over a TCP socket, which sends them with MSG_ZEROCOPY, so the kernel transmits the data
+/// right from the payload buffer instead of copying it into the socket buffer.
+///
+/// The kernel keeps referencing the payload pages after a zerocopy send returns, until it reports that it has released
+/// them via the socket error queue, so the payload must not be modified or freed until then. async_send of a buffer
+/// resumes the awaiting coroutine once the pages are released, while async_send of a pooled_buffer resumes it as soon
+/// as the data is sent and keeps the buffer alive until the pages are released.
+///
+/// Zerocopy sends pay off for large payloads only, since the page pinning and the notifications cost more than copying
+/// a few kilobytes, so payloads smaller than the threshold are sent with a regular copying write. The kernel falls back
+/// to copying on its own if the socket's device can't transmit from user pages, e.g. on the loopback interface, which
+/// copied_sends reports. If the kernel doesn't support MSG_ZEROCOPY at all, all the payloads are copied.
+///
+/// All the operations must be performed within the same strand, and the sender must outlive them, so await
+/// async_flush prior to its destruction.
+template <class Socket> class zerocopy_sender {
+public:
+  /// The default size of a payload, payloads below which are copied.
+  static constexpr std::size_t default_threshold = 16 * 1024;
+
+  /// Constructor. Creates a sender that sends payloads over the specified socket.
+  ///
+  /// \param socket     A connected TCP socket.
+  /// \param threshold  The size of a payload, payloads below which are copied.
+  explicit zerocopy_sender(Socket &socket, std::size_t threshold = default_threshold)
+      : _socket(socket), _threshold(threshold), _state(std::make_shared<detail::zerocopy_state>()) {}
+
+  zerocopy_sender(const zerocopy_sender &) = delete;
+
+  zerocopy_sender &operator=(const zerocopy_sender &) = delete;
+
+  /// Returns the socket.
+  Socket &next_layer() noexcept { return _socket; }
+
+  /// Returns the size of a payload, payloads below which are copied.
+  std::size_t threshold() const noexcept { return _threshold; }
+
+  /// Returns the amount of sends made with MSG_ZEROCOPY.
+  std::uint64_t zerocopy_sends() const noexcept { return _state->zerocopy_sends; }
+
+  /// Returns the amount of sends made with MSG_ZEROCOPY, for which the kernel has copied the data anyway.
+  std::uint64_t copied_sends() const noexcept { return _state->copied_sends; }
+
+  /// Returns an awaitable that sends the whole payload, and resumes the awaiting coroutine once the kernel has
+  /// released the payload pages, so the payload may be reused right after the awaitable completes.
+  ///
+  /// The awaitable returns a value of type async_write_result.
+  ///
+  /// \param payload  The payload to send.
+  auto async_send(boost::asio::const_buffer payload) { return send(payload, {}); }
+
+  /// Returns an awaitable that sends the whole payload, and resumes the awaiting coroutine as soon as the payload is
+  /// sent. The sender keeps a handle to the payload until the kernel has released its pages.
+  ///
+  /// The awaitable returns a value of type async_write_result.
+  ///
+  /// \param payload  The payload to send.
+  auto async_send(pooled_buffer payload) {
+    const boost::asio::const_buffer buffer(payload.data(), payload.size());
+    return send(buffer, std::move(payload));
+  }
+
+  /// Returns an awaitable that suspends the awaiting coroutine until the kernel has released the pages of all the
+  /// payloads sent so far.
+  ///
+  /// The awaitable returns an instance of boost::system::error_code, which is set if the socket has failed before the
+  /// pages have been released.
+  auto async_flush() {
+    class awaitable {
+    public:
+      explicit awaitable(zerocopy_sender &sender) : _sender(sender) {}
+
+      /// Sets the executor the awaiting coroutine is resumed on.
+      void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+      /// Reads the notifications queued so far, so the awaiting coroutine isn't suspended if they release all the
+      /// payloads.
+      bool await_ready() {
+        auto &state = *_sender._state;
+        state.read_notifications(_sender._socket.native_handle());
+        state.complete_waiters();
+        return state.is_released(state.next_sequence);
+      }
+
+      boost::system::error_code await_resume() const noexcept { return _error; }
+
+      void await_suspend(detail::coroutine_handle<> continuation) {
+        auto &state = _sender._state;
+        state->waiters.push_back({state->next_sequence, continuation, std::move(_executor), &_error, {}});
+        detail::zerocopy_state::wait(state, _sender._socket);
+      }
+
+    private:
+      zerocopy_sender &_sender;
+      boost::system::error_code _error;
+      detail::executor_type _executor;
+    };
+
+    return awaitable(*this);
+  }
+
+private:
+  Socket &_socket;
+  std::size_t _threshold;
+  std::shared_ptr<detail::zerocopy_state> _state;
+  bool _zerocopy_checked = false;
+  bool _zerocopy_supported = false;
+
+  /// Enables zerocopy sends on the socket upon the first large payload. Returns whether they're supported.
+  bool enable_zerocopy() noexcept {
+    if (!_zerocopy_checked) {
+      _zerocopy_checked = true;
+      const int enable = 1;
+      _zerocopy_supported =
+          ::setsockopt(_socket.native_handle(), SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) == 0;
+    }
+
+    return _zerocopy_supported;
+  }
+
+  auto send(boost::asio::const_buffer payload, pooled_buffer buffer) {
+    class awaitable {
+    public:
+      awaitable(zerocopy_sender &sender, boost::asio::const_buffer payload, pooled_buffer buffer)
+          : _sender(sender), _payload(payload), _buffer(std::move(buffer)) {}
+
+      /// Sets the executor the awaiting coroutine is resumed on.
+      void set_executor(detail::executor_type executor) noexcept { _executor = std::move(executor); }
+
+      /// Makes the first attempt to send the payload, so the awaiting coroutine isn't suspended, and isn't resumed on
+      /// the stack of await_suspend, if the payload fits into the socket buffer and doesn't have to be waited for.
+      bool await_ready() {
+        _copy = _payload.size() < _sender._threshold || !_sender.enable_zerocopy();
+        return !_copy && send_some() && sent();
+      }
+
+      async_write_result await_resume() const noexcept { return _result; }
+
+      void await_suspend(detail::coroutine_handle<> continuation) {
+        auto executor = detail::get_executor(_executor, _sender._socket);
+        if (_copy) {
+          copy(std::move(executor), detail::coroutine_holder<>(continuation));
+        } else if (_result.second != _payload.size()) {
+          wait(std::move(executor), detail::coroutine_holder<>(continuation));
+        } else {
+          wait_released(std::move(executor), continuation);
+        }
+      }
+
+    private:
+      zerocopy_sender &_sender;
+      boost::asio::const_buffer _payload;
+      pooled_buffer _buffer;
+      async_write_result _result;
+      detail::executor_type _executor;
+      bool _copy = false;
+
+      void copy(detail::executor_type executor, detail::coroutine_holder<> holder) {
+        BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+        auto handler = [this, holder = std::move(holder)](const boost::system::error_code &error,
+                                                          std::size_t size) mutable {
+          _result = std::make_pair(error, size);
+          holder.release().resume();
+        };
+        boost::asio::async_write(_sender._socket, _payload, boost::asio::bind_executor(executor, std::move(handler)));
+      }
+
+      /// Sends the rest of the payload until the socket buffer is full. Returns true if the whole payload is sent or
+      /// the send has failed, and false if the socket has to become writable first.
+      bool send_some() {
+        auto &state = *_sender._state;
+        auto flags = MSG_ZEROCOPY | MSG_DONTWAIT | MSG_NOSIGNAL;
+        while (_result.second != _payload.size()) {
+          msghdr message{};
+          iovec data{static_cast<char *>(const_cast<void *>(_payload.data())) + _result.second,
+                     _payload.size() - _result.second};
+          message.msg_iov = &data;
+          message.msg_iovlen = 1;
+
+          const auto sent = ::sendmsg(_sender._socket.native_handle(), &message, flags);
+          if (sent >= 0) {
+            if (flags & MSG_ZEROCOPY) {
+              ++state.next_sequence;
+              ++state.zerocopy_sends;
+            }
+
+            flags |= MSG_ZEROCOPY;
+            _result.second += static_cast<std::size_t>(sent);
+          } else if (errno == ENOBUFS && (flags & MSG_ZEROCOPY)) {
+            // The socket has exceeded its limit of pinned pages, so the next chunk is copied.
+            flags &= ~MSG_ZEROCOPY;
+          } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return false;
+          } else if (errno != EINTR) {
+            _result.first = boost::system::error_code(errno, boost::system::system_category());
+            break;
+          }
+        }
+
+        return true;
+      }
+
+      /// Checks whether the awaiting coroutine may be resumed once the payload is sent: the send has failed, the kernel
+      /// has already released the payload pages, or the sender keeps the pooled buffer until it does.
+      bool sent() {
+        if (_result.first) {
+          return true;
+        }
+
+        auto &state = *_sender._state;
+        const auto end = state.next_sequence;
+        state.read_notifications(_sender._socket.native_handle());
+        state.complete_waiters();
+        if (state.is_released(end)) {
+          return true;
+        }
+
+        if (_buffer.valid()) {
+          state.waiters.push_back({end, {}, {}, nullptr, std::move(_buffer)});
+          detail::zerocopy_state::wait(_sender._state, _sender._socket);
+          return true;
+        }
+
+        return false;
+      }
+
+      /// Waits for the socket to become writable, and sends the rest of the payload.
+      void wait(detail::executor_type executor, detail::coroutine_holder<> holder) {
+        BOOST_SCOPE_EXIT_ALL(&) { holder.release(); };
+
+        auto handler = [this, executor, holder = std::move(holder)](const boost::system::error_code &error) mutable {
+          if (error) {
+            _result.first = error;
+            holder.release().resume();
+            return;
+          }
+
+          if (!send_some()) {
+            wait(std::move(executor), std::move(holder));
+          } else if (sent()) {
+            holder.release().resume();
+          } else {
+            wait_released(std::move(executor), holder.release());
+          }
+        };
+        _sender._socket.async_wait(Socket::wait_write, boost::asio::bind_executor(executor, std::move(handler)));
+      }
+
+      /// Suspends the awaiting coroutine until the kernel has released the payload pages. The error queue has just been
+      /// read by sent().
+      void wait_released(detail::executor_type executor, detail::coroutine_handle<> continuation) {
+        auto &state = _sender._state;
+        state->waiters.push_back({state->next_sequence, continuation, std::move(executor), &_result.first, {}});
+        detail::zerocopy_state::wait(state, _sender._socket);
+      }
+    };
+
+    return awaitable(*this, payload, std::move(buffer));
+  }
+};
+} // namespace asio_coro
+
+#endif // ASIO_CORO_EXTENSIONS_ZEROCOPY_SENDER_HPP
@@ -0,0 +1,15 @@
+#ifndef ASIO_CORO_EXTENSIONS_TESTS_SOCKET_PAIR_HPP
+#define ASIO_CORO_EXTENSIONS_TESTS_SOCKET_PAIR_HPP
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+/// Connects a pair of loopback TCP sockets.
+inline void connect_sockets(boost::asio::io_context &context, boost::asio::ip::tcp::socket &server,
+                            boost::asio::ip::tcp::socket &client) {
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  client.connect(acceptor.local_endpoint());
+  acceptor.accept(server);
+}
+
+#endif // ASIO_CORO_EXTENSIONS_TESTS_SOCKET_PAIR_HPP
@@ -0,0 +1,180 @@
+#include "asio_coro/async_datagram.hpp"
+#include "asio_coro/buffer_pool.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/udp.hpp>
+
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+/// Opens a UDP socket bound to an ephemeral loopback port.
+boost::asio::ip::udp::socket open_socket(boost::asio::io_context &context) {
+  return boost::asio::ip::udp::socket(context, {boost::asio::ip::address_v4::loopback(), 0});
+}
+
+/// Returns a pooled datagram with the specified payload sent to the specified endpoint.
+asio_coro::datagram make_datagram(asio_coro::buffer_pool &pool, std::string_view payload,
+                                  const boost::asio::ip::udp::endpoint &endpoint, std::uint16_t segment_size = 0) {
+  auto buffer = pool.acquire();
+  std::copy(payload.begin(), payload.end(), buffer.data());
+  buffer.resize(payload.size());
+
+  return asio_coro::datagram{std::move(buffer), endpoint, segment_size};
+}
+} // namespace
+
+TEST_CASE("async_send_to/async_receive_from send and receive a datagram") {
+  boost::asio::io_context context;
+  auto sender = open_socket(context);
+  auto receiver = open_socket(context);
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    std::string data(64, '\0');
+    boost::asio::ip::udp::endpoint endpoint;
+    const auto [error, size] = co_await asio_coro::async_receive_from(receiver, boost::asio::buffer(data), endpoint);
+    REQUIRE(!error);
+    REQUIRE(data.substr(0, size) == "ping");
+    REQUIRE(endpoint == sender.local_endpoint());
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto [error, size] = co_await asio_coro::async_send_to(
+        sender, boost::asio::buffer(std::string_view("ping")), receiver.local_endpoint());
+    REQUIRE(!error);
+    REQUIRE(size == 4);
+  });
+
+  context.run();
+}
+
+TEST_CASE("async_send_batch/async_receive_batch move many datagrams per system call") {
+  boost::asio::io_context context;
+  auto sender = open_socket(context);
+  auto receiver = open_socket(context);
+  asio_coro::buffer_pool pool(2048);
+
+  std::vector<asio_coro::datagram> received;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    while (received.size() < 100) {
+      const auto [error, count] = co_await asio_coro::async_receive_batch(receiver, pool, received, 16);
+      REQUIRE(!error);
+      REQUIRE(count != 0);
+      REQUIRE(count <= 16);
+    }
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    std::vector<asio_coro::datagram> datagrams;
+    for (auto i = 0; i != 100; ++i) {
+      datagrams.push_back(make_datagram(pool, std::to_string(i), receiver.local_endpoint()));
+    }
+
+    const auto [error, count] = co_await asio_coro::async_send_batch(sender, datagrams);
+    REQUIRE(!error);
+    REQUIRE(count == 100);
+  });
+
+  context.run();
+
+  REQUIRE(received.size() == 100);
+  for (std::size_t i = 0; i != received.size(); ++i) {
+    REQUIRE(std::string_view(received[i].data.data(), received[i].data.size()) == std::to_string(i));
+    REQUIRE(received[i].endpoint == sender.local_endpoint());
+    REQUIRE(received[i].segment_size == 0);
+  }
+}
+
+TEST_CASE("async_send_batch segments payloads and async_receive_batch coalesces them") {
+  boost::asio::io_context context;
+  auto sender = open_socket(context);
+  auto receiver = open_socket(context);
+  asio_coro::buffer_pool pool(65536);
+
+  if (asio_coro::enable_udp_gro(receiver)) {
+    WARN("UDP_GRO is not supported");
+    return;
+  }
+
+  const std::string payload(3000, 'g');
+  boost::system::error_code send_error;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const std::vector<asio_coro::datagram> datagrams{make_datagram(pool, payload, receiver.local_endpoint(), 1000)};
+    std::size_t count;
+    std::tie(send_error, count) = co_await asio_coro::async_send_batch(sender, datagrams);
+  });
+
+  context.run();
+  if (send_error) {
+    WARN("UDP_SEGMENT is not supported: " << send_error.message());
+    return;
+  }
+
+  // The segments are delivered either as they are or coalesced back into one datagram.
+  context.restart();
+  std::size_t received_size = 0;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    std::vector<asio_coro::datagram> received;
+    while (received_size != payload.size()) {
+      received.clear();
+      const auto [error, count] = co_await asio_coro::async_receive_batch(receiver, pool, received);
+      REQUIRE(!error);
+      for (const auto &datagram : received) {
+        REQUIRE((datagram.segment_size == 1000 || datagram.data.size() == 1000));
+        received_size += datagram.data.size();
+      }
+    }
+  });
+
+  context.run();
+
+  REQUIRE(received_size == payload.size());
+}
+
+TEST_CASE("async_receive_batch doesn't miss datagrams on an io_context run by several threads") {
+  constexpr std::size_t datagrams_count = 500;
+  boost::asio::io_context context;
+  auto receiver = open_socket(context);
+  asio_coro::buffer_pool pool(2048);
+
+  // Every datagram is sent once the previous one is received, so it arrives while the batch starts waiting for it,
+  // and the readiness events are handled by any of the threads running the io_context.
+  std::atomic<std::size_t> received_count{0};
+  std::atomic<bool> failed{false};
+  std::vector<asio_coro::datagram> received;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    while (received_count != datagrams_count) {
+      received.clear();
+      const auto [error, count] = co_await asio_coro::async_receive_batch(receiver, pool, received);
+      failed = failed || error;
+      received_count += count;
+    }
+  });
+
+  std::vector<std::thread> threads;
+  for (auto i = 0; i != 4; ++i) {
+    threads.emplace_back([&]() { context.run(); });
+  }
+
+  boost::asio::io_context sender_context;
+  auto sender = open_socket(sender_context);
+  for (std::size_t i = 0; i != datagrams_count; ++i) {
+    sender.send_to(boost::asio::buffer(std::string_view("ping")), receiver.local_endpoint());
+    while (received_count == i && !failed) {
+      std::this_thread::yield();
+    }
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(!failed);
+  REQUIRE(received_count == datagrams_count);
+}
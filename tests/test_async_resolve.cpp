@@ -0,0 +1,260 @@
+#include "asio_coro/async_resolve.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+/// A resolver that resolves every name to the loopback address, or fails if the name server is set down, and completes
+/// the resolutions only when the test lets it. If the name server is set broken, starting a resolution throws.
+class stub_resolver {
+public:
+  using results_type = boost::asio::ip::tcp::resolver::results_type;
+  using executor_type = boost::asio::any_io_executor;
+
+  /// The state shared by all the resolvers of a test.
+  struct name_server {
+    bool down = false;
+    bool broken = false;
+    std::uint16_t port = 1;
+    std::vector<std::function<void()>> pending;
+
+    /// Completes all the resolutions in progress.
+    void answer() {
+      auto pending_resolutions = std::move(pending);
+      for (auto &resolution : pending_resolutions) {
+        resolution();
+      }
+    }
+  };
+
+  static inline name_server *server = nullptr;
+
+  explicit stub_resolver(const executor_type &executor) : _executor(executor) {}
+
+  executor_type get_executor() const noexcept { return _executor; }
+
+  template <class Handler> void async_resolve(const std::string &host, const std::string &service, Handler handler) {
+    if (server->broken) {
+      throw std::runtime_error("the name server is broken");
+    }
+
+    server->pending.push_back([this, host, service, handler = std::move(handler)]() mutable {
+      if (server->down) {
+        boost::asio::post(_executor, [handler = std::move(handler)]() mutable {
+          handler(boost::asio::error::host_not_found, results_type());
+        });
+        return;
+      }
+
+      const boost::asio::ip::tcp::endpoint endpoint(boost::asio::ip::address_v4::loopback(), server->port);
+      boost::asio::post(_executor, [handler = std::move(handler), endpoint, host, service]() mutable {
+        handler(boost::system::error_code(), results_type::create(endpoint, host, service));
+      });
+    });
+  }
+
+private:
+  executor_type _executor;
+};
+
+std::uint16_t port_of(const asio_coro::async_resolve_result<stub_resolver> &result) {
+  return result.second.begin()->endpoint().port();
+}
+} // namespace
+
+TEST_CASE("async_resolve resolves a host name with a resolver") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::resolver resolver(context);
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto [error, results] = co_await asio_coro::async_resolve(resolver, "localhost", "80");
+    REQUIRE(!error);
+    REQUIRE(!results.empty());
+    REQUIRE(results.begin()->endpoint().port() == 80);
+    REQUIRE(results.begin()->endpoint().address().is_loopback());
+  });
+
+  context.run();
+}
+
+TEST_CASE("resolver_cache coalesces concurrent lookups of the same name") {
+  boost::asio::io_context context;
+  stub_resolver::name_server server;
+  stub_resolver::server = &server;
+  asio_coro::resolver_cache<stub_resolver> cache(context.get_executor());
+
+  std::size_t resolved = 0;
+  for (auto i = 0; i != 3; ++i) {
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      const auto result = co_await asio_coro::async_resolve(cache, "example.com", "443");
+      REQUIRE(!result.first);
+      REQUIRE(port_of(result) == 1);
+      ++resolved;
+    });
+  }
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto result = co_await asio_coro::async_resolve(cache, "example.org", "443");
+    REQUIRE(!result.first);
+    ++resolved;
+  });
+
+  context.poll();
+  REQUIRE(server.pending.size() == 2);
+  REQUIRE(resolved == 0);
+
+  server.answer();
+  context.restart();
+  context.run();
+
+  REQUIRE(resolved == 4);
+  REQUIRE(cache.resolutions() == 2);
+  REQUIRE(cache.size() == 2);
+}
+
+TEST_CASE("resolver_cache serves cached and stale resolutions while refreshing them") {
+  boost::asio::io_context context;
+  stub_resolver::name_server server;
+  stub_resolver::server = &server;
+  asio_coro::resolver_cache<stub_resolver> cache(context.get_executor(), std::chrono::milliseconds(50),
+                                                 std::chrono::minutes(1), std::chrono::milliseconds(50));
+
+  const auto resolve = [&] {
+    asio_coro::async_resolve_result<stub_resolver> result;
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      result = co_await asio_coro::async_resolve(cache, "example.com", "443");
+    });
+
+    context.restart();
+    context.poll();
+    server.answer();
+    context.restart();
+    context.run();
+
+    return result;
+  };
+
+  REQUIRE(port_of(resolve()) == 1);
+  REQUIRE(cache.resolutions() == 1);
+
+  // The resolution is fresh, so it's served without resolving the name again.
+  server.port = 2;
+  REQUIRE(port_of(resolve()) == 1);
+  REQUIRE(cache.resolutions() == 1);
+
+  // The expired resolution is served while a refresh is started, which replaces it.
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  asio_coro::async_resolve_result<stub_resolver> stale_result;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    stale_result = co_await asio_coro::async_resolve(cache, "example.com", "443");
+  });
+
+  context.restart();
+  context.poll();
+  REQUIRE(port_of(stale_result) == 1);
+  REQUIRE(server.pending.size() == 1);
+
+  server.answer();
+  context.restart();
+  context.run();
+  REQUIRE(cache.resolutions() == 2);
+  REQUIRE(port_of(resolve()) == 2);
+
+  // A failed refresh keeps serving the previous resolution, and isn't retried for the negative time-to-live.
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  server.down = true;
+  server.port = 3;
+  REQUIRE(port_of(resolve()) == 2);
+  REQUIRE(cache.resolutions() == 3);
+  REQUIRE(port_of(resolve()) == 2);
+  REQUIRE(cache.resolutions() == 3);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  server.down = false;
+  REQUIRE(port_of(resolve()) == 2);
+  REQUIRE(cache.resolutions() == 4);
+  REQUIRE(port_of(resolve()) == 3);
+}
+
+TEST_CASE("resolver_cache caches failures for the negative time-to-live") {
+  boost::asio::io_context context;
+  stub_resolver::name_server server;
+  stub_resolver::server = &server;
+  server.down = true;
+  asio_coro::resolver_cache<stub_resolver> cache(context.get_executor(), std::chrono::seconds(30),
+                                                 std::chrono::minutes(1), std::chrono::milliseconds(50));
+
+  const auto resolve = [&] {
+    asio_coro::async_resolve_result<stub_resolver> result;
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      result = co_await asio_coro::async_resolve(cache, "example.com", "443");
+    });
+
+    context.restart();
+    context.poll();
+    server.answer();
+    context.restart();
+    context.run();
+
+    return result;
+  };
+
+  REQUIRE(resolve().first == boost::asio::error::host_not_found);
+  REQUIRE(resolve().first == boost::asio::error::host_not_found);
+  REQUIRE(cache.resolutions() == 1);
+
+  // The failure isn't served as a stale resolution once it has expired.
+  std::this_thread::sleep_for(std::chrono::milliseconds(60));
+  server.down = false;
+  REQUIRE(!resolve().first);
+  REQUIRE(cache.resolutions() == 2);
+}
+
+TEST_CASE("resolver_cache doesn't leave a name resolving if starting the resolution throws") {
+  boost::asio::io_context context;
+  stub_resolver::name_server server;
+  stub_resolver::server = &server;
+  server.broken = true;
+  asio_coro::resolver_cache<stub_resolver> cache(context.get_executor());
+
+  bool thrown = false;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    try {
+      co_await asio_coro::async_resolve(cache, "example.com", "443");
+    } catch (const std::runtime_error &) {
+      thrown = true;
+    }
+  });
+
+  context.run();
+  REQUIRE(thrown);
+
+  // The next lookup starts a new resolution instead of waiting for the one that has never started.
+  server.broken = false;
+  asio_coro::async_resolve_result<stub_resolver> result;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    result = co_await asio_coro::async_resolve(cache, "example.com", "443");
+  });
+
+  context.restart();
+  context.poll();
+  REQUIRE(server.pending.size() == 1);
+  server.answer();
+  context.restart();
+  context.run();
+
+  REQUIRE(!result.first);
+  REQUIRE(port_of(result) == 1);
+}
@@ -0,0 +1,187 @@
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_sendfile.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+#include "socket_pair.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+/// Returns a descriptor of an unlinked temporary file with the specified content.
+int make_file(const std::string &content) {
+  char path[] = "/tmp/asio_coro_sendfile_XXXXXX";
+  const auto fd = ::mkstemp(path);
+  REQUIRE(fd != -1);
+  ::unlink(path);
+  REQUIRE(::write(fd, content.data(), content.size()) == static_cast<ssize_t>(content.size()));
+
+  return fd;
+}
+
+/// Returns a string of the specified size that doesn't repeat within small distances.
+std::string make_content(std::size_t size) {
+  std::string result(size, '\0');
+  for (std::size_t i = 0; i != size; ++i) {
+    result[i] = static_cast<char>('a' + i % 23 + i / 4096 % 3);
+  }
+
+  return result;
+}
+} // namespace
+
+TEST_CASE("async_sendfile sends the range of the file waiting for the socket to become writable") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  // The file is larger than the socket buffers, so the transfer has to wait for the peer to read the data.
+  const auto content = make_content(8 << 20);
+  const auto fd = make_file(content);
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto [error, size] = co_await asio_coro::async_sendfile(server, fd, 100, content.size() - 200);
+    REQUIRE(!error);
+    REQUIRE(size == content.size() - 200);
+    server.shutdown(boost::asio::ip::tcp::socket::shutdown_send);
+  });
+
+  std::string received(content.size(), '\0');
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto [error, size] =
+        co_await asio_coro::async_read(client, boost::asio::buffer(received), boost::asio::transfer_all());
+    REQUIRE(error == boost::asio::error::eof);
+    received.resize(size);
+  });
+
+  context.run();
+  ::close(fd);
+
+  REQUIRE(received == content.substr(100, content.size() - 200));
+}
+
+TEST_CASE("async_sendfile doesn't miss the socket becoming writable on an io_context run by several threads") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  // The peer reads on its own thread, so the socket keeps becoming writable while the transfer starts waiting for it,
+  // and the readiness events are handled by any of the threads running the io_context.
+  const auto content = make_content(32 << 20);
+  const auto fd = make_file(content);
+
+  boost::system::error_code send_error;
+  std::size_t sent = 0;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    std::tie(send_error, sent) = co_await asio_coro::async_sendfile(server, fd, 0, content.size());
+    server.shutdown(boost::asio::ip::tcp::socket::shutdown_send);
+  });
+
+  std::vector<std::thread> threads;
+  for (auto i = 0; i != 4; ++i) {
+    threads.emplace_back([&]() { context.run(); });
+  }
+
+  std::string received(content.size() + 1, '\0');
+  boost::system::error_code read_error;
+  received.resize(boost::asio::read(client, boost::asio::buffer(received), read_error));
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  ::close(fd);
+
+  REQUIRE(!send_error);
+  REQUIRE(sent == content.size());
+  REQUIRE(read_error == boost::asio::error::eof);
+  REQUIRE(received == content);
+}
+
+TEST_CASE("async_sendfile reports the end of file if the range exceeds the file") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  const auto fd = make_file("hello");
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto [error, size] = co_await asio_coro::async_sendfile(server, fd, 2, 100);
+    REQUIRE(error == boost::asio::error::eof);
+    REQUIRE(size == 3);
+  });
+
+  context.run();
+  ::close(fd);
+
+  std::string received(3, '\0');
+  boost::asio::read(client, boost::asio::buffer(received));
+  REQUIRE(received == "llo");
+}
+
+TEST_CASE("async_splice_some and async_splice proxy data between sockets through a pipe") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket source(context);
+  boost::asio::ip::tcp::socket source_peer(context);
+  connect_sockets(context, source, source_peer);
+  boost::asio::ip::tcp::socket destination(context);
+  boost::asio::ip::tcp::socket destination_peer(context);
+  connect_sockets(context, destination, destination_peer);
+
+  int pipe_fds[2];
+  REQUIRE(::pipe(pipe_fds) == 0);
+  boost::asio::posix::stream_descriptor pipe_read(context, pipe_fds[0]);
+  boost::asio::posix::stream_descriptor pipe_write(context, pipe_fds[1]);
+
+  const auto content = make_content(1 << 20);
+  std::size_t proxied = 0;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    while (true) {
+      auto [error, size] = co_await asio_coro::async_splice_some(source, pipe_write, 65536);
+      if (error) {
+        REQUIRE(error == boost::asio::error::eof);
+        break;
+      }
+
+      REQUIRE(size != 0);
+      std::tie(error, size) = co_await asio_coro::async_splice(pipe_read, destination, size);
+      REQUIRE(!error);
+      proxied += size;
+    }
+
+    destination.shutdown(boost::asio::ip::tcp::socket::shutdown_send);
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto [error, size] =
+        co_await asio_coro::async_write(source_peer, boost::asio::buffer(content), boost::asio::transfer_all());
+    REQUIRE(!error);
+    source_peer.shutdown(boost::asio::ip::tcp::socket::shutdown_send);
+  });
+
+  std::string received(content.size() + 1, '\0');
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto [error, size] =
+        co_await asio_coro::async_read(destination_peer, boost::asio::buffer(received), boost::asio::transfer_all());
+    REQUIRE(error == boost::asio::error::eof);
+    received.resize(size);
+  });
+
+  context.run();
+
+  REQUIRE(proxied == content.size());
+  REQUIRE(received == content);
+}
@@ -5,6 +5,15 @@
 #include <boost/asio.hpp>
 #include <boost/asio/ip/tcp.hpp>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
 TEST_CASE("async_accept/async_connect return an awaitable that resumes a coroutine upon the connection is "
           "accepted/established") {
   auto accepted = false;
@@ -114,3 +123,367 @@ TEST_CASE("async read/write can use completion conditions") {
 
   REQUIRE(received_data == data_to_send);
 }
+
+TEST_CASE("async_wait_readable/async_wait_writable return an awaitable that resumes a coroutine upon the socket is "
+          "ready to read/write") {
+  std::string data_to_send = "data data data";
+  std::size_t available_size = 0;
+  auto writable = false;
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  const auto endpoint = acceptor.local_endpoint();
+  asio_coro::spawn_coroutine(context, [&]() mutable -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket accepted_socket(context);
+    const auto accept_error = co_await asio_coro::async_accept(acceptor, accepted_socket);
+    REQUIRE(!accept_error);
+
+    const auto wait_error = co_await asio_coro::async_wait_readable(accepted_socket);
+    REQUIRE(!wait_error);
+
+    available_size = accepted_socket.available();
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() mutable -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket socket(context);
+    const auto connect_error = co_await asio_coro::async_connect(socket, endpoint);
+    REQUIRE(!connect_error);
+
+    const auto wait_error = co_await asio_coro::async_wait_writable(socket);
+    REQUIRE(!wait_error);
+    writable = true;
+
+    const auto [write_error, size] = co_await asio_coro::async_write(socket, boost::asio::buffer(data_to_send));
+    REQUIRE(!write_error);
+  });
+
+  context.run();
+
+  REQUIRE(writable);
+  REQUIRE(available_size == data_to_send.size());
+}
+
+TEST_CASE("async_read_pooled returns an awaitable that reads data into a buffer taken from the pool") {
+  std::string data_to_send = "data data data";
+  std::string received_data;
+  boost::system::error_code eof_error;
+  auto eof_buffer_size = std::size_t(1);
+  std::set<char *> buffer_data;
+
+  asio_coro::buffer_pool pool(1024);
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  const auto endpoint = acceptor.local_endpoint();
+  asio_coro::spawn_coroutine(context, [&]() mutable -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket accepted_socket(context);
+    const auto accept_error = co_await asio_coro::async_accept(acceptor, accepted_socket);
+    REQUIRE(!accept_error);
+
+    while (received_data.size() != 2 * data_to_send.size()) {
+      auto [read_error, buffer, size] = co_await asio_coro::async_read_pooled(accepted_socket, pool);
+      REQUIRE(!read_error);
+      REQUIRE(buffer.valid());
+      REQUIRE(buffer.capacity() == 1024);
+      REQUIRE(buffer.size() == size);
+
+      buffer_data.insert(buffer.data());
+
+      received_data.append(buffer.data(), size);
+    }
+
+    auto [read_error, buffer, size] = co_await asio_coro::async_read_pooled(accepted_socket, pool);
+    eof_error = read_error;
+    eof_buffer_size = size;
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() mutable -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket socket(context);
+    const auto connect_error = co_await asio_coro::async_connect(socket, endpoint);
+    REQUIRE(!connect_error);
+
+    for (auto i = 0; i != 2; ++i) {
+      const auto [write_error, size] = co_await asio_coro::async_write(socket, boost::asio::buffer(data_to_send));
+      REQUIRE(!write_error);
+    }
+
+    socket.shutdown(boost::asio::ip::tcp::socket::shutdown_send);
+    co_await asio_coro::async_wait_readable(socket);
+  });
+
+  context.run();
+
+  REQUIRE(received_data == data_to_send + data_to_send);
+  REQUIRE(eof_error == boost::asio::error::eof);
+  REQUIRE(eof_buffer_size == 0);
+
+  // Buffers are returned to the pool once dropped, so sequential reads reuse the same buffer.
+  REQUIRE(buffer_data.size() == 1);
+}
+
+TEST_CASE("async_read/async_write accept buffer sequences, so scattered data is read/written at once") {
+  std::string header = "header";
+  std::string body = "body body body";
+  std::string trailer = "trailer";
+
+  std::array<char, 6> received_header{};
+  std::string received_body(body.size(), '\0');
+  std::string received_trailer(trailer.size(), '\0');
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  const auto endpoint = acceptor.local_endpoint();
+  asio_coro::spawn_coroutine(context, [&]() mutable -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket accepted_socket(context);
+    const auto accept_error = co_await asio_coro::async_accept(acceptor, accepted_socket);
+    REQUIRE(!accept_error);
+
+    const auto buffers = asio_coro::make_buffers(received_header, received_body);
+    static_assert(std::is_same_v<std::decay_t<decltype(buffers)>::value_type, boost::asio::mutable_buffer>);
+
+    const auto [read_error, read_size] = co_await asio_coro::async_read(
+        accepted_socket, buffers, boost::asio::transfer_exactly(header.size() + body.size()));
+    REQUIRE(!read_error);
+    REQUIRE(read_size == header.size() + body.size());
+
+    asio_coro::mutable_buffer_vector<2> trailer_buffers;
+    trailer_buffers.push_back(boost::asio::buffer(received_trailer));
+    const auto [trailer_error, trailer_size] =
+        co_await asio_coro::async_read(accepted_socket, trailer_buffers, boost::asio::transfer_all());
+    REQUIRE(!trailer_error);
+    REQUIRE(trailer_size == trailer.size());
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() mutable -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket socket(context);
+    const auto connect_error = co_await asio_coro::async_connect(socket, endpoint);
+    REQUIRE(!connect_error);
+
+    const auto [write_error, write_size] = co_await asio_coro::async_write(
+        socket, asio_coro::make_buffers(header, boost::asio::const_buffer(body.data(), body.size())));
+    REQUIRE(!write_error);
+    REQUIRE(write_size == header.size() + body.size());
+
+    asio_coro::const_buffer_vector<1> trailer_buffers;
+    for (const auto &c : trailer) {
+      trailer_buffers.emplace_back(&c, 1);
+    }
+    const auto [trailer_error, trailer_size] =
+        co_await asio_coro::async_write(socket, trailer_buffers, boost::asio::transfer_all());
+    REQUIRE(!trailer_error);
+    REQUIRE(trailer_size == trailer.size());
+  });
+
+  context.run();
+
+  REQUIRE(std::string(received_header.data(), received_header.size()) == header);
+  REQUIRE(received_body == body);
+  REQUIRE(received_trailer == trailer);
+}
+
+TEST_CASE("async_accept_batch accepts all the pending connections with one wakeup") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  const auto endpoint = acceptor.local_endpoint();
+
+  std::vector<boost::asio::ip::tcp::socket> clients;
+  for (auto i = 0; i != 5; ++i) {
+    clients.emplace_back(context).connect(endpoint);
+  }
+
+  std::size_t accepted_count = 0;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    // The connections are already pending, so they're accepted without waiting, up to the requested amount.
+    auto [error, sockets] = co_await asio_coro::async_accept_batch(acceptor, 3);
+    REQUIRE(!error);
+    REQUIRE(sockets.size() == 3);
+    accepted_count += sockets.size();
+
+    std::tie(error, sockets) = co_await asio_coro::async_accept_batch(acceptor, 16);
+    REQUIRE(!error);
+    REQUIRE(sockets.size() == 2);
+    accepted_count += sockets.size();
+
+    // The backlog is empty now, so the next batch waits for a new connection.
+    std::tie(error, sockets) = co_await asio_coro::async_accept_batch(acceptor, 16);
+    REQUIRE(!error);
+    REQUIRE(sockets.size() == 1);
+    accepted_count += sockets.size();
+
+    const auto [write_error, size] =
+        co_await asio_coro::async_write(sockets.front(), boost::asio::buffer(std::string_view("hi")));
+    REQUIRE(!write_error);
+  });
+
+  std::array<char, 2> received{};
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    co_await asio_coro::post(context);
+    auto &client = clients.emplace_back(context);
+    const auto connect_error = co_await asio_coro::async_connect(client, endpoint);
+    REQUIRE(!connect_error);
+    const auto [error, size] =
+        co_await asio_coro::async_read(client, boost::asio::buffer(received), boost::asio::transfer_all());
+    REQUIRE(!error);
+  });
+
+  context.run();
+
+  REQUIRE(accepted_count == 6);
+  REQUIRE(std::string_view(received.data(), received.size()) == "hi");
+}
+
+TEST_CASE("async_accept_batch doesn't miss connections on an io_context run by several threads") {
+  constexpr std::size_t connections_count = 200;
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  const auto endpoint = acceptor.local_endpoint();
+
+  // The connections keep arriving while the batches start waiting for them, and the readiness events are handled by
+  // any of the threads running the io_context.
+  std::atomic<std::size_t> accepted_count{0};
+  std::atomic<bool> failed{false};
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    while (accepted_count != connections_count) {
+      const auto [error, sockets] = co_await asio_coro::async_accept_batch(acceptor, 16);
+      failed = failed || error;
+      accepted_count += sockets.size();
+    }
+  });
+
+  std::vector<std::thread> threads;
+  for (auto i = 0; i != 4; ++i) {
+    threads.emplace_back([&]() { context.run(); });
+  }
+
+  boost::asio::io_context clients_context;
+  std::vector<boost::asio::ip::tcp::socket> clients;
+  for (std::size_t i = 0; i != connections_count; ++i) {
+    clients.emplace_back(clients_context).connect(endpoint);
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(!failed);
+  REQUIRE(accepted_count == connections_count);
+}
+
+namespace {
+/// Returns a loopback endpoint nothing listens on, so connections to it are refused.
+boost::asio::ip::tcp::endpoint refusing_endpoint(boost::asio::io_context &context) {
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  return acceptor.local_endpoint();
+}
+} // namespace
+
+TEST_CASE("async_connect over a range of endpoints connects to the first endpoint that accepts the connection") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  const auto refusing = refusing_endpoint(context);
+  const std::vector endpoints{refusing, acceptor.local_endpoint()};
+  asio_coro::endpoint_failure_cache cache;
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket accepted(context);
+    const auto accept_error = co_await asio_coro::async_accept(acceptor, accepted);
+    REQUIRE(!accept_error);
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket socket(context);
+
+    // The refused attempt starts the next one without waiting for the attempt delay.
+    const auto started_at = std::chrono::steady_clock::now();
+    const auto [error, endpoint] =
+        co_await asio_coro::async_connect(socket, endpoints, &cache, std::chrono::seconds(10));
+    REQUIRE(!error);
+    REQUIRE(endpoint == acceptor.local_endpoint());
+    REQUIRE(socket.remote_endpoint() == acceptor.local_endpoint());
+    REQUIRE(std::chrono::steady_clock::now() - started_at < std::chrono::seconds(5));
+  });
+
+  context.run();
+
+  REQUIRE(cache.is_failing(refusing));
+  REQUIRE(!cache.is_failing(acceptor.local_endpoint()));
+}
+
+TEST_CASE("async_connect over a range of endpoints tries the endpoints failing recently last") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor first(context, {boost::asio::ip::address_v4::loopback(), 0});
+  boost::asio::ip::tcp::acceptor second(context, {boost::asio::ip::address_v4::loopback(), 0});
+  const std::vector endpoints{first.local_endpoint(), second.local_endpoint()};
+  asio_coro::endpoint_failure_cache cache;
+  cache.record_failure(first.local_endpoint());
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket socket(context);
+    const auto [error, endpoint] =
+        co_await asio_coro::async_connect(socket, endpoints, &cache, std::chrono::seconds(10));
+    REQUIRE(!error);
+    REQUIRE(endpoint == second.local_endpoint());
+  });
+
+  context.run();
+
+  REQUIRE(cache.size() == 1);
+  REQUIRE(cache.is_failing(first.local_endpoint()));
+}
+
+TEST_CASE("async_connect over a range of endpoints fails if all the attempts fail") {
+  boost::asio::io_context context;
+  const std::vector endpoints{refusing_endpoint(context), refusing_endpoint(context)};
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket socket(context);
+    auto [error, endpoint] = co_await asio_coro::async_connect(socket, endpoints);
+    REQUIRE(error == boost::asio::error::connection_refused);
+    REQUIRE(endpoint == boost::asio::ip::tcp::endpoint());
+    REQUIRE(!socket.is_open());
+
+    std::tie(error, endpoint) =
+        co_await asio_coro::async_connect(socket, std::vector<boost::asio::ip::tcp::endpoint>());
+    REQUIRE(error == boost::asio::error::not_found);
+  });
+
+  context.run();
+}
+
+TEST_CASE("async_connect over a range of endpoints connects to the results of a resolver") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  boost::asio::ip::tcp::resolver resolver(context);
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket accepted(context);
+    const auto accept_error = co_await asio_coro::async_accept(acceptor, accepted);
+    REQUIRE(!accept_error);
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto [resolve_error, results] =
+        co_await asio_coro::async_resolve(resolver, "127.0.0.1", std::to_string(acceptor.local_endpoint().port()));
+    REQUIRE(!resolve_error);
+
+    boost::asio::ip::tcp::socket socket(context);
+    const auto [error, endpoint] = co_await asio_coro::async_connect(socket, results);
+    REQUIRE(!error);
+    REQUIRE(endpoint == acceptor.local_endpoint());
+  });
+
+  context.run();
+}
+
+TEST_CASE("Endpoints are interleaved by the protocol family with the failing ones last") {
+  using boost::asio::ip::make_address;
+  using endpoint = boost::asio::ip::tcp::endpoint;
+  const std::vector endpoints{endpoint(make_address("::1"), 1), endpoint(make_address("::2"), 1),
+                              endpoint(make_address("::3"), 1), endpoint(make_address("10.0.0.1"), 1),
+                              endpoint(make_address("10.0.0.2"), 1)};
+  asio_coro::endpoint_failure_cache cache;
+  cache.record_failure(endpoints[1]);
+
+  const auto ordered = asio_coro::detail::order_endpoints(endpoints, &cache);
+  const std::vector expected{endpoints[0], endpoints[3], endpoints[2], endpoints[4], endpoints[1]};
+  REQUIRE(ordered == expected);
+}
@@ -0,0 +1,141 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_connect.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/buffer_pool.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+
+TEST_CASE("buffer_pool allocates aligned buffers in slabs") {
+  asio_coro::buffer_pool pool(100, 8);
+
+  std::vector<asio_coro::pooled_buffer> buffers;
+  for (auto i = 0; i != 9; ++i) {
+    buffers.push_back(pool.acquire());
+    REQUIRE(buffers.back().size() == 100);
+    REQUIRE(buffers.back().capacity() == 100);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(buffers.back().data()) % 64 == 0);
+  }
+
+  REQUIRE(pool.size() == 16);
+  REQUIRE(std::set<char *>({buffers[0].data(), buffers[1].data(), buffers[2].data()}).size() == 3);
+}
+
+TEST_CASE("pooled_buffer is returned to the pool once the last handle to it is released") {
+  asio_coro::buffer_pool pool(64, 4);
+
+  auto buffer = pool.acquire();
+  auto *const data = buffer.data();
+  std::memcpy(data, "data", 4);
+
+  auto copy = buffer;
+  REQUIRE(buffer.use_count() == 2);
+  REQUIRE(copy.data() == data);
+
+  buffer.reset();
+  REQUIRE(!buffer.valid());
+  REQUIRE(copy.use_count() == 1);
+  REQUIRE(std::memcmp(copy.data(), "data", 4) == 0);
+
+  // The buffer is still referenced by the copy, so the pool hands out another one.
+  auto other = pool.acquire();
+  REQUIRE(other.data() != data);
+
+  // The released buffer is the first one to be reused by the releasing thread.
+  copy = asio_coro::pooled_buffer();
+  auto reused = pool.acquire();
+  REQUIRE(reused.data() == data);
+}
+
+TEST_CASE("buffer_pool keeps buffers released by other threads reusable") {
+  asio_coro::buffer_pool pool(64, 4);
+
+  std::vector<asio_coro::pooled_buffer> buffers;
+  for (auto i = 0; i != 32; ++i) {
+    buffers.push_back(pool.acquire());
+  }
+  REQUIRE(pool.size() == 32);
+
+  // The worker thread releases the buffers to its free list, which is flushed to the pool upon the thread exit.
+  std::thread([&] { buffers.clear(); }).join();
+
+  for (auto i = 0; i != 32; ++i) {
+    buffers.push_back(pool.acquire());
+  }
+  REQUIRE(pool.size() == 32);
+}
+
+TEST_CASE("buffer_pool refills the thread free list from a partially drained shared list") {
+  asio_coro::buffer_pool pool(64, 8);
+
+  // Drain the shared list but a few buffers, so the next refill takes less buffers than it asks for.
+  std::vector<asio_coro::pooled_buffer> buffers;
+  std::thread([&] {
+    for (auto i = 0; i != 6; ++i) {
+      buffers.push_back(pool.acquire());
+    }
+  }).join();
+
+  for (auto i = 0; i != 16; ++i) {
+    buffers.push_back(pool.acquire());
+    REQUIRE(buffers.back().valid());
+  }
+  REQUIRE(std::set<char *>({buffers[0].data(), buffers[6].data(), buffers[21].data()}).size() == 3);
+}
+
+TEST_CASE("async_read/async_write accept pooled buffers, so a read buffer is written without copying") {
+  std::string data_to_send = "data data data";
+  std::string received_data;
+
+  asio_coro::buffer_pool pool(1024);
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  const auto endpoint = acceptor.local_endpoint();
+  asio_coro::spawn_coroutine(context, [&]() mutable -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket accepted_socket(context);
+    const auto accept_error = co_await asio_coro::async_accept(acceptor, accepted_socket);
+    REQUIRE(!accept_error);
+
+    auto buffer = pool.acquire();
+    buffer.resize(data_to_send.size());
+    const auto [read_error, read_size] =
+        co_await asio_coro::async_read(accepted_socket, buffer, boost::asio::transfer_exactly(buffer.size()));
+    REQUIRE(!read_error);
+    REQUIRE(read_size == data_to_send.size());
+
+    const auto [write_error, write_size] = co_await asio_coro::async_write(accepted_socket, buffer);
+    REQUIRE(!write_error);
+    REQUIRE(write_size == data_to_send.size());
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() mutable -> asio_coro::task<void> {
+    boost::asio::ip::tcp::socket socket(context);
+    const auto connect_error = co_await asio_coro::async_connect(socket, endpoint);
+    REQUIRE(!connect_error);
+
+    const auto [write_error, write_size] = co_await asio_coro::async_write(socket, boost::asio::buffer(data_to_send));
+    REQUIRE(!write_error);
+
+    auto buffer = pool.acquire();
+    buffer.resize(data_to_send.size());
+    const auto [read_error, read_size] =
+        co_await asio_coro::async_read(socket, buffer, boost::asio::transfer_exactly(buffer.size()));
+    REQUIRE(!read_error);
+
+    received_data.assign(buffer.data(), read_size);
+  });
+
+  context.run();
+
+  REQUIRE(received_data == data_to_send);
+}
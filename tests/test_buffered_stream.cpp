@@ -0,0 +1,144 @@
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/buffered_stream.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+#include "socket_pair.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST_CASE("find_delimiter finds the first occurrence of the delimiter") {
+  std::mt19937 random(42);
+  std::uniform_int_distribution<int> characters('a', 'c');
+
+  for (auto size = 0; size != 100; ++size) {
+    std::string data(size, '\0');
+    for (auto &character : data) {
+      character = static_cast<char>(characters(random));
+    }
+
+    for (const std::string_view delimiter : {"a", "ab", "abc", "cab", "abca", "aaaaaaaaaaaaaaaaaaaa"}) {
+      REQUIRE(asio_coro::detail::find_delimiter(data, delimiter) == std::string_view(data).find(delimiter));
+    }
+  }
+}
+
+TEST_CASE("buffered_stream reads lines split across many writes and returns them without copying") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  std::vector<std::string> lines;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    asio_coro::buffered_stream stream(server, 16, 1024);
+    while (true) {
+      const auto [error, line] = co_await stream.async_read_until("\r\n");
+      if (error) {
+        REQUIRE(error == boost::asio::error::eof);
+        REQUIRE(stream.data() == "tail");
+        break;
+      }
+
+      REQUIRE(line.data() >= stream.data().data());
+      REQUIRE(line.data() < stream.data().data() + stream.size());
+      lines.emplace_back(line.substr(0, line.size() - 2));
+      stream.consume(line.size());
+    }
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    for (const std::string_view chunk : {"first\r", "\nsecond\r\nthird", " line\r\n\r\n", "a long line that doesn't",
+                                         " fit into the initial buffer\r\ntail"}) {
+      co_await asio_coro::async_write(client, boost::asio::buffer(chunk), boost::asio::transfer_all());
+    }
+
+    client.shutdown(boost::asio::ip::tcp::socket::shutdown_send);
+  });
+
+  context.run();
+
+  REQUIRE(lines ==
+          std::vector<std::string>{"first", "second", "third line", "", "a long line that doesn't fit into the initial "
+                                                                        "buffer"});
+}
+
+TEST_CASE("buffered_stream doesn't read from the stream if the data is already buffered") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  std::vector<bool> ready;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    co_await asio_coro::async_write(client, boost::asio::buffer(std::string_view("1;2;header12345")),
+                                    boost::asio::transfer_all());
+
+    asio_coro::buffered_stream stream(server);
+    auto [error, message] = co_await stream.async_read_until(';');
+    REQUIRE(!error);
+    REQUIRE(message == "1;");
+    REQUIRE(stream.size() == 15);
+    stream.consume(message.size());
+
+    // Everything has already been read ahead, so the following reads complete without suspension.
+    auto awaitable = stream.async_read_until(';');
+    ready.push_back(awaitable.await_ready());
+    std::tie(error, message) = awaitable.await_resume();
+    REQUIRE(message == "2;");
+    stream.consume(message.size());
+
+    auto exactly_awaitable = stream.async_read_exactly(6);
+    ready.push_back(exactly_awaitable.await_ready());
+    std::tie(error, message) = exactly_awaitable.await_resume();
+    REQUIRE(message == "header");
+    stream.consume(message.size());
+
+    std::tie(error, message) = co_await stream.async_read_exactly(5);
+    REQUIRE(!error);
+    REQUIRE(message == "12345");
+  });
+
+  context.run();
+
+  REQUIRE(ready == std::vector<bool>{true, true});
+}
+
+TEST_CASE("buffered_stream fails with not_found if the message exceeds the maximum buffer size") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  const std::string data(100, 'x');
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    co_await asio_coro::async_write(client, boost::asio::buffer(data), boost::asio::transfer_all());
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    asio_coro::buffered_stream stream(server, 8, 32);
+
+    auto [error, message] = co_await stream.async_read_exactly(33);
+    REQUIRE(error == boost::asio::error::not_found);
+    REQUIRE(message.empty());
+
+    std::tie(error, message) = co_await stream.async_read_until("\n");
+    REQUIRE(error == boost::asio::error::not_found);
+    REQUIRE(stream.size() == 32);
+    REQUIRE(stream.capacity() == 32);
+
+    // The buffered data is kept, so the reader may consume it and go on.
+    stream.consume(32);
+    std::tie(error, message) = co_await stream.async_read_exactly(32);
+    REQUIRE(!error);
+    REQUIRE(message == data.substr(0, 32));
+  });
+
+  context.run();
+}
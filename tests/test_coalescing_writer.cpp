@@ -0,0 +1,149 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_connect.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/coalescing_writer.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+#include "socket_pair.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <string>
+#include <vector>
+
+TEST_CASE("coalescing_writer writes messages queued within one reactor turn with one gathered write") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  asio_coro::coalescing_writer writer(server);
+  asio_coro::buffer_pool pool(16);
+
+  std::string expected_data;
+  auto strand = boost::asio::make_strand(context);
+  for (auto i = 0; i != 10; ++i) {
+    const auto message = "message " + std::to_string(i) + ";";
+    expected_data += message + message;
+
+    asio_coro::spawn_coroutine(strand, [&, message]() -> asio_coro::task<void> {
+      auto error = co_await writer.async_write(message);
+      REQUIRE(!error);
+
+      auto buffer = pool.acquire();
+      std::copy(message.begin(), message.end(), buffer.data());
+      buffer.resize(message.size());
+      error = co_await writer.async_write(std::move(buffer));
+      REQUIRE(!error);
+    });
+  }
+
+  std::string received_data(expected_data.size(), '\0');
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto [error, size] =
+        co_await asio_coro::async_read(client, boost::asio::buffer(received_data), boost::asio::transfer_all());
+    REQUIRE(!error);
+  });
+
+  context.run();
+
+  REQUIRE(received_data == expected_data);
+  REQUIRE(writer.writes() == 1);
+  REQUIRE(writer.queued_size() == 0);
+}
+
+TEST_CASE("coalescing_writer suspends writers beyond the high-water mark until the queue is flushed") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  asio_coro::coalescing_writer writer(server, 8);
+
+  std::vector<std::size_t> queued_sizes;
+  boost::system::error_code flush_error;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    for (auto i = 0; i != 4; ++i) {
+      co_await writer.async_write("12345");
+      queued_sizes.push_back(writer.queued_size());
+    }
+
+    flush_error = co_await writer.async_flush();
+  });
+
+  std::string received_data(20, '\0');
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    co_await asio_coro::async_read(client, boost::asio::buffer(received_data), boost::asio::transfer_all());
+  });
+
+  context.run();
+
+  // Every second message exceeds the high-water mark, so the writer is resumed only once the queue is written.
+  REQUIRE(queued_sizes == std::vector<std::size_t>{5, 0, 5, 0});
+  REQUIRE(!flush_error);
+  REQUIRE(received_data == "12345123451234512345");
+  REQUIRE(writer.writes() == 2);
+}
+
+TEST_CASE("coalescing_writer continues partially written messages") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  server.set_option(boost::asio::socket_base::send_buffer_size(16 * 1024));
+  client.set_option(boost::asio::socket_base::receive_buffer_size(16 * 1024));
+
+  asio_coro::coalescing_writer writer(server);
+
+  // The messages are larger than the socket buffers, so they can't be written at once.
+  std::string expected_data;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    for (auto i = 0; i != 4; ++i) {
+      const std::string message(1024 * 1024 + i, static_cast<char>('a' + i));
+      expected_data += message;
+
+      const auto error = co_await writer.async_write(message);
+      REQUIRE(!error);
+    }
+
+    const auto error = co_await writer.async_flush();
+    REQUIRE(!error);
+  });
+
+  std::string received_data(4 * 1024 * 1024 + 6, '\0');
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    co_await asio_coro::async_read(client, boost::asio::buffer(received_data), boost::asio::transfer_all());
+  });
+
+  context.run();
+
+  REQUIRE(received_data == expected_data);
+  REQUIRE(writer.writes() > 4);
+}
+
+TEST_CASE("coalescing_writer reports write errors to the writers") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+  server.shutdown(boost::asio::ip::tcp::socket::shutdown_send);
+
+  asio_coro::coalescing_writer writer(server);
+
+  boost::system::error_code flush_error;
+  boost::system::error_code write_error;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    co_await writer.async_write("message");
+    flush_error = co_await writer.async_flush();
+    write_error = co_await writer.async_write("message");
+  });
+
+  context.run();
+
+  REQUIRE(flush_error == boost::asio::error::broken_pipe);
+  REQUIRE(write_error == boost::asio::error::broken_pipe);
+  REQUIRE(writer.writes() == 1);
+}
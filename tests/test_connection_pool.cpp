@@ -0,0 +1,257 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/connection_pool.hpp"
+#include "asio_coro/post.hpp"
+#include "asio_coro/sleep.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <array>
+#include <chrono>
+#include <list>
+#include <string_view>
+
+namespace {
+/// A server accepting connections until it's closed, which answers every byte it receives with the same byte.
+class echo_server {
+public:
+  explicit echo_server(boost::asio::io_context &context)
+      : _context(context), _acceptor(context, {boost::asio::ip::address_v4::loopback(), 0}) {
+    asio_coro::spawn_coroutine(context, [this]() -> asio_coro::task<void> {
+      while (true) {
+        auto &socket = _sockets.emplace_back(_context);
+        if (co_await asio_coro::async_accept(_acceptor, socket)) {
+          co_return;
+        }
+
+        ++accepted;
+        asio_coro::spawn_coroutine(_context, [&socket]() -> asio_coro::task<void> {
+          std::array<char, 1> byte{};
+          while (true) {
+            const auto [read_error, read_size] = co_await asio_coro::async_read(socket, boost::asio::buffer(byte));
+            if (read_error) {
+              co_return;
+            }
+
+            co_await asio_coro::async_write(socket, boost::asio::buffer(byte));
+          }
+        });
+      }
+    });
+  }
+
+  boost::asio::ip::tcp::endpoint endpoint() const { return _acceptor.local_endpoint(); }
+
+  /// Closes the accepted connections.
+  void disconnect() {
+    for (auto &socket : _sockets) {
+      socket.close();
+    }
+  }
+
+  /// Stops accepting connections and closes the accepted ones.
+  void close() {
+    _acceptor.close();
+    disconnect();
+  }
+
+  std::size_t accepted = 0;
+
+private:
+  boost::asio::io_context &_context;
+  boost::asio::ip::tcp::acceptor _acceptor;
+  std::list<boost::asio::ip::tcp::socket> _sockets;
+};
+
+/// Sends a byte over the leased connection and reads the echo.
+asio_coro::task<bool> round_trip(asio_coro::connection_pool<>::lease &lease) {
+  std::array<char, 1> byte{'x'};
+  const auto [write_error, write_size] = co_await asio_coro::async_write(lease.socket(), boost::asio::buffer(byte));
+  const auto [read_error, read_size] = co_await asio_coro::async_read(lease.socket(), boost::asio::buffer(byte));
+  co_return !write_error && !read_error && byte[0] == 'x';
+}
+} // namespace
+
+TEST_CASE("connection_pool reuses the connections returned by leases") {
+  boost::asio::io_context context;
+  echo_server server(context);
+  asio_coro::connection_pool<> pool(context.get_executor());
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    boost::asio::ip::tcp::endpoint local_endpoint;
+    {
+      auto [error, lease] = co_await pool.acquire(server.endpoint());
+      REQUIRE(!error);
+      REQUIRE(!lease.reused());
+      const auto echoed = co_await round_trip(lease);
+      REQUIRE(echoed);
+      local_endpoint = lease->local_endpoint();
+    }
+
+    REQUIRE(pool.size() == 1);
+    REQUIRE(pool.idle_size() == 1);
+
+    {
+      auto [error, lease] = co_await pool.acquire(server.endpoint());
+      REQUIRE(!error);
+      REQUIRE(lease.reused());
+      REQUIRE(lease->local_endpoint() == local_endpoint);
+      const auto echoed = co_await round_trip(lease);
+      REQUIRE(echoed);
+
+      // A discarded connection isn't returned to the pool.
+      lease.discard();
+    }
+
+    REQUIRE(pool.size() == 0);
+    REQUIRE(pool.idle_size() == 0);
+
+    server.close();
+    pool.close();
+  });
+
+  context.run();
+
+  REQUIRE(server.accepted == 1);
+}
+
+TEST_CASE("connection_pool queues the acquisitions when it's full") {
+  boost::asio::io_context context;
+  echo_server server(context);
+  asio_coro::connection_pool<> pool(context.get_executor(), 1);
+  std::size_t round_trips = 0;
+
+  for (auto i = 0; i != 3; ++i) {
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      auto [error, lease] = co_await pool.acquire(server.endpoint());
+      REQUIRE(!error);
+      REQUIRE(pool.size() == 1);
+      const auto echoed = co_await round_trip(lease);
+      REQUIRE(echoed);
+      ++round_trips;
+    });
+  }
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    while (round_trips != 3) {
+      co_await asio_coro::post(context);
+    }
+
+    // The pool closes the idle connection to the other endpoint to connect to this one.
+    echo_server other_server(context);
+    {
+      auto [error, lease] = co_await pool.acquire(other_server.endpoint());
+      REQUIRE(!error);
+      REQUIRE(!lease.reused());
+      const auto echoed = co_await round_trip(lease);
+      REQUIRE(echoed);
+    }
+
+    REQUIRE(pool.size() == 1);
+    REQUIRE(other_server.accepted == 1);
+    other_server.close();
+    server.close();
+    pool.close();
+  });
+
+  context.run();
+
+  REQUIRE(server.accepted == 1);
+}
+
+TEST_CASE("connection_pool doesn't reuse the connections closed by the peer") {
+  boost::asio::io_context context;
+  echo_server server(context);
+  asio_coro::connection_pool<> pool(context.get_executor());
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    {
+      auto [error, lease] = co_await pool.acquire(server.endpoint());
+      REQUIRE(!error);
+      const auto echoed = co_await round_trip(lease);
+      REQUIRE(echoed);
+    }
+
+    server.disconnect();
+    co_await asio_coro::sleep_for(context, std::chrono::milliseconds(10));
+
+    {
+      auto [error, lease] = co_await pool.acquire(server.endpoint());
+      REQUIRE(!error);
+      REQUIRE(!lease.reused());
+      const auto echoed = co_await round_trip(lease);
+      REQUIRE(echoed);
+    }
+
+    REQUIRE(pool.size() == 1);
+    server.close();
+    pool.close();
+  });
+
+  context.run();
+
+  REQUIRE(server.accepted == 2);
+}
+
+TEST_CASE("connection_pool closes the connections idle for the idle timeout") {
+  boost::asio::io_context context;
+  echo_server server(context);
+  asio_coro::connection_pool<> pool(context.get_executor(), 8, 1, std::chrono::milliseconds(20));
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    {
+      auto [first_error, first] = co_await pool.acquire(server.endpoint());
+      auto [second_error, second] = co_await pool.acquire(server.endpoint());
+      REQUIRE(!first_error);
+      REQUIRE(!second_error);
+      REQUIRE(pool.size() == 2);
+    }
+
+    // Only one idle connection is kept per endpoint.
+    REQUIRE(pool.size() == 1);
+    REQUIRE(pool.idle_size() == 1);
+
+    co_await asio_coro::sleep_for(context, std::chrono::milliseconds(50));
+    REQUIRE(pool.size() == 0);
+    REQUIRE(pool.idle_size() == 0);
+
+    server.close();
+  });
+
+  context.run();
+
+  REQUIRE(server.accepted == 2);
+}
+
+TEST_CASE("connection_pool fails the queued acquisitions when it's closed") {
+  boost::asio::io_context context;
+  echo_server server(context);
+  asio_coro::connection_pool<> pool(context.get_executor(), 1);
+  auto aborted = false;
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    auto [error, lease] = co_await pool.acquire(server.endpoint());
+    REQUIRE(!error);
+
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      auto [queued_error, queued_lease] = co_await pool.acquire(server.endpoint());
+      REQUIRE(queued_error == boost::asio::error::operation_aborted);
+      REQUIRE(!queued_lease);
+      aborted = true;
+    });
+
+    co_await asio_coro::sleep_for(context, std::chrono::milliseconds(10));
+    pool.close();
+    server.close();
+  });
+
+  context.run();
+
+  REQUIRE(aborted);
+  REQUIRE(pool.size() == 0);
+}
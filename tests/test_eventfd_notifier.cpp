@@ -0,0 +1,180 @@
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_wait_ready.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/eventfd_notifier.hpp"
+#include "asio_coro/post.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Awaitables read from and write to posix descriptors such as pipes") {
+  boost::asio::io_context context;
+  std::array<int, 2> fds{};
+  REQUIRE(::pipe(fds.data()) == 0);
+  boost::asio::posix::stream_descriptor reader(context, fds[0]);
+  boost::asio::posix::stream_descriptor writer(context, fds[1]);
+  std::array<char, 5> received{};
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto wait_error = co_await asio_coro::async_wait_readable(reader);
+    REQUIRE(!wait_error);
+    const auto [error, size] = co_await asio_coro::async_read(reader, boost::asio::buffer(received));
+    REQUIRE(!error);
+    REQUIRE(size == received.size());
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto wait_error = co_await asio_coro::async_wait_writable(writer);
+    REQUIRE(!wait_error);
+    const auto [error, size] = co_await asio_coro::async_write(writer, boost::asio::buffer(std::string_view("hello")));
+    REQUIRE(!error);
+    REQUIRE(size == 5);
+  });
+
+  context.run();
+
+  REQUIRE(std::string_view(received.data(), received.size()) == "hello");
+}
+
+TEST_CASE("async_wait_readable waits for an eventfd created by another library") {
+  boost::asio::io_context context;
+  const auto fd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  REQUIRE(fd != -1);
+  boost::asio::posix::stream_descriptor descriptor(context, fd);
+  std::uint64_t value = 0;
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto wait_error = co_await asio_coro::async_wait_readable(descriptor);
+    REQUIRE(!wait_error);
+    REQUIRE(::read(fd, &value, sizeof(value)) == sizeof(value));
+  });
+
+  std::thread thread([fd] {
+    const std::uint64_t increment = 3;
+    REQUIRE(::write(fd, &increment, sizeof(increment)) == sizeof(increment));
+  });
+
+  context.run();
+  thread.join();
+
+  REQUIRE(value == 3);
+}
+
+TEST_CASE("eventfd_notifier resumes the awaiting coroutine once per notification burst") {
+  boost::asio::io_context context;
+  asio_coro::eventfd_notifier notifier(context);
+  std::size_t wakeups = 0;
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    // The notifications arriving while nobody waits complete the next wait at once.
+    notifier.notify();
+    notifier.notify();
+    auto error = co_await notifier.async_wait();
+    REQUIRE(!error);
+    ++wakeups;
+
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      co_await asio_coro::post(context);
+      notifier.notify();
+    });
+
+    error = co_await notifier.async_wait();
+    REQUIRE(!error);
+    ++wakeups;
+
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      co_await asio_coro::post(context);
+      notifier.cancel();
+    });
+
+    error = co_await notifier.async_wait();
+    REQUIRE(error == boost::asio::error::operation_aborted);
+  });
+
+  context.run();
+
+  REQUIRE(wakeups == 2);
+}
+
+TEST_CASE("eventfd_notifier may be notified from other threads") {
+  constexpr std::size_t notifications_count = 10000;
+  boost::asio::io_context context;
+  asio_coro::eventfd_notifier notifier(context);
+  std::atomic<std::size_t> produced = 0;
+  std::size_t consumed = 0;
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    while (consumed != notifications_count) {
+      const auto error = co_await notifier.async_wait();
+      REQUIRE(!error);
+      consumed = produced.load();
+    }
+  });
+
+  std::thread thread([&] {
+    for (std::size_t i = 0; i != notifications_count; ++i) {
+      produced.fetch_add(1);
+      notifier.notify();
+    }
+  });
+
+  context.run();
+  thread.join();
+
+  REQUIRE(consumed == notifications_count);
+}
+
+TEST_CASE("eventfd_notifier doesn't miss notifications on an io_context run by several threads") {
+  constexpr std::size_t notifications_count = 10000;
+  boost::asio::io_context context;
+  asio_coro::eventfd_notifier notifier(context);
+  std::atomic<std::size_t> produced = 0;
+  std::atomic<std::size_t> consumed = 0;
+  std::atomic<bool> failed = false;
+
+  // Every notification is sent once the previous one is consumed, so it arrives while the coroutine starts waiting for
+  // it, and the readiness events are handled by any of the threads running the io_context.
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    while (consumed != notifications_count) {
+      const auto error = co_await notifier.async_wait();
+      failed = failed || error;
+      consumed = produced.load();
+    }
+  });
+
+  std::vector<std::thread> threads;
+  for (auto i = 0; i != 4; ++i) {
+    threads.emplace_back([&]() { context.run(); });
+  }
+
+  std::thread producer([&] {
+    for (std::size_t i = 0; i != notifications_count; ++i) {
+      produced.fetch_add(1);
+      notifier.notify();
+      while (consumed.load() <= i && !failed) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  producer.join();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(!failed);
+  REQUIRE(consumed == notifications_count);
+}
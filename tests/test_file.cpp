@@ -0,0 +1,139 @@
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/file.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+
+#include <boost/asio/io_context.hpp>
+
+#include <cstdlib>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+/// A temporary file removed upon destruction.
+class temporary_file {
+public:
+  temporary_file() {
+    const auto fd = ::mkstemp(_path.data());
+    REQUIRE(fd != -1);
+    ::close(fd);
+  }
+
+  ~temporary_file() { ::unlink(_path.c_str()); }
+
+  const char *path() const noexcept { return _path.c_str(); }
+
+private:
+  std::string _path = "/tmp/asio_coro_file_XXXXXX";
+};
+
+/// Runs the test for the thread pool backend, and for the io_uring one if it's available. The test is passed the
+/// io_context to run and the object to create the files with.
+template <class Test> void for_each_backend(Test test) {
+  SECTION("thread pool") {
+    boost::asio::io_context context;
+    test(context, context);
+  }
+
+#if defined(ASIO_CORO_HAS_IO_URING)
+  SECTION("io_uring") {
+    if (!asio_coro::uring_context::is_supported()) {
+      WARN("io_uring is not available");
+      return;
+    }
+
+    boost::asio::io_context context;
+    asio_coro::uring_context ring(context);
+    test(context, ring);
+  }
+#endif
+}
+} // namespace
+
+TEST_CASE("random_access_file reads and writes data at the specified offsets") {
+  for_each_backend([](boost::asio::io_context &context, auto &backend) {
+    temporary_file path;
+    asio_coro::random_access_file file(backend);
+    REQUIRE(!file.open(path.path(), O_RDWR));
+
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      auto [error, size] = co_await asio_coro::async_write_at(file, 5, boost::asio::buffer(std::string_view("world")));
+      REQUIRE(!error);
+      REQUIRE(size == 5);
+
+      const std::vector<boost::asio::const_buffer> buffers{boost::asio::buffer(std::string_view("he")),
+                                                           boost::asio::buffer(std::string_view("llo"))};
+      std::tie(error, size) = co_await asio_coro::async_write_at(file, 0, buffers, boost::asio::transfer_all());
+      REQUIRE(!error);
+      REQUIRE(size == 5);
+
+      std::string data(10, '\0');
+      std::tie(error, size) = co_await asio_coro::async_read_at(file, 0, boost::asio::buffer(data),
+                                                                boost::asio::transfer_all());
+      REQUIRE(!error);
+      REQUIRE(data == "helloworld");
+
+      std::tie(error, size) = co_await asio_coro::async_read_at(file, 3, boost::asio::buffer(data));
+      REQUIRE(!error);
+      REQUIRE(data.substr(0, size) == "loworld");
+
+      std::tie(error, size) = co_await asio_coro::async_read_at(file, 10, boost::asio::buffer(data));
+      REQUIRE(error == boost::asio::error::eof);
+      REQUIRE(size == 0);
+    });
+
+    context.run();
+
+    boost::system::error_code error;
+    REQUIRE(file.size(error) == 10);
+    REQUIRE(!error);
+  });
+}
+
+TEST_CASE("stream_file reads and writes data sequentially") {
+  for_each_backend([](boost::asio::io_context &context, auto &backend) {
+    temporary_file path;
+    asio_coro::random_access_file file(backend);
+    REQUIRE(!file.open(path.path(), O_RDWR));
+
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      asio_coro::stream_file stream(backend);
+      REQUIRE(!stream.open(path.path(), O_RDWR));
+
+      const std::string content(100000, 'x');
+      auto [error, size] =
+          co_await asio_coro::async_write(stream, boost::asio::buffer(content), boost::asio::transfer_all());
+      REQUIRE(!error);
+      REQUIRE(stream.position() == content.size());
+
+      // The data written through the stream is visible through the random access file opened on the same path.
+      std::string data(content.size(), '\0');
+      std::tie(error, size) = co_await asio_coro::async_read_at(file, 0, boost::asio::buffer(data),
+                                                                boost::asio::transfer_all());
+      REQUIRE(!error);
+      REQUIRE(data == content);
+
+      stream.seek(content.size() - 10);
+      std::tie(error, size) =
+          co_await asio_coro::async_read(stream, boost::asio::buffer(data), boost::asio::transfer_all());
+      REQUIRE(error == boost::asio::error::eof);
+      REQUIRE(size == 10);
+      REQUIRE(stream.position() == content.size());
+    });
+
+    context.run();
+  });
+}
+
+TEST_CASE("random_access_file reports an error if the file can't be opened") {
+  boost::asio::io_context context;
+  asio_coro::random_access_file file(context);
+  REQUIRE(file.open("/nonexistent/asio_coro_file") == boost::system::errc::no_such_file_or_directory);
+  REQUIRE(!file.is_open());
+}
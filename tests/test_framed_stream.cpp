@@ -0,0 +1,166 @@
+#include "asio_coro/buffer_pool.hpp"
+#include "asio_coro/detail/crc32c.hpp"
+#include "asio_coro/framed_stream.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+#include "socket_pair.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/write.hpp>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+/// Returns the frame of the specified payload without a checksum.
+std::string make_frame(std::string_view payload) {
+  std::string frame(4, '\0');
+  asio_coro::detail::store_big_endian(frame.data(), static_cast<std::uint32_t>(payload.size()));
+  return frame.append(payload);
+}
+} // namespace
+
+TEST_CASE("crc32c computes the Castagnoli checksum in hardware and in software alike") {
+  REQUIRE(asio_coro::detail::crc32c("123456789", 9) == 0xe3069283u);
+  REQUIRE(asio_coro::detail::crc32c_software("123456789", 9) == 0xe3069283u);
+  REQUIRE(asio_coro::detail::crc32c("", 0) == 0);
+
+  std::string data;
+  for (auto i = 0; i != 1000; ++i) {
+    data.push_back(static_cast<char>(i * 31 + 7));
+  }
+
+  for (const auto size : {1, 7, 8, 9, 63, 64, 65, 1000}) {
+    const auto expected = asio_coro::detail::crc32c_software(data.data(), size);
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("sse4.2")) {
+      REQUIRE(asio_coro::detail::crc32c_hardware(data.data(), size) == expected);
+    }
+#endif
+    REQUIRE(asio_coro::detail::crc32c(data.data(), size) == expected);
+
+    // A checksum computed in pieces is the same.
+    const auto head = asio_coro::detail::crc32c(data.data(), size / 2);
+    REQUIRE(asio_coro::detail::crc32c(data.data() + size / 2, size - size / 2, head) == expected);
+  }
+}
+
+TEST_CASE("framed_stream writes queued frames with one gathered write and reads them back") {
+  const auto checksum = GENERATE(asio_coro::frame_checksum::none, asio_coro::frame_checksum::crc32c);
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  asio_coro::framed_stream writer(server, checksum);
+  asio_coro::framed_stream reader(client, checksum);
+  asio_coro::buffer_pool pool(32);
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    auto pooled = pool.acquire();
+    std::memcpy(pooled.data(), "pooled payload", 14);
+    pooled.resize(14);
+
+    const auto first_error = co_await writer.async_write_frame(std::string("first"));
+    REQUIRE(!first_error);
+    const auto pooled_error = co_await writer.async_write_frame(std::move(pooled));
+    REQUIRE(!pooled_error);
+    const auto empty_error = co_await writer.async_write_frame(std::string());
+    REQUIRE(!empty_error);
+    const auto last_error = co_await writer.async_write_frame(std::string(10000, 'x'));
+    REQUIRE(!last_error);
+
+    const auto flush_error = co_await writer.async_flush();
+    REQUIRE(!flush_error);
+    REQUIRE(writer.writes() == 1);
+  });
+
+  std::vector<std::string> payloads;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    for (auto i = 0; i != 4; ++i) {
+      const auto [error, payload] = co_await reader.async_read_frame();
+      REQUIRE(!error);
+      payloads.emplace_back(payload);
+    }
+  });
+
+  context.run();
+
+  REQUIRE(payloads == std::vector<std::string>{"first", "pooled payload", "", std::string(10000, 'x')});
+}
+
+TEST_CASE("framed_stream reads frames delivered in pieces") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  asio_coro::framed_stream reader(client);
+  const auto data = make_frame("split") + make_frame("frames");
+
+  std::vector<std::string> payloads;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    for (auto i = 0; i != 2; ++i) {
+      const auto [error, payload] = co_await reader.async_read_frame();
+      REQUIRE(!error);
+      payloads.emplace_back(payload);
+    }
+  });
+
+  // Every piece is delivered in its own reactor turn, splitting both the header and the payload.
+  for (const auto piece : {std::string_view(data).substr(0, 2), std::string_view(data).substr(2, 5),
+                           std::string_view(data).substr(7)}) {
+    boost::asio::write(server, boost::asio::buffer(piece));
+    context.run_one();
+  }
+  context.run();
+
+  REQUIRE(payloads == std::vector<std::string>{"split", "frames"});
+
+  // The stream reaches its end after the last frame.
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto [error, payload] = co_await reader.async_read_frame();
+    REQUIRE(error == boost::asio::error::eof);
+  });
+  server.close();
+  context.restart();
+  context.run();
+}
+
+TEST_CASE("framed_stream skips frames with a mismatched checksum and rejects oversized frames") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  asio_coro::framed_stream reader(client, asio_coro::frame_checksum::crc32c, 16);
+
+  std::string corrupted(8, '\0');
+  asio_coro::detail::store_big_endian(corrupted.data(), 3);
+  asio_coro::detail::store_big_endian(corrupted.data() + 4, asio_coro::detail::crc32c("abc", 3));
+  std::string valid = corrupted + "abc";
+  corrupted += "abd";
+
+  std::string oversized(8, '\0');
+  asio_coro::detail::store_big_endian(oversized.data(), 17);
+  boost::asio::write(server, boost::asio::buffer(corrupted + valid + oversized));
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto [corrupted_error, corrupted_payload] = co_await reader.async_read_frame();
+    REQUIRE(corrupted_error == boost::system::errc::bad_message);
+
+    const auto [valid_error, valid_payload] = co_await reader.async_read_frame();
+    REQUIRE(!valid_error);
+    REQUIRE(valid_payload == "abc");
+
+    const auto [oversized_error, oversized_payload] = co_await reader.async_read_frame();
+    REQUIRE(oversized_error == boost::asio::error::message_size);
+  });
+
+  context.run();
+}
@@ -0,0 +1,155 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_connect.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_send_fds.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/hot_restart.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/local/connect_pair.hpp>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
+
+#include <unistd.h>
+
+#include <array>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+TEST_CASE("async_send_fds/async_receive_fds pass file descriptors over a Unix domain socket") {
+  boost::asio::io_context context;
+  boost::asio::local::stream_protocol::socket sender(context);
+  boost::asio::local::stream_protocol::socket receiver(context);
+  boost::asio::local::connect_pair(sender, receiver);
+
+  std::array<int, 2> pipe_fds{};
+  REQUIRE(::pipe(pipe_fds.data()) == 0);
+  boost::asio::posix::stream_descriptor pipe_reader(context, pipe_fds[0]);
+  std::array<char, 5> piped{};
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    std::vector<int> fds{pipe_fds[1]};
+    const auto [error, size] =
+        co_await asio_coro::async_send_fds(sender, boost::asio::buffer(std::string_view("pipe")), std::move(fds));
+    REQUIRE(!error);
+    REQUIRE(size == 4);
+
+    // The receiver has its own duplicate of the write end.
+    ::close(pipe_fds[1]);
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    std::array<char, 4> data{};
+    std::vector<int> fds;
+    const auto [error, size] = co_await asio_coro::async_receive_fds(receiver, boost::asio::buffer(data), fds);
+    REQUIRE(!error);
+    REQUIRE(size == 4);
+    REQUIRE(std::string_view(data.data(), size) == "pipe");
+    REQUIRE(fds.size() == 1);
+
+    boost::asio::posix::stream_descriptor pipe_writer(context, fds.front());
+    const auto [write_error, write_size] =
+        co_await asio_coro::async_write(pipe_writer, boost::asio::buffer(std::string_view("hello")));
+    REQUIRE(!write_error);
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto [error, size] =
+        co_await asio_coro::async_read(pipe_reader, boost::asio::buffer(piped), boost::asio::transfer_all());
+    REQUIRE(!error);
+  });
+
+  context.run();
+
+  REQUIRE(std::string_view(piped.data(), piped.size()) == "hello");
+}
+
+TEST_CASE("async_receive_fds fails if more file descriptors are passed than expected") {
+  boost::asio::io_context context;
+  boost::asio::local::stream_protocol::socket sender(context);
+  boost::asio::local::stream_protocol::socket receiver(context);
+  boost::asio::local::connect_pair(sender, receiver);
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    std::vector<int> sent_fds{0, 1, 2};
+    const auto [send_error, sent] =
+        co_await asio_coro::async_send_fds(sender, boost::asio::buffer(std::string_view("x")), std::move(sent_fds));
+    REQUIRE(!send_error);
+
+    char data;
+    std::vector<int> fds;
+    const auto [error, size] = co_await asio_coro::async_receive_fds(receiver, boost::asio::buffer(&data, 1), fds, 2);
+    REQUIRE(error == boost::asio::error::message_size);
+    REQUIRE(size == 1);
+    REQUIRE(fds.size() == 2);
+    for (const auto fd : fds) {
+      ::close(fd);
+    }
+
+    // Ancillary data needs at least one byte of data to be sent with.
+    std::vector<int> single_fd{0};
+    const auto [empty_error, empty_size] =
+        co_await asio_coro::async_send_fds(sender, boost::asio::buffer("", 0), std::move(single_fd));
+    REQUIRE(empty_error == boost::asio::error::invalid_argument);
+  });
+
+  context.run();
+}
+
+TEST_CASE("async_hand_over/async_take_over move acceptors to another process without dropping the backlog") {
+  // Each process has its own reactor, the io_contexts stand for the old and the new process.
+  boost::asio::io_context old_context;
+  boost::asio::io_context new_context;
+  boost::asio::local::stream_protocol::socket old_channel(old_context);
+  boost::asio::local::stream_protocol::socket new_channel(new_context);
+  boost::asio::local::connect_pair(old_channel, new_channel);
+
+  std::vector<boost::asio::ip::tcp::acceptor> old_acceptors;
+  old_acceptors.emplace_back(old_context, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0));
+  old_acceptors.emplace_back(old_context, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v6::loopback(), 0));
+  const auto endpoint = old_acceptors.front().local_endpoint();
+  const auto v6_endpoint = old_acceptors.back().local_endpoint();
+
+  // The connection waits in the backlog while the acceptors are handed over.
+  boost::asio::ip::tcp::socket client(old_context);
+  client.connect(endpoint);
+
+  asio_coro::spawn_coroutine(old_context, [&]() -> asio_coro::task<void> {
+    const auto [error, count] = co_await asio_coro::async_hand_over(old_channel, old_acceptors);
+    REQUIRE(!error);
+    REQUIRE(count == 1);
+    old_acceptors.clear();
+  });
+
+  old_context.run();
+
+  std::vector<boost::asio::ip::tcp::acceptor> new_acceptors;
+  asio_coro::spawn_coroutine(new_context, [&]() -> asio_coro::task<void> {
+    const auto [error, count] = co_await asio_coro::async_take_over(new_channel, new_acceptors);
+    REQUIRE(!error);
+    REQUIRE(count == 2);
+    REQUIRE(new_acceptors.size() == 2);
+    REQUIRE(new_acceptors.front().local_endpoint() == endpoint);
+    REQUIRE(new_acceptors.back().local_endpoint() == v6_endpoint);
+
+    boost::asio::ip::tcp::socket accepted(new_context);
+    const auto accept_error = co_await asio_coro::async_accept(new_acceptors.front(), accepted);
+    REQUIRE(!accept_error);
+    REQUIRE(accepted.remote_endpoint() == client.local_endpoint());
+
+    const auto [write_error, write_size] =
+        co_await asio_coro::async_write(accepted, boost::asio::buffer(std::string_view("new")));
+    REQUIRE(!write_error);
+  });
+
+  new_context.run();
+
+  std::array<char, 3> received{};
+  boost::asio::read(client, boost::asio::buffer(received));
+  REQUIRE(std::string_view(received.data(), received.size()) == "new");
+}
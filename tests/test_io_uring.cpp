@@ -0,0 +1,208 @@
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/io_uring.hpp"
+#include "asio_coro/post.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+#include "socket_pair.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include <unistd.h>
+
+#if defined(ASIO_CORO_HAS_IO_URING)
+
+TEST_CASE("uring_context submits the operations started within one loop iteration with one system call") {
+  if (!asio_coro::uring_context::is_supported()) {
+    WARN("io_uring is not available");
+    return;
+  }
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  asio_coro::uring_context ring(context);
+  const auto file = ring.register_file(server.native_handle());
+  REQUIRE(file.registered());
+
+  for (auto i = 0; i != 8; ++i) {
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      const auto [error, size] = co_await ring.async_send(file, boost::asio::buffer(std::string_view("message;")));
+      REQUIRE(!error);
+      REQUIRE(size == 8);
+    });
+  }
+
+  std::string received_data(64, '\0');
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto [error, size] =
+        co_await asio_coro::async_read(client, boost::asio::buffer(received_data), boost::asio::transfer_all());
+    REQUIRE(!error);
+  });
+
+  context.run();
+
+  REQUIRE(received_data.find_first_not_of("message;") == std::string::npos);
+  REQUIRE(ring.operations() == 8);
+  REQUIRE(ring.submissions() == 1);
+}
+
+TEST_CASE("uring_context receives data into buffers picked from a provided buffer ring") {
+  if (!asio_coro::uring_context::is_supported()) {
+    WARN("io_uring is not available");
+    return;
+  }
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  asio_coro::uring_context ring(context);
+  asio_coro::uring_buffer_ring buffers(ring, 1, 1, 64);
+  REQUIRE(buffers.count() == 1);
+
+  client.send(boost::asio::buffer(std::string_view("hello")));
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto file = ring.register_file(server.native_handle());
+    auto [error, buffer] = co_await ring.async_recv(file, buffers);
+    REQUIRE(!error);
+    REQUIRE(std::string_view(buffer.data(), buffer.size()) == "hello");
+
+    // The only buffer is held, so the next receive has nothing to pick.
+    client.send(boost::asio::buffer(std::string_view("world")));
+    auto [no_buffer_error, no_buffer] = co_await ring.async_recv(file, buffers);
+    REQUIRE(no_buffer_error == boost::system::errc::no_buffer_space);
+    REQUIRE(!no_buffer.valid());
+
+    buffer.reset();
+    std::tie(error, buffer) = co_await ring.async_recv(file, buffers);
+    REQUIRE(!error);
+    REQUIRE(std::string_view(buffer.data(), buffer.size()) == "world");
+
+    buffer.reset();
+    client.shutdown(boost::asio::ip::tcp::socket::shutdown_send);
+    std::tie(error, buffer) = co_await ring.async_recv(file, buffers);
+    REQUIRE(error == boost::asio::error::eof);
+  });
+
+  context.run();
+}
+
+TEST_CASE("uring_context reads and writes files at the specified offsets") {
+  if (!asio_coro::uring_context::is_supported()) {
+    WARN("io_uring is not available");
+    return;
+  }
+
+  char path[] = "/tmp/asio_coro_io_uring_XXXXXX";
+  const auto fd = ::mkstemp(path);
+  REQUIRE(fd != -1);
+  ::unlink(path);
+
+  boost::asio::io_context context;
+  asio_coro::uring_context ring(context);
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const asio_coro::uring_file file{fd};
+    auto [error, size] = co_await ring.async_write(file, boost::asio::buffer(std::string_view("world")), 5);
+    REQUIRE(!error);
+    REQUIRE(size == 5);
+
+    std::tie(error, size) = co_await ring.async_write(file, boost::asio::buffer(std::string_view("hello")), 0);
+    REQUIRE(!error);
+
+    std::string data(16, '\0');
+    std::tie(error, size) = co_await ring.async_read(file, boost::asio::buffer(data), 0);
+    REQUIRE(!error);
+    REQUIRE(data.substr(0, size) == "helloworld");
+
+    std::tie(error, size) = co_await ring.async_read(file, boost::asio::buffer(data), 10);
+    REQUIRE(error == boost::asio::error::eof);
+  });
+
+  context.run();
+  ::close(fd);
+}
+
+TEST_CASE("uring_context cancels the operations in flight on a file") {
+  if (!asio_coro::uring_context::is_supported()) {
+    WARN("io_uring is not available");
+    return;
+  }
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  asio_coro::uring_context ring(context);
+  const auto file = ring.register_file(server.native_handle());
+
+  boost::system::error_code recv_error;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    std::string data(16, '\0');
+    std::tie(recv_error, std::ignore) = co_await ring.async_recv(file, boost::asio::buffer(data));
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    co_await asio_coro::post(context);
+    ring.cancel(file);
+  });
+
+  context.run();
+
+  REQUIRE(recv_error == boost::asio::error::operation_aborted);
+}
+
+TEST_CASE("uring_context may be destroyed by the coroutine its last completion resumes") {
+  if (!asio_coro::uring_context::is_supported()) {
+    WARN("io_uring is not available");
+    return;
+  }
+
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  // The ring runs on the strand of the coroutine, so the completion resumes the coroutine inline, while the wait for
+  // the eventfd and the handlers the ring has posted are still queued.
+  auto strand = boost::asio::make_strand(context);
+  auto ring = std::make_unique<asio_coro::uring_context>(strand);
+  const asio_coro::uring_file file{server.native_handle()};
+  client.send(boost::asio::buffer(std::string_view("hello")));
+
+  auto destroyed = false;
+  asio_coro::spawn_coroutine(strand, [&]() -> asio_coro::task<void> {
+    // The completion of the cancellation isn't awaited, so the receive finds it in the completion queue upon starting
+    // to wait for the eventfd, and reaps the queue with a posted handler.
+    ring->cancel(file);
+    co_await asio_coro::post(strand);
+
+    std::string data(5, '\0');
+    const auto [error, size] = co_await ring->async_recv(file, boost::asio::buffer(data));
+    REQUIRE(!error);
+    REQUIRE(data == "hello");
+
+    // The cancellation posts a submission right before the destruction.
+    ring->cancel(file);
+    ring.reset();
+    destroyed = true;
+  });
+
+  context.run();
+
+  REQUIRE(destroyed);
+}
+
+#endif // defined(ASIO_CORO_HAS_IO_URING)
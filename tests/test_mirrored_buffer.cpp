@@ -0,0 +1,110 @@
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/mirrored_buffer.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+#include "socket_pair.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+
+namespace {
+std::string_view to_string_view(const boost::asio::const_buffer &buffer) {
+  return std::string_view(static_cast<const char *>(buffer.data()), buffer.size());
+}
+} // namespace
+
+TEST_CASE("mirrored_buffer keeps the readable and the writable regions contiguous across the wrap point") {
+  const auto page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  asio_coro::mirrored_buffer buffer(100);
+  REQUIRE(buffer.capacity() == page_size);
+  REQUIRE(buffer.prepare().size() == page_size);
+
+  // Move both regions close to the end of the ring.
+  buffer.commit(page_size - 3);
+  buffer.consume(page_size - 3);
+  REQUIRE(buffer.empty());
+
+  auto writable = buffer.prepare();
+  REQUIRE(writable.size() == page_size);
+  std::memcpy(writable.data(), "wrapped", 7);
+  buffer.commit(7);
+
+  REQUIRE(to_string_view(buffer.data()) == "wrapped");
+
+  // The bytes beyond the end of the ring are the bytes of its beginning.
+  auto *const first_byte = static_cast<char *>(writable.data()) + 3 - page_size;
+  REQUIRE(std::string_view(first_byte, 4) == "pped");
+
+  buffer.consume(5);
+  REQUIRE(buffer.size() == 2);
+  REQUIRE(to_string_view(buffer.data()) == "ed");
+  REQUIRE(buffer.data().data() == first_byte + 2);
+  REQUIRE(buffer.prepare().size() == page_size - 2);
+}
+
+TEST_CASE("async_read/async_write accept a mirrored_buffer and stream through it without splitting at the wrap "
+          "point") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  std::string expected_data;
+  for (auto i = 0; expected_data.size() < 256 * 1024; ++i) {
+    expected_data += std::to_string(i) + std::string(i % 97, 'r') + '\n';
+  }
+
+  // The writer streams the data through its own ring, so partial writes are continued from the ring.
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    asio_coro::mirrored_buffer buffer(1);
+    auto remaining = std::string_view(expected_data);
+    while (!remaining.empty() || !buffer.empty()) {
+      const auto writable = buffer.prepare();
+      const auto size = std::min(writable.size(), remaining.size());
+      std::memcpy(writable.data(), remaining.data(), size);
+      buffer.commit(size);
+      remaining.remove_prefix(size);
+
+      const auto [error, written] = co_await asio_coro::async_write(client, buffer);
+      REQUIRE(!error);
+    }
+
+    client.shutdown(boost::asio::ip::tcp::socket::shutdown_send);
+  });
+
+  // The reader parses records in place, even those crossing the end of the ring.
+  std::string received_data;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    asio_coro::mirrored_buffer buffer(1);
+    while (true) {
+      auto data = to_string_view(buffer.data());
+      for (auto end = data.find('\n'); end != std::string_view::npos; end = data.find('\n')) {
+        received_data += data.substr(0, end + 1);
+        buffer.consume(end + 1);
+        data.remove_prefix(end + 1);
+      }
+
+      const auto [error, size] = co_await asio_coro::async_read(server, buffer);
+      if (error) {
+        REQUIRE(error == boost::asio::error::eof);
+        REQUIRE(buffer.empty());
+        break;
+      }
+
+      REQUIRE(buffer.size() >= size);
+    }
+  });
+
+  context.run();
+
+  REQUIRE(received_data == expected_data);
+}
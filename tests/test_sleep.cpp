@@ -0,0 +1,130 @@
+#include "asio_coro/sleep.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+
+#include <boost/asio/error.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/strand.hpp>
+
+#include <chrono>
+#include <memory>
+
+namespace {
+std::size_t pooled_timers_count(boost::asio::io_context &context) {
+  return boost::asio::use_service<asio_coro::detail::timer_pool_service>(context).size();
+}
+} // namespace
+
+TEST_CASE("sleep_for resumes the coroutine not earlier than the specified duration") {
+  boost::asio::io_context context;
+
+  boost::system::error_code sleep_error;
+  std::chrono::steady_clock::duration slept_for;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto started_at = std::chrono::steady_clock::now();
+    sleep_error = co_await asio_coro::sleep_for(context, std::chrono::milliseconds(50));
+    slept_for = std::chrono::steady_clock::now() - started_at;
+  });
+
+  context.run();
+
+  REQUIRE(!sleep_error);
+  REQUIRE(slept_for >= std::chrono::milliseconds(50));
+}
+
+TEST_CASE("sleep_for reuses the pooled timers") {
+  boost::asio::io_context context;
+
+  for (auto i = 0; i != 10; ++i) {
+    asio_coro::spawn_coroutine(context, [&, i]() -> asio_coro::task<void> {
+      for (auto j = 0; j != 10; ++j) {
+        const auto error = co_await asio_coro::sleep_for(context, std::chrono::milliseconds(1 + (i + j) % 3));
+        REQUIRE(!error);
+      }
+    });
+  }
+
+  context.run();
+
+  REQUIRE(pooled_timers_count(context) <= 10);
+}
+
+TEST_CASE("sleep_until coalesces the deadlines that fall into the same slack window") {
+  boost::asio::io_context context;
+  asio_coro::set_sleep_slack(context, std::chrono::seconds(1));
+
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(10);
+  auto late_resumptions = 0;
+  for (auto i = 0; i != 10; ++i) {
+    asio_coro::spawn_coroutine(context, [&, i]() -> asio_coro::task<void> {
+      const auto sleeper_deadline = deadline + std::chrono::microseconds(i);
+      const auto error = co_await asio_coro::sleep_until(context, sleeper_deadline);
+      REQUIRE(!error);
+
+      if (std::chrono::steady_clock::now() >= sleeper_deadline) {
+        ++late_resumptions;
+      }
+    });
+  }
+
+  context.run();
+
+  REQUIRE(late_resumptions == 10);
+
+  // All the deadlines fall into at most two adjacent slack windows.
+  REQUIRE(pooled_timers_count(context) <= 2);
+}
+
+TEST_CASE("sleep_for resumes the sleepers reusing a pooled timer on their own strands") {
+  boost::asio::io_context context;
+  auto first_strand = boost::asio::make_strand(context);
+  auto second_strand = boost::asio::make_strand(context);
+
+  auto first_on_strand = false;
+  auto second_on_strand = false;
+  asio_coro::spawn_coroutine(first_strand, [&]() -> asio_coro::task<void> {
+    co_await asio_coro::sleep_for(first_strand, std::chrono::milliseconds(1));
+    first_on_strand = first_strand.running_in_this_thread();
+
+    // The timer of the first sleeper is free by now, so the second sleeper reuses it.
+    asio_coro::spawn_coroutine(second_strand, [&]() -> asio_coro::task<void> {
+      co_await asio_coro::sleep_for(second_strand, std::chrono::milliseconds(1));
+      second_on_strand = second_strand.running_in_this_thread();
+    });
+  });
+
+  context.run();
+
+  REQUIRE(first_on_strand);
+  REQUIRE(second_on_strand);
+  REQUIRE(pooled_timers_count(context) == 1);
+}
+
+TEST_CASE("sleep_for accepts a temporary executor") {
+  boost::asio::io_context context;
+
+  boost::system::error_code sleep_error = boost::asio::error::would_block;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    sleep_error = co_await asio_coro::sleep_for(boost::asio::make_strand(context), std::chrono::milliseconds(1));
+  });
+
+  context.run();
+
+  REQUIRE(!sleep_error);
+}
+
+TEST_CASE("sleep_for destroys the pooled timers and the pending sleepers upon the io_context destruction") {
+  const auto ptr = std::make_shared<int>(100);
+  {
+    boost::asio::io_context context;
+    asio_coro::spawn_coroutine(context, [&context, ptr]() -> asio_coro::task<void> {
+      co_await asio_coro::sleep_for(context, std::chrono::milliseconds(1));
+    });
+
+    context.poll();
+    REQUIRE(ptr.use_count() == 2);
+  }
+
+  REQUIRE(ptr.use_count() == 1);
+}
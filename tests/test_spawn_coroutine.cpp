@@ -1,10 +1,15 @@
+#include "asio_coro/async_wait.hpp"
 #include "asio_coro/task.hpp"
 
 #include "catch2/catch.hpp"
 
 #include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
 
+#include <atomic>
 #include <memory>
+#include <thread>
+#include <vector>
 
 TEST_CASE("spawn_coroutine runs coroutine within specified io_context") {
   boost::asio::io_context context;
@@ -30,3 +35,60 @@ TEST_CASE("spawn_coroutine destroys coroutine context upon it's finished") {
   context.run();
   REQUIRE(ptr.use_count() == 1);
 }
+
+TEST_CASE("spawn_coroutine resumes coroutine on its strand when io_context runs on multiple threads") {
+  using strand_type = boost::asio::strand<boost::asio::io_context::executor_type>;
+
+  boost::asio::io_context context;
+  // Catch2 assertions aren't thread-safe, so the coroutines only count the failed checks, which are asserted on once
+  // the threads are joined.
+  std::atomic<int> without_strand(0);
+  std::atomic<int> nested_executor_mismatches(0);
+  std::atomic<int> resumed_outside_of_strand(0);
+  std::atomic<int> finished(0);
+
+  for (auto i = 0; i != 8; ++i) {
+    asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+      const auto executor = co_await asio_coro::current_executor();
+      const auto *strand = executor.target<strand_type>();
+      if (!strand) {
+        ++without_strand;
+        co_return;
+      }
+
+      auto nested_coroutine = []() -> asio_coro::task<asio_coro::executor_type> {
+        co_return co_await asio_coro::current_executor();
+      };
+      const auto nested_executor = co_await nested_coroutine();
+      if (nested_executor != executor) {
+        ++nested_executor_mismatches;
+      }
+
+      boost::asio::steady_timer timer(context);
+      for (auto j = 0; j != 100; ++j) {
+        timer.expires_after(std::chrono::microseconds(j % 3));
+        co_await asio_coro::async_wait(timer);
+
+        if (!strand->running_in_this_thread()) {
+          ++resumed_outside_of_strand;
+        }
+      }
+
+      ++finished;
+    });
+  }
+
+  std::vector<std::thread> threads;
+  for (auto i = 0; i != 4; ++i) {
+    threads.emplace_back([&context]() { context.run(); });
+  }
+
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(without_strand == 0);
+  REQUIRE(nested_executor_mismatches == 0);
+  REQUIRE(finished == 8);
+  REQUIRE(resumed_outside_of_strand == 0);
+}
@@ -0,0 +1,273 @@
+#include "asio_coro/async_accept.hpp"
+#include "asio_coro/async_connect.hpp"
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/async_write.hpp"
+#include "asio_coro/ssl_stream.hpp"
+#include "asio_coro/task.hpp"
+
+#include "catch2/catch.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+
+#include <openssl/evp.h>
+#include <openssl/x509.h>
+
+#include <array>
+#include <memory>
+#include <string_view>
+
+namespace {
+using ssl_socket = boost::asio::ssl::stream<boost::asio::ip::tcp::socket>;
+
+/// Makes the server use a new self-signed certificate, and the client trust it.
+void use_self_signed_certificate(boost::asio::ssl::context &server, boost::asio::ssl::context &client) {
+  std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> key(EVP_EC_gen("P-256"), &EVP_PKEY_free);
+  std::unique_ptr<X509, decltype(&X509_free)> certificate(X509_new(), &X509_free);
+  X509_set_version(certificate.get(), 2);
+  ASN1_INTEGER_set(X509_get_serialNumber(certificate.get()), 1);
+  X509_gmtime_adj(X509_getm_notBefore(certificate.get()), 0);
+  X509_gmtime_adj(X509_getm_notAfter(certificate.get()), 3600);
+  X509_set_pubkey(certificate.get(), key.get());
+  const auto name = X509_get_subject_name(certificate.get());
+  X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char *>("localhost"), -1, -1, 0);
+  X509_set_issuer_name(certificate.get(), name);
+  X509_sign(certificate.get(), key.get(), EVP_sha256());
+
+  SSL_CTX_use_certificate(server.native_handle(), certificate.get());
+  SSL_CTX_use_PrivateKey(server.native_handle(), key.get());
+  X509_STORE_add_cert(SSL_CTX_get_cert_store(client.native_handle()), certificate.get());
+  client.set_verify_mode(boost::asio::ssl::verify_peer);
+}
+
+/// Accepts the specified amount of connections, performs the handshake, and answers every connection with one byte
+/// followed by the data it has read.
+void start_server(boost::asio::io_context &context, boost::asio::ip::tcp::acceptor &acceptor,
+                  boost::asio::ssl::context &ssl_context, std::size_t count) {
+  asio_coro::spawn_coroutine(context, [&, count]() -> asio_coro::task<void> {
+    for (std::size_t i = 0; i != count; ++i) {
+      auto stream = std::make_shared<ssl_socket>(context, ssl_context);
+      const auto accept_error = co_await asio_coro::async_accept(acceptor, stream->next_layer());
+      REQUIRE(!accept_error);
+
+      asio_coro::spawn_coroutine(context, [stream]() -> asio_coro::task<void> {
+        const auto handshake_error =
+            co_await asio_coro::async_handshake(*stream, boost::asio::ssl::stream_base::server);
+        REQUIRE(!handshake_error);
+
+        const auto [greeting_error, greeting_size] =
+            co_await asio_coro::async_write(*stream, boost::asio::buffer(std::string_view("!")));
+        REQUIRE(!greeting_error);
+
+        std::array<char, 64> data{};
+        while (true) {
+          const auto [read_error, read_size] = co_await asio_coro::async_read(*stream, boost::asio::buffer(data));
+          if (read_error) {
+            break;
+          }
+
+          const auto [write_error, write_size] =
+              co_await asio_coro::async_write(*stream, boost::asio::buffer(data.data(), read_size));
+          REQUIRE(!write_error);
+        }
+
+        co_await asio_coro::async_shutdown(*stream);
+      });
+    }
+  });
+}
+
+/// Reads the byte the server sends after the handshake, which also processes the session tickets sent before it.
+asio_coro::task<void> read_greeting(ssl_socket &stream) {
+  char greeting;
+  const auto [error, size] =
+      co_await asio_coro::async_read(stream, boost::asio::buffer(&greeting, 1), boost::asio::transfer_all());
+  REQUIRE(!error);
+  REQUIRE(greeting == '!');
+}
+} // namespace
+
+TEST_CASE("async_handshake/async_shutdown secure a connection read from and written to with async_read/async_write") {
+  boost::asio::io_context context;
+  boost::asio::ssl::context server_context(boost::asio::ssl::context::tls_server);
+  boost::asio::ssl::context client_context(boost::asio::ssl::context::tls_client);
+  use_self_signed_certificate(server_context, client_context);
+
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  start_server(context, acceptor, server_context, 1);
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    ssl_socket stream(context, client_context);
+    const auto connect_error = co_await asio_coro::async_connect(stream.next_layer(), acceptor.local_endpoint());
+    REQUIRE(!connect_error);
+
+    const auto handshake_error = co_await asio_coro::async_handshake(stream, boost::asio::ssl::stream_base::client);
+    REQUIRE(!handshake_error);
+    REQUIRE(!asio_coro::session_reused(stream));
+
+    co_await read_greeting(stream);
+
+    const auto [write_error, write_size] =
+        co_await asio_coro::async_write(stream, boost::asio::buffer(std::string_view("secret")));
+    REQUIRE(!write_error);
+    REQUIRE(write_size == 6);
+
+    std::array<char, 6> echo{};
+    const auto [read_error, read_size] =
+        co_await asio_coro::async_read(stream, boost::asio::buffer(echo), boost::asio::transfer_all());
+    REQUIRE(!read_error);
+    REQUIRE(std::string_view(echo.data(), echo.size()) == "secret");
+
+    const auto shutdown_error = co_await asio_coro::async_shutdown(stream);
+    REQUIRE(!shutdown_error);
+  });
+
+  context.run();
+}
+
+TEST_CASE("async_handshake fails if the certificate of the server isn't trusted") {
+  boost::asio::io_context context;
+  boost::asio::ssl::context server_context(boost::asio::ssl::context::tls_server);
+  boost::asio::ssl::context client_context(boost::asio::ssl::context::tls_client);
+  boost::asio::ssl::context other_context(boost::asio::ssl::context::tls_client);
+  use_self_signed_certificate(server_context, other_context);
+  client_context.set_verify_mode(boost::asio::ssl::verify_peer);
+
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    ssl_socket stream(context, server_context);
+    const auto accept_error = co_await asio_coro::async_accept(acceptor, stream.next_layer());
+    REQUIRE(!accept_error);
+
+    const auto handshake_error = co_await asio_coro::async_handshake(stream, boost::asio::ssl::stream_base::server);
+    REQUIRE(handshake_error);
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    ssl_socket stream(context, client_context);
+    const auto connect_error = co_await asio_coro::async_connect(stream.next_layer(), acceptor.local_endpoint());
+    REQUIRE(!connect_error);
+
+    const auto handshake_error = co_await asio_coro::async_handshake(stream, boost::asio::ssl::stream_base::client);
+    REQUIRE(handshake_error);
+  });
+
+  context.run();
+}
+
+TEST_CASE("tls_session_cache resumes the sessions of reconnecting clients") {
+  boost::asio::io_context context;
+  boost::asio::ssl::context server_context(boost::asio::ssl::context::tls_server);
+  boost::asio::ssl::context client_context(boost::asio::ssl::context::tls_client);
+  use_self_signed_certificate(server_context, client_context);
+
+  asio_coro::tls_session_cache cache;
+  asio_coro::tls_session_cache::attach(client_context);
+
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  start_server(context, acceptor, server_context, 3);
+
+  std::array<bool, 3> reused{};
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    for (auto &item : reused) {
+      ssl_socket stream(context, client_context);
+      const auto connect_error = co_await asio_coro::async_connect(stream.next_layer(), acceptor.local_endpoint());
+      REQUIRE(!connect_error);
+
+      const auto handshake_error = co_await asio_coro::async_handshake(stream, cache, "localhost:443");
+      REQUIRE(!handshake_error);
+      item = asio_coro::session_reused(stream);
+
+      co_await read_greeting(stream);
+      co_await asio_coro::async_shutdown(stream);
+    }
+  });
+
+  context.run();
+
+  REQUIRE(reused == std::array<bool, 3>{false, true, true});
+  REQUIRE(cache.size() == 1);
+  REQUIRE(cache.misses() == 1);
+  REQUIRE(cache.hits() == 2);
+
+  cache.erase("localhost:443");
+  REQUIRE(cache.size() == 0);
+}
+
+TEST_CASE("tls_session_cache hands a TLS 1.3 session to one of the concurrent connections only") {
+  boost::asio::io_context context;
+  boost::asio::ssl::context server_context(boost::asio::ssl::context::tls_server);
+  boost::asio::ssl::context client_context(boost::asio::ssl::context::tls_client);
+  use_self_signed_certificate(server_context, client_context);
+
+  asio_coro::tls_session_cache cache;
+  asio_coro::tls_session_cache::attach(client_context);
+
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  start_server(context, acceptor, server_context, 3);
+
+  const auto connect = [&](bool &reused) -> asio_coro::task<void> {
+    ssl_socket stream(context, client_context);
+    const auto connect_error = co_await asio_coro::async_connect(stream.next_layer(), acceptor.local_endpoint());
+    REQUIRE(!connect_error);
+
+    const auto handshake_error = co_await asio_coro::async_handshake(stream, cache, "localhost:443");
+    REQUIRE(!handshake_error);
+    reused = asio_coro::session_reused(stream);
+
+    co_await read_greeting(stream);
+    co_await asio_coro::async_shutdown(stream);
+  };
+
+  std::array<bool, 3> reused{};
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    co_await connect(reused[0]);
+    asio_coro::spawn_coroutine(context, [&]() { return connect(reused[1]); });
+    asio_coro::spawn_coroutine(context, [&]() { return connect(reused[2]); });
+  });
+
+  context.run();
+
+  REQUIRE(!reused[0]);
+  REQUIRE(reused[1] != reused[2]);
+  REQUIRE(cache.misses() == 2);
+  REQUIRE(cache.hits() == 1);
+}
+
+TEST_CASE("tls_session_cache drops the least recently stored sessions once a shard is full") {
+  boost::asio::io_context context;
+  boost::asio::ssl::context server_context(boost::asio::ssl::context::tls_server);
+  boost::asio::ssl::context client_context(boost::asio::ssl::context::tls_client);
+  use_self_signed_certificate(server_context, client_context);
+
+  asio_coro::tls_session_cache cache(1);
+  asio_coro::tls_session_cache::attach(client_context);
+
+  constexpr std::size_t count = asio_coro::tls_session_cache::shards_count * 4;
+  boost::asio::ip::tcp::acceptor acceptor(context, {boost::asio::ip::address_v4::loopback(), 0});
+  start_server(context, acceptor, server_context, count);
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    for (std::size_t i = 0; i != count; ++i) {
+      ssl_socket stream(context, client_context);
+      const auto connect_error = co_await asio_coro::async_connect(stream.next_layer(), acceptor.local_endpoint());
+      REQUIRE(!connect_error);
+
+      const auto handshake_error = co_await asio_coro::async_handshake(stream, cache, std::to_string(i));
+      REQUIRE(!handshake_error);
+
+      co_await read_greeting(stream);
+      co_await asio_coro::async_shutdown(stream);
+    }
+  });
+
+  context.run();
+
+  REQUIRE(cache.size() <= asio_coro::tls_session_cache::shards_count);
+  REQUIRE(cache.size() > 0);
+  REQUIRE(cache.misses() == count);
+
+  cache.clear();
+  REQUIRE(cache.size() == 0);
+}
@@ -0,0 +1,136 @@
+#include "asio_coro/task.hpp"
+#include "asio_coro/timer_wheel.hpp"
+
+#include "catch2/catch.hpp"
+
+#include <boost/asio/io_context.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+TEST_CASE("timer_wheel::sleep_for resumes the coroutine not earlier than the specified duration") {
+  boost::asio::io_context context;
+  asio_coro::timer_wheel wheel(context, std::chrono::milliseconds(10));
+
+  boost::system::error_code sleep_error;
+  std::chrono::steady_clock::duration slept_for;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto started_at = std::chrono::steady_clock::now();
+    sleep_error = co_await wheel.sleep_for(std::chrono::milliseconds(100));
+    slept_for = std::chrono::steady_clock::now() - started_at;
+  });
+
+  context.run();
+
+  REQUIRE(!sleep_error);
+  REQUIRE(slept_for >= std::chrono::milliseconds(100));
+  REQUIRE(slept_for < std::chrono::seconds(1));
+}
+
+TEST_CASE("timer_wheel doesn't resume the coroutine early if the timeout exceeds the range of the wheel") {
+  boost::asio::io_context context;
+  // The wheel spans 2^26 ticks, i.e. about 67ms with the resolution of one nanosecond.
+  asio_coro::timer_wheel wheel(context, std::chrono::nanoseconds(1));
+
+  boost::system::error_code sleep_error;
+  std::chrono::steady_clock::duration slept_for;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    const auto started_at = std::chrono::steady_clock::now();
+    sleep_error = co_await wheel.sleep_for(std::chrono::milliseconds(150));
+    slept_for = std::chrono::steady_clock::now() - started_at;
+  });
+
+  context.run();
+
+  REQUIRE(!sleep_error);
+  REQUIRE(slept_for >= std::chrono::milliseconds(150));
+}
+
+TEST_CASE("timer_wheel resumes coroutines in the order of their expiration across the wheel levels") {
+  boost::asio::io_context context;
+  asio_coro::timer_wheel wheel(context, std::chrono::milliseconds(1));
+
+  std::vector<int> expected_order;
+  std::vector<int> order;
+  for (auto i = 0; i != 40; ++i) {
+    // Spread the timeouts over more than one first level revolution to make the wheel cascade.
+    const auto timeout = (i * 37) % 40 * 15;
+    expected_order.push_back(timeout);
+
+    asio_coro::spawn_coroutine(context, [&, timeout]() -> asio_coro::task<void> {
+      const auto error = co_await wheel.sleep_for(std::chrono::milliseconds(timeout));
+      REQUIRE(!error);
+      order.push_back(timeout);
+    });
+  }
+
+  context.run();
+
+  std::sort(expected_order.begin(), expected_order.end());
+  REQUIRE(order == expected_order);
+}
+
+TEST_CASE("timer_wheel::idle_timer resumes the coroutine once it hasn't been touched for the timeout") {
+  boost::asio::io_context context;
+  asio_coro::timer_wheel wheel(context, std::chrono::milliseconds(10));
+  asio_coro::timer_wheel::idle_timer idle_timer(wheel, std::chrono::milliseconds(100));
+
+  const auto started_at = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::time_point last_touched_at;
+  std::chrono::steady_clock::time_point expired_at;
+
+  auto strand = boost::asio::make_strand(context);
+  asio_coro::spawn_coroutine(strand, [&]() -> asio_coro::task<void> {
+    for (auto i = 0; i != 10; ++i) {
+      co_await wheel.sleep_for(std::chrono::milliseconds(30));
+      idle_timer.touch();
+      last_touched_at = std::chrono::steady_clock::now();
+    }
+  });
+
+  asio_coro::spawn_coroutine(strand, [&]() -> asio_coro::task<void> {
+    const auto error = co_await idle_timer.async_wait();
+    REQUIRE(!error);
+    expired_at = std::chrono::steady_clock::now();
+  });
+
+  context.run();
+
+  REQUIRE(expired_at - started_at >= std::chrono::milliseconds(300));
+  REQUIRE(expired_at - last_touched_at >= std::chrono::milliseconds(90));
+}
+
+TEST_CASE("timer_wheel::idle_timer::cancel and timer_wheel::stop resume waiters with operation_aborted error") {
+  boost::asio::io_context context;
+  asio_coro::timer_wheel wheel(context, std::chrono::milliseconds(10));
+  asio_coro::timer_wheel::idle_timer idle_timer(wheel, std::chrono::seconds(10));
+
+  boost::system::error_code idle_error;
+  boost::system::error_code sleep_error;
+  boost::system::error_code stopped_sleep_error;
+
+  auto strand = boost::asio::make_strand(context);
+  asio_coro::spawn_coroutine(strand, [&]() -> asio_coro::task<void> { idle_error = co_await idle_timer.async_wait(); });
+
+  asio_coro::spawn_coroutine(strand, [&]() -> asio_coro::task<void> {
+    co_await wheel.sleep_for(std::chrono::milliseconds(50));
+    idle_timer.cancel();
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    sleep_error = co_await wheel.sleep_for(std::chrono::seconds(10));
+    stopped_sleep_error = co_await wheel.sleep_for(std::chrono::seconds(10));
+  });
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    co_await wheel.sleep_for(std::chrono::milliseconds(100));
+    wheel.stop();
+  });
+
+  context.run();
+
+  REQUIRE(idle_error == boost::asio::error::operation_aborted);
+  REQUIRE(sleep_error == boost::asio::error::operation_aborted);
+  REQUIRE(stopped_sleep_error == boost::asio::error::operation_aborted);
+}
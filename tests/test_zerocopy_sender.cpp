@@ -0,0 +1,146 @@
+#include "asio_coro/async_read.hpp"
+#include "asio_coro/buffer_pool.hpp"
+#include "asio_coro/task.hpp"
+#include "asio_coro/zerocopy_sender.hpp"
+
+#include "catch2/catch.hpp"
+#include "socket_pair.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+namespace {
+/// Reads everything the peer sends until it shuts the connection down.
+asio_coro::task<void> read_all(boost::asio::ip::tcp::socket &socket, std::string &received) {
+  std::string buffer(65536, '\0');
+  while (true) {
+    const auto [error, size] = co_await asio_coro::async_read(socket, boost::asio::buffer(buffer));
+    if (error) {
+      REQUIRE(error == boost::asio::error::eof);
+      co_return;
+    }
+
+    received.append(buffer, 0, size);
+  }
+}
+} // namespace
+
+TEST_CASE("zerocopy_sender sends large payloads with MSG_ZEROCOPY and small ones with a copy") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  asio_coro::zerocopy_sender sender(server, 4096);
+  REQUIRE(sender.threshold() == 4096);
+
+  std::string expected;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    // The payload is modified right after every send completes, which mustn't affect the data received.
+    std::string payload(1 << 20, '\0');
+    for (char symbol = 'a'; symbol != 'e'; ++symbol) {
+      std::fill(payload.begin(), payload.end(), symbol);
+      const auto [error, size] = co_await sender.async_send(boost::asio::buffer(payload));
+      REQUIRE(!error);
+      REQUIRE(size == payload.size());
+      expected += payload;
+    }
+
+    const auto [error, size] = co_await sender.async_send(boost::asio::buffer(std::string_view("small")));
+    REQUIRE(!error);
+    REQUIRE(size == 5);
+    expected += "small";
+
+    const auto flush_error = co_await sender.async_flush();
+    REQUIRE(!flush_error);
+    server.shutdown(boost::asio::ip::tcp::socket::shutdown_send);
+  });
+
+  std::string received;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> { co_await read_all(client, received); });
+
+  context.run();
+
+  REQUIRE(received == expected);
+  // The sends are made with MSG_ZEROCOPY if the kernel supports it, and the loopback interface makes it copy anyway.
+  REQUIRE(sender.copied_sends() <= sender.zerocopy_sends());
+}
+
+TEST_CASE("zerocopy_sender keeps a pooled payload alive until the kernel releases it") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  asio_coro::buffer_pool pool(256 * 1024, 4);
+  asio_coro::zerocopy_sender sender(server);
+
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    for (char symbol = 'a'; symbol != 'e'; ++symbol) {
+      auto payload = pool.acquire();
+      std::fill(payload.data(), payload.data() + payload.size(), symbol);
+      const auto [error, size] = co_await sender.async_send(std::move(payload));
+      REQUIRE(!error);
+      REQUIRE(size == 256 * 1024);
+    }
+
+    const auto flush_error = co_await sender.async_flush();
+    REQUIRE(!flush_error);
+    server.shutdown(boost::asio::ip::tcp::socket::shutdown_send);
+  });
+
+  std::string received;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> { co_await read_all(client, received); });
+
+  context.run();
+
+  REQUIRE(received.size() == 4 * 256 * 1024);
+  for (std::size_t i = 0; i != 4; ++i) {
+    REQUIRE(received.substr(i * 256 * 1024, 256 * 1024) == std::string(256 * 1024, static_cast<char>('a' + i)));
+  }
+}
+
+TEST_CASE("zerocopy_sender doesn't resume the coroutine on the stack of the previous send") {
+  boost::asio::io_context context;
+  boost::asio::ip::tcp::socket server(context);
+  boost::asio::ip::tcp::socket client(context);
+  connect_sockets(context, server, client);
+
+  // Every payload is sent with MSG_ZEROCOPY, and the sends of pooled payloads complete right away unless the socket
+  // buffer is full, which mustn't resume the coroutine on the stack of the previous send, i.e. deeper and deeper.
+  constexpr std::size_t sends_count = 100'000;
+  asio_coro::buffer_pool pool(1, 1024);
+  asio_coro::zerocopy_sender sender(server, 1);
+
+  std::uintptr_t lowest_frame = UINTPTR_MAX;
+  std::uintptr_t highest_frame = 0;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> {
+    for (std::size_t i = 0; i != sends_count; ++i) {
+      auto payload = pool.acquire();
+      payload.data()[0] = 'x';
+      const auto [error, size] = co_await sender.async_send(std::move(payload));
+      REQUIRE(!error);
+      REQUIRE(size == 1);
+
+      const auto frame = reinterpret_cast<std::uintptr_t>(__builtin_frame_address(0));
+      lowest_frame = std::min(lowest_frame, frame);
+      highest_frame = std::max(highest_frame, frame);
+    }
+
+    const auto error = co_await sender.async_flush();
+    REQUIRE(!error);
+    server.shutdown(boost::asio::ip::tcp::socket::shutdown_send);
+  });
+
+  std::string received;
+  asio_coro::spawn_coroutine(context, [&]() -> asio_coro::task<void> { co_await read_all(client, received); });
+
+  context.run();
+
+  REQUIRE(received == std::string(sends_count, 'x'));
+  REQUIRE(highest_frame - lowest_frame < 64 * 1024);
+}